@@ -0,0 +1,204 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * OGL BVH benchmark, on the CPU only: build and query throughput of the
+ * glModel hierarchies on a large model.
+ *
+ *   make bench_bvh                        (a generated 2M triangles terrain)
+ *   ~/bin/ogl_bench_bvh path/to/model     (any model Assimp reads)
+ *
+ * It prints the import time (the triangle hierarchies are built there, one
+ * mesh per thread), the build throughput of the triangle hierarchies on one
+ * thread, the glModel::raycast() throughput and the glBVH::cull() throughput
+ * of a hierarchy over every triangle of the model.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <ogl/ogl.hpp>
+
+//*****************************************************************************/
+// seconds() - elapsed since start
+//*****************************************************************************/
+static double seconds(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+//*****************************************************************************/
+// writeTerrain() - a tiles x tiles grid of meshes of size x size quads each,
+//                  displaced by a few sines, as a Wavefront OBJ
+//*****************************************************************************/
+static void writeTerrain(const std::string & path, int tiles, int size) {
+
+  FILE * file = fopen(path.c_str(), "w");
+
+  if(file == NULL) { fprintf(stderr, "ERROR [bench]: cannot write '%s'\n", path.c_str()); abort(); }
+
+  int offset = 1;
+
+  for(int ty=0; ty<tiles; ++ty) {
+    for(int tx=0; tx<tiles; ++tx) {
+
+      fprintf(file, "o tile_%d_%d\n", tx, ty);
+
+      for(int y=0; y<=size; ++y) {
+        for(int x=0; x<=size; ++x) {
+          float u = (float)(tx * size + x) / size;
+          float v = (float)(ty * size + y) / size;
+          fprintf(file, "v %f %f %f\n", u, 0.2f * sinf(3.1f * u) * cosf(2.3f * v) + 0.05f * sinf(17.0f * u + 11.0f * v), v);
+        }
+      }
+
+      for(int y=0; y<size; ++y) {
+        for(int x=0; x<size; ++x) {
+          int a = offset + y * (size + 1) + x;
+          int b = a + size + 1;
+          fprintf(file, "f %d %d %d\nf %d %d %d\n", a, b, a + 1, a + 1, b, b + 1);
+        }
+      }
+
+      offset += (size + 1) * (size + 1);
+
+    }
+  }
+
+  fclose(file);
+
+}
+
+//*****************************************************************************/
+// main
+//*****************************************************************************/
+int main(int argc, char * const argv[]) {
+
+  std::string path = (argc > 1) ? argv[1] : "/tmp/ogl_bench_bvh.obj";
+
+  if(argc <= 1) writeTerrain(path, 8, 125);
+
+  // --- Import (the hierarchies are built on every core) ---
+
+  auto start = std::chrono::steady_clock::now();
+
+  ogl::glModel model(path, 1.0f);
+
+  double importTime = seconds(start);
+
+  std::size_t triangles = 0;
+
+  for(std::size_t i=0; i<model.size(); ++i) triangles += model[i].getTrianglesCount();
+
+  printf("model   %zu meshes, %zu triangles, imported in %.2f s\n", model.size(), triangles, importTime);
+
+  // --- Build, one thread ---
+
+  start = std::chrono::steady_clock::now();
+
+  for(std::size_t i=0; i<model.size(); ++i) model[i].buildBVH();
+
+  double buildTime = seconds(start);
+
+  printf("build   %8.2f Mtriangles/s (one thread, %.3f s)\n", triangles / buildTime * 1e-6, buildTime);
+
+  // --- Ray casts from around the model towards points inside its bounds ---
+
+  glm::vec3 center, size; float radius;
+
+  model.getBounds(center, size, radius);
+
+  std::mt19937 random(1);
+  std::uniform_real_distribution<float> uniform(-0.5f, 0.5f);
+
+  const int RAYS = 200000;
+
+  std::vector<glm::vec3> origins(RAYS), targets(RAYS);
+
+  for(int i=0; i<RAYS; ++i) {
+    origins[i] = center + glm::normalize(glm::vec3(uniform(random), uniform(random) + 0.6f, uniform(random))) * (2.0f * radius);
+    targets[i] = center + glm::vec3(uniform(random), uniform(random), uniform(random)) * size;
+  }
+
+  int hits = 0;
+
+  start = std::chrono::steady_clock::now();
+
+  for(int i=0; i<RAYS; ++i) hits += model.raycast(origins[i], targets[i] - origins[i]).isHit();
+
+  double raycastTime = seconds(start);
+
+  printf("raycast %8.2f Mrays/s (%d rays, %d hits)\n", RAYS / raycastTime * 1e-6, RAYS, hits);
+
+  // --- Frustum culling of a hierarchy over every triangle ---
+
+  std::vector<ogl::glAABB> boxes;
+
+  boxes.reserve(triangles);
+
+  for(std::size_t i=0; i<model.size(); ++i) {
+
+    const std::vector<ogl::glVertex> & vertices = model[i].getVertices();
+    const GLuint * indices = model[i].getLodIndices(0);
+
+    for(std::size_t t=0; t<model[i].getTrianglesCount(); ++t) {
+      ogl::glAABB box;
+      for(int k=0; k<3; ++k) box.expand(vertices[indices[3*t+k]].Position);
+      boxes.push_back(box);
+    }
+
+  }
+
+  ogl::glBVH bvh;
+
+  start = std::chrono::steady_clock::now();
+
+  bvh.build(boxes);
+
+  printf("build   %8.2f Mboxes/s (one hierarchy over every triangle, %zu nodes)\n", boxes.size() / seconds(start) * 1e-6, bvh.getNodesCount());
+
+  const int CULLS = 2000;
+
+  std::vector<ogl::glFrustum> frustums(CULLS);
+
+  for(int i=0; i<CULLS; ++i) {
+    glm::vec3 eye = origins[i];
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 4.0f / 3.0f, 0.01f, 4.0f * radius);
+    frustums[i].set(projection * glm::lookAt(eye, targets[i], glm::vec3(0.0f, 1.0f, 0.0f)));
+  }
+
+  std::size_t visible = 0;
+
+  start = std::chrono::steady_clock::now();
+
+  for(int i=0; i<CULLS; ++i) bvh.cull(frustums[i], [&](uint32_t, bool) { ++visible; });
+
+  double cullTime = seconds(start);
+
+  printf("cull    %8.0f culls/s (%.1f%% of the triangles visible on average)\n", CULLS / cullTime, 100.0 * visible / ((double) CULLS * boxes.size()));
+
+  return 0;
+
+}
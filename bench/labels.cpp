@@ -0,0 +1,106 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * OGL text benchmark: 10k glPrint2D labels on screen, drawn one string per
+ * draw (the glyph atlas of glFont) and with the text batching of the window
+ * (the glyphs of every label in one draw at the end of the frame).
+ *
+ *   make bench_labels
+ *   ~/bin/ogl_bench_labels [labels] [frames]
+ *
+ * For both it prints the text draws per frame and per label, counted by
+ * glFont::countDraw(), the glyphs per label, that is the draws per label of
+ * the old one texture per glyph path, and the CPU+GPU time of a frame.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <ogl/ogl.hpp>
+
+//*****************************************************************************/
+// main
+//*****************************************************************************/
+int main(int argc, char * const argv[]) {
+
+  int count  = (argc > 1) ? atoi(argv[1]) : 10000;
+  int frames = (argc > 2) ? atoi(argv[2]) : 50;
+
+  ogl::glWindow window;
+  window.createOffscreen(1024, 768);
+
+  // a grid of small labels over the whole window
+  int columns = 100;
+  int rows    = (count + columns - 1) / columns;
+
+  std::vector<ogl::glPrint2D> labels;
+
+  labels.reserve(count);
+
+  for(int i=0; i<count; ++i) {
+    float x = 1024.0f * (i % columns) / columns;
+    float y = 768.0f  * (i / columns) / rows;
+    labels.emplace_back("label " + std::to_string(i), x, y, glm::vec3(1.0f), 0.15f);
+  }
+
+  ogl::glFont & font = ogl::glFont::instance();
+
+  for(int isBatching=0; isBatching<=1; ++isBatching) {
+
+    window.setTextBatching(isBatching != 0);
+
+    // the first frame uploads the atlas and compiles the text programs
+    window.renderBegin();
+    for(ogl::glPrint2D & label : labels) label.render(window.getCamera());
+    window.renderEnd();
+
+    glFinish();
+
+    uint32_t draws  = font.getDrawCallsCount();
+    uint32_t glyphs = font.getDrawnGlyphsCount();
+
+    auto start = std::chrono::steady_clock::now();
+
+    for(int frame=0; frame<frames; ++frame) {
+      window.renderBegin();
+      for(ogl::glPrint2D & label : labels) label.render(window.getCamera());
+      window.renderEnd();
+    }
+
+    glFinish();
+
+    double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / frames;
+
+    double drawsPerFrame  = (double) (font.getDrawCallsCount() - draws) / frames;
+    double glyphsPerFrame = (double) (font.getDrawnGlyphsCount() - glyphs) / frames;
+
+    printf("%-10s %d labels  %8.1f draws/frame  %6.3f draws/label  %5.2f glyphs/label  %8.2f ms/frame\n",
+           isBatching ? "batched" : "per string", count, drawsPerFrame, drawsPerFrame / count, glyphsPerFrame / count, elapsed);
+
+  }
+
+  return 0;
+
+}
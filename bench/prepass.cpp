@@ -0,0 +1,121 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * OGL depth pre-pass benchmark: a stack of lit quads covering the whole
+ * view, one behind the other, so that every pixel is shaded once per layer
+ * without the pre-pass. Optionally a model in front of them (model.fs, the
+ * most expensive fragment shader of the library).
+ *
+ *   make bench_prepass
+ *   ~/bin/ogl_bench_prepass [layers] [path/to/model]
+ *
+ * The layers are drawn in submission order (back to front, the worst
+ * overdraw) and sorted (front to back), each with the pre-pass off and on.
+ * For every run it prints the GPU time of the depth and color passes read
+ * from the glRenderQueue timer queries, and the CPU+GPU time of a frame.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include <ogl/ogl.hpp>
+
+//*****************************************************************************/
+// main
+//*****************************************************************************/
+int main(int argc, char * const argv[]) {
+
+  int layers = (argc > 1) ? atoi(argv[1]) : 24;
+
+  const int FRAMES = 100;
+
+  ogl::glWindow window;
+  window.createOffscreen(1024, 768);
+
+  window.getCamera().setPosition(0, 0, 10);
+  window.getCamera().lookAt(0, 0, 0);
+
+  // back to front: the farthest layer is submitted first
+  std::vector<std::unique_ptr<ogl::glQuad>> quads;
+
+  for(int i=0; i<layers; ++i) {
+    quads.emplace_back(new ogl::glQuad(glm::vec2(40.0f), glm::vec3(0.2f + 0.8f * i / layers, 0.5f, 0.8f), ogl::glShader::STYLE::SOLID));
+    quads.back()->translate(glm::vec3(0.0f, 0.0f, -0.25f * (layers - i)));
+    quads.back()->setLight(glm::vec3(1.0f), glm::vec3(-1.0f));
+  }
+
+  std::unique_ptr<ogl::glModel> model;
+
+  if(argc > 2) {
+    model.reset(new ogl::glModel(argv[2], 3.0f));
+    model->translate(glm::vec3(0.0f, 0.0f, 1.0f));
+    model->setLight(glm::vec3(1.0f), glm::vec3(-1.0f));
+  }
+
+  ogl::glRenderQueue queue;
+
+  queue.setTiming(true);
+
+  printf("%d layers%s, %d x %d\n", layers, model ? " and a model" : "", window.getCamera().getWidth(), window.getCamera().getHeight());
+
+  for(int sorted=0; sorted<2; ++sorted) {
+    for(int prePass=0; prePass<2; ++prePass) {
+
+      queue.setSorted(sorted != 0);
+      window.setDepthPrePass(prePass != 0);
+
+      auto start = std::chrono::steady_clock::now();
+
+      for(int frame=0; frame<FRAMES; ++frame) {
+
+        window.renderBegin();
+
+        for(std::size_t i=0; i<quads.size(); ++i) queue.submit(*quads[i]);
+
+        if(model) queue.submit(*model);
+
+        queue.render(window.getCamera());
+
+        window.renderEnd();
+
+      }
+
+      glFinish();
+
+      double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / FRAMES;
+
+      // the timer queries are a few frames old: the last frames of this run
+      const ogl::glRenderQueue::Stats_t & stats = queue.getStats();
+
+      printf("%-9s pre-pass %-3s  depth pass %7.3f ms  color pass %7.3f ms  GPU %7.3f ms  frame %7.2f ms\n",
+             sorted ? "sorted" : "submitted", prePass ? "on" : "off", stats.depthPassTime, stats.colorPassTime,
+             stats.depthPassTime + stats.colorPassTime, elapsed);
+
+    }
+  }
+
+  return 0;
+
+}
@@ -0,0 +1,125 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * OGL render queue benchmark: a few thousand primitives with different
+ * programs and meshes submitted in an interleaved order, drawn through a
+ * glRenderQueue sorted and in submission order.
+ *
+ *   make bench_queue
+ *
+ * For both orders it prints the CPU+GPU time of a frame, the program and
+ * vertex array changes between consecutive objects and the state calls the
+ * glStateCache sent to the driver.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <functional>
+
+#include <ogl/ogl.hpp>
+
+//*****************************************************************************/
+// run() - average over frames of one queue order
+//*****************************************************************************/
+template <class Submit>
+void run(ogl::glWindow & window, ogl::glRenderQueue & queue, bool isSorted, int frames, Submit submit) {
+
+  queue.setSorted(isSorted);
+
+  // warm up: upload, compile and let the queue learn the objects
+  for(int i=0; i<3; ++i) {
+    window.renderBegin();
+    submit();
+    queue.render(window.getCamera());
+    window.renderEnd();
+  }
+
+  glFinish();
+
+  auto start = std::chrono::steady_clock::now();
+
+  for(int i=0; i<frames; ++i) {
+    window.renderBegin();
+    submit();
+    queue.render(window.getCamera());
+    window.renderEnd();
+  }
+
+  glFinish();
+
+  double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / frames;
+
+  const ogl::glRenderQueue::Stats_t & stats = queue.getStats();
+
+  printf("%-10s %8.2f ms/frame  objects %u  program changes %5u  vao changes %5u  state calls issued %6llu skipped %6llu\n",
+         isSorted ? "sorted" : "submitted", elapsed, stats.objects, stats.programChanges, stats.vaoChanges,
+         (unsigned long long) stats.issued, (unsigned long long) stats.skipped);
+
+}
+
+//*****************************************************************************/
+// main
+//*****************************************************************************/
+int main(int argc, char * const argv[]) {
+
+  int count  = (argc > 1) ? atoi(argv[1]) : 4000;
+  int frames = (argc > 2) ? atoi(argv[2]) : 50;
+
+  ogl::glWindow window;
+  window.createOffscreen(1024, 768);
+
+  window.getCamera().setPosition(0, 0, 40);
+  window.getCamera().lookAt(0, 0, 0);
+
+  ogl::glRenderQueue queue;
+
+  // four kinds of object, two programs and four meshes, interleaved
+  std::vector<std::unique_ptr<ogl::glObject>> objects;
+
+  std::vector<std::function<void()>> submits;
+
+  auto add = [&](auto * object, int i) {
+    object->translate(glm::vec3((i % 64) - 32.0f, ((i / 64) % 64) - 32.0f, -(float)(i / 4096)));
+    objects.emplace_back(object);
+    submits.push_back([&queue, object]() { queue.submit(*object); });
+  };
+
+  for(int i=0; i<count; ++i) {
+    switch(i % 4) {
+      case 0: add(new ogl::glSphere(0.4f, 16, 16, ogl::glShader::STYLE::SOLID), i);        break;
+      case 1: add(new ogl::glCuboid(glm::vec3(0.6f), ogl::glShader::STYLE::WIREFRAME), i); break;
+      case 2: add(new ogl::glSphere(0.4f, 8, 8, ogl::glShader::STYLE::WIREFRAME), i);      break;
+      case 3: add(new ogl::glCuboid(glm::vec3(0.6f), ogl::glShader::STYLE::SOLID), i);     break;
+    }
+  }
+
+  auto submit = [&]() { for(auto & s : submits) s(); };
+
+  run(window, queue, false, frames, submit);
+  run(window, queue, true,  frames, submit);
+
+  return 0;
+
+}
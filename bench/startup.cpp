@@ -0,0 +1,96 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * OGL startup benchmark: the src/main.cpp scene in an offscreen window, timed
+ * from the start of the process to the end of its first frame (programs
+ * compiled or restored from the binary cache, model imported, first draw).
+ *
+ * Run it through the Makefile, which clears the cache and runs it twice
+ * under Mesa llvmpipe:
+ *
+ *   make bench_startup
+ *
+ * The first (cold) run compiles every program and fills OGL_CACHE_DIR, the
+ * second (warm) run restores them with glProgramBinary.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <chrono>
+
+#include <ogl/ogl.hpp>
+
+//*****************************************************************************/
+// main
+//*****************************************************************************/
+int main(int argc, char * const argv[]) {
+
+  const char * label = (argc > 1) ? argv[1] : "run";
+
+  auto start = std::chrono::steady_clock::now();
+
+  ogl::glWindow window;
+  window.createOffscreen(1024, 768);
+
+  window.getCamera().setPosition(3, 1.5f, 0);
+  window.getCamera().setYaw(180);
+  window.getCamera().setPitch(-20);
+
+  // --- Scene objects (as in src/main.cpp) ---
+
+  ogl::glAxes axes;
+  ogl::glGrid grid(10, 10, 0.5f, ogl::glColors::cyan);
+
+  ogl::glCuboid cuboid(glm::vec3(0.5f), ogl::glShader::STYLE::SOLID, ogl::glColors::white);
+  cuboid.setLight(glm::vec3(1.0f), glm::vec3(-1.0f));
+
+  ogl::glModel model("/usr/local/include/ogl/data/model/Trex/Trex.fbx");
+  model.setLight(glm::vec3(1.0f), glm::vec3(-1.0f));
+
+  ogl::glPrint2D fpsText(10, 10, ogl::glColors::white, 0.5f);
+
+  ogl::glReferenceAxes referenceAxes;
+  referenceAxes.setLineWidth(2);
+
+  // --- First frame ---
+
+  window.renderBegin();
+
+  axes.render(window.getCamera());
+  grid.render(window.getCamera());
+  model.render(window.getCamera());
+  cuboid.render(window.getCamera());
+  fpsText.render(window.getCamera(), "FPS: 0");
+  referenceAxes.render(window.getCamera());
+
+  window.renderEnd();
+
+  glFinish();
+
+  double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  printf("%-5s startup %8.1f ms  programs compiled %u, restored from the cache %u\n", label, elapsed,
+         ogl::glPrograms::getCompiledCount(), ogl::glPrograms::getCachedCount());
+
+  return 0;
+
+}
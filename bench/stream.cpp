@@ -0,0 +1,116 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * OGL streaming benchmark: glLines and glPoints whose vertices change every
+ * frame, uploaded through the shared glStreamBuffer.
+ *
+ *   make bench_stream
+ *   ~/bin/ogl_bench_stream [objects] [vertices per object] [frames]
+ *
+ * It prints the bytes streamed per frame, the upload rate in MB/s over the
+ * whole run (CPU+GPU time of the frames), whether the buffer is persistent
+ * mapped (ARB_buffer_storage) or orphaned, and the times the CPU waited for
+ * the GPU to free a region.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include <ogl/ogl.hpp>
+
+//*****************************************************************************/
+// main
+//*****************************************************************************/
+int main(int argc, char * const argv[]) {
+
+  int objects  = (argc > 1) ? atoi(argv[1]) : 200;
+  int vertices = (argc > 2) ? atoi(argv[2]) : 2000;
+  int frames   = (argc > 3) ? atoi(argv[3]) : 200;
+
+  ogl::glWindow window;
+  window.createOffscreen(1024, 768);
+
+  window.getCamera().setPosition(0, 0, 30);
+  window.getCamera().lookAt(0, 0, 0);
+
+  // half lines, half points
+  std::vector<std::unique_ptr<ogl::glLines>>  lines;
+  std::vector<std::unique_ptr<ogl::glPoints>> points;
+
+  std::vector<glm::vec3> positions(vertices);
+
+  for(int i=0; i<objects; ++i) {
+    if(i % 2 == 0) lines.emplace_back(new ogl::glLines(positions, glm::vec4(1.0f)));
+    else           points.emplace_back(new ogl::glPoints(positions, glm::vec4(1.0f), 2.0f));
+  }
+
+  ogl::glStreamBuffer & stream = ogl::glStreamBuffer::instance();
+
+  double bytes = 0.0;
+
+  std::chrono::steady_clock::time_point start;
+
+  // the first frames upload the objects and grow the buffer
+  const int WARMUP = 5;
+
+  for(int frame=0; frame<WARMUP+frames; ++frame) {
+
+    if(frame == WARMUP) { glFinish(); start = std::chrono::steady_clock::now(); }
+
+    window.renderBegin();
+
+    for(int i=0; i<objects; ++i) {
+
+      // a spiral turning with the frame, different for every object
+      for(int k=0; k<vertices; ++k) {
+        float t = 0.01f * k + 0.05f * frame + (float) i;
+        positions[k] = glm::vec3((5.0f + 0.002f * k) * cosf(t), (5.0f + 0.002f * k) * sinf(t), 0.01f * i);
+      }
+
+      if(i % 2 == 0) { lines[i / 2]->update(positions);  lines[i / 2]->render(window.getCamera()); }
+      else           { points[i / 2]->update(positions); points[i / 2]->render(window.getCamera()); }
+
+    }
+
+    window.renderEnd();
+
+    if(frame >= WARMUP) bytes += (double) stream.getFrameBytes();
+
+  }
+
+  glFinish();
+
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  printf("%d objects x %d vertices, %d frames, %s, buffer %.1f MB\n", objects, vertices, frames,
+         stream.isPersistentMapped() ? "persistent mapped" : "orphaned", stream.getSize() / 1048576.0);
+
+  printf("%.2f MB/frame  %.1f MB/s  %.2f ms/frame  stalls %u\n", bytes / frames / 1048576.0, bytes / elapsed / 1048576.0,
+         1000.0 * elapsed / frames, stream.getStallsCount());
+
+  return 0;
+
+}
@@ -17,6 +17,7 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+
 #ifndef _H_OGL_FONT_H_
 #define _H_OGL_FONT_H_
 
@@ -26,12 +27,16 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
 
-#include <map>
 #include <string>
 #include <vector>
 #include <iostream>
 
+#include <sys/stat.h>
+
 #include <freetype2/ft2build.h>
 #include FT_FREETYPE_H
 
@@ -43,33 +48,124 @@ namespace ogl {
   //****************************************************************************/
   // Class glFont
   //****************************************************************************/
-  // Shared glyph atlas used by both glPrint2D and glPrint3D. The ASCII glyph
-  // textures are loaded from FreeType exactly once (program-lifetime) instead
-  // of per text instance, which used to upload 128 textures for every label.
+  // Shared glyph atlas used by both glPrint2D and glPrint3D. The glyphs are
+  // rasterized by FreeType once (program-lifetime) and packed in a single
+  // ATLAS_SIZE x ATLAS_SIZE red texture, so a string is drawn with one
+  // texture bind and one draw call whatever its length.
+  //
+  // The text is UTF-8. The ASCII glyphs are loaded with the atlas and looked
+  // up in a flat table; any other code point is rasterized the first time it
+  // is drawn and kept in an open-addressing hash table (linear probing), so a
+  // glyph costs the same constant lookup, without allocations, whatever its
+  // code point. A code point the font lacks is remembered as missing and
+  // skipped.
+  //
+  // The glyphs are packed in shelves: rows as tall as the first glyph placed
+  // in them, filled left to right, a glyph going in the shelf that wastes the
+  // least height. Each glyph keeps a PADDING pixels empty border so that the
+  // linear filtering never reads its neighbours. When the atlas is full the
+  // shelf of non-ASCII glyphs least recently drawn is emptied and reused; the
+  // shelves holding ASCII glyphs and those drawn in the current frame (see
+  // glWindow::getFramesCount(), the quads may still be waiting in the
+  // glTextBatch) are never evicted.
+  //
+  // In SDF mode (setMode() before the first load) the atlas holds, instead of
+  // the coverage, the signed distance to the glyph outline, SDF_SPREAD pixels
+  // each way mapped to 0..1 with the outline at 0.5, computed once with an
+  // exact Euclidean distance transform of the rasterized glyph. The
+  // OGL_SDF_TEXT variant of the text shader (getDefines()) thresholds it over
+  // one screen pixel, so the same 48 px atlas stays sharp when the text is
+  // drawn much larger or smaller.
+  //
+  // When ogl::cache is enabled the ASCII atlas (glyph metrics and pixels) is
+  // saved and the next run with the same font file, size and mode skips
+  // FreeType until a non-ASCII glyph is needed.
   //
   // It is a process-wide singleton: call glFont::instance().load() with an
   // active GL context (the text objects do this on their first setInGpu), then
-  // look glyphs up through get(). The atlas is shared, so individual text
-  // objects must not delete its textures.
+  // look glyphs up through get() or build the quads of a string with
+  // layout(). The atlas is shared, so individual text objects must not delete
+  // its texture.
   //****************************************************************************/
   class glFont {
 
   public:
 
+    static constexpr int ATLAS_SIZE = 1024;
+    static constexpr int PADDING    = 1;
+
+    // distance in atlas pixels mapped to the 0..1 range of an SDF atlas
+    static constexpr int SDF_SPREAD = 6;
+
+    enum MODE { BITMAP, SDF };
+
     struct Character_t {
-      unsigned int TextureID; // ID handle of the glyph texture
       glm::ivec2   Size;      // Size of glyph
       glm::ivec2   Bearing;   // Offset from baseline to left/top of glyph
       unsigned int Advance;   // Horizontal offset to advance to next glyph
+      glm::vec2    uvMin;     // atlas coordinates of the top-left corner
+      glm::vec2    uvMax;     // atlas coordinates of the bottom-right corner
     };
 
   private:
 
-    std::map<GLchar, Character_t> characters;
+    // a row of the atlas
+    struct Shelf_t {
+      int y;
+      int height;
+      int x;              // first free column
+      int isPinned;       // holds ASCII glyphs, never evicted
+      uint64_t lastUsed;  // frame its glyphs were last drawn in
+    };
+
+    // a glyph of the tables
+    struct Glyph_t {
+      uint32_t code;
+      int32_t shelf;      // -1 when the glyph has no pixels (or is missing)
+      int32_t isMissing;
+      Character_t character;
+    };
+
+    static constexpr uint32_t EMPTY = 0xFFFFFFFF;
+
+    // ASCII glyphs, indexed by their code
+    Glyph_t ascii[128];
+
+    // the other code points: open addressing, linear probing, power of two
+    std::vector<Glyph_t> table;
+    uint32_t tableShift = 0;
+    uint32_t tableCount = 0;
+
+    std::vector<Shelf_t> shelves;
+
+    GLuint texture = 0;
+
+    int mode = BITMAP;
 
     bool loaded = false;
 
-    glFont() { }
+    // FreeType face for the glyphs rasterized on demand, opened on the first
+    std::string facePath;
+    unsigned int facePixelSize = 48;
+    FT_Library library = nullptr;
+    FT_Face face = nullptr;
+
+    // scratch image of the glyph being placed
+    std::vector<unsigned char> image;
+
+    uint32_t evictedCounter = 0;
+
+    // text draws and glyphs drawn by them
+    uint32_t drawCallsCounter   = 0;
+    uint32_t drawnGlyphsCounter = 0;
+
+    glFont() {
+
+      for(uint32_t c=0; c<128; ++c) ascii[c].code = EMPTY;
+
+      glWindow::cleanShared = []() { instance().cleanInGpu(); };
+
+    }
 
   public:
 
@@ -81,17 +177,190 @@ namespace ogl {
       return instance;
     }
 
+    //****************************************************************************/
+    // ~glFont() - the texture belongs to the contexts, gone by now
+    //****************************************************************************/
+    ~glFont() {
+      if(face != nullptr) FT_Done_Face(face);
+      if(library != nullptr) FT_Done_FreeType(library);
+    }
+
+    glFont(const glFont &) = delete;
+    glFont & operator = (const glFont &) = delete;
+
     //****************************************************************************/
     // isLoaded()
     //****************************************************************************/
     inline bool isLoaded() const { return loaded; }
 
     //****************************************************************************/
-    // get() - glyph for a character, or nullptr if it was not loaded
+    // getTexture() - the atlas texture
+    //****************************************************************************/
+    inline GLuint getTexture() const { return texture; }
+
+    //****************************************************************************/
+    // setMode() - BITMAP or SDF atlas, before the atlas is loaded
+    //****************************************************************************/
+    void setMode(int _mode) {
+
+      if(loaded && _mode != mode) {
+        fprintf(stderr, "WARNING [glFont]: the atlas is already loaded, mode not changed\n");
+        return;
+      }
+
+      mode = _mode;
+
+    }
+
+    inline int getMode() const { return mode; }
+
+    //****************************************************************************/
+    // getDefines() - defines of the text shader that matches the atlas
+    //****************************************************************************/
+    inline const char * getDefines() const { return (mode == SDF) ? "#define OGL_SDF_TEXT" : ""; }
+
+    //****************************************************************************/
+    // getGlyphsCount() - non-ASCII glyphs in the table (missing ones included)
+    //****************************************************************************/
+    inline uint32_t getGlyphsCount() const { return tableCount; }
+
+    //****************************************************************************/
+    // getEvictedCount() - shelves emptied to make room since startup
+    //****************************************************************************/
+    inline uint32_t getEvictedCount() const { return evictedCounter; }
+
+    //****************************************************************************/
+    // countDraw() - a draw of 'vertices' text vertices (6 per glyph) was issued
+    //****************************************************************************/
+    inline void countDraw(std::size_t vertices) {
+      ++drawCallsCounter;
+      drawnGlyphsCounter += (uint32_t)(vertices / 6);
+    }
+
+    //****************************************************************************/
+    // getDrawCallsCount() - text draws of glPrint2D, glPrint3D and glTextBatch
+    //                       since startup
+    //****************************************************************************/
+    inline uint32_t getDrawCallsCount() const { return drawCallsCounter; }
+
+    //****************************************************************************/
+    // getDrawnGlyphsCount() - glyphs drawn by those draws since startup
+    //****************************************************************************/
+    inline uint32_t getDrawnGlyphsCount() const { return drawnGlyphsCounter; }
+
+    //****************************************************************************/
+    // get() - glyph of a code point, rasterized on the first request; nullptr
+    //         if the font lacks it or the atlas has no room left this frame
     //****************************************************************************/
-    const Character_t * get(GLchar c) const {
-      auto it = characters.find(c);
-      return (it == characters.end()) ? nullptr : &it->second;
+    const Character_t * get(uint32_t code) {
+
+      if(!loaded) return nullptr;
+
+      Glyph_t * glyph = (code < 128) ? &ascii[code] : find(code);
+
+      if(glyph == nullptr) glyph = add(code);
+
+      if(glyph == nullptr || glyph->code == EMPTY || glyph->isMissing) return nullptr;
+
+      if(glyph->shelf >= 0) shelves[glyph->shelf].lastUsed = glWindow::getFramesCount();
+
+      return &glyph->character;
+
+    }
+
+    //****************************************************************************/
+    // layout() - append the quads of a UTF-8 text, 6 vertices (x, y, u, v) per
+    //            glyph, starting at (x, y) on the baseline. A '\n' goes back
+    //            to x two 'a' heights lower; the glyphs missing are skipped.
+    //****************************************************************************/
+    void layout(const std::string & text, float x, float y, float scale, std::vector<glm::vec4> & quads) {
+
+      float tmpX = x;
+      float tmpY = y;
+
+      const char * c   = text.data();
+      const char * end = text.data() + text.size();
+
+      while(c != end) {
+
+        uint32_t code = decode(c, end);
+
+        if(code == '\n') {
+          const Character_t * chA = get('a');
+          // without the distance field around an SDF glyph
+          int border = (mode == SDF) ? 2 * SDF_SPREAD : 0;
+          float lineHeight = chA ? (chA->Size.y - border) * scale : 0.0f;
+          tmpX  = x;
+          tmpY -= 2 * lineHeight;
+          continue;
+        }
+
+        const Character_t * chp = get(code);
+        if(chp == nullptr) continue;
+        const Character_t & ch = *chp;
+
+        if(ch.Size.x > 0 && ch.Size.y > 0) {
+
+          float xpos = tmpX + ch.Bearing.x * scale;
+          float ypos = tmpY - (ch.Size.y - ch.Bearing.y) * scale;
+
+          float w = ch.Size.x * scale;
+          float h = ch.Size.y * scale;
+
+          quads.insert(quads.end(), {
+            { xpos,     ypos + h,   ch.uvMin.x, ch.uvMin.y },
+            { xpos,     ypos,       ch.uvMin.x, ch.uvMax.y },
+            { xpos + w, ypos,       ch.uvMax.x, ch.uvMax.y },
+
+            { xpos,     ypos + h,   ch.uvMin.x, ch.uvMin.y },
+            { xpos + w, ypos,       ch.uvMax.x, ch.uvMax.y },
+            { xpos + w, ypos + h,   ch.uvMax.x, ch.uvMin.y }
+          });
+
+        }
+
+        // now advance cursors for next glyph (note that advance is number of 1/64 pixels
+        tmpX += (ch.Advance >> 6) * scale; // bitshift by 6 to get value in pixels (2^6 = 64 (divide amount of 1/64th pixels by 64 to get amount of pixels))
+
+      }
+
+    }
+
+    //****************************************************************************/
+    // decode() - next code point of a UTF-8 string; a malformed sequence is
+    //            consumed one byte at a time as U+FFFD
+    //****************************************************************************/
+    static uint32_t decode(const char * & c, const char * end) {
+
+      unsigned char lead = (unsigned char) *c++;
+
+      if(lead < 0x80) return lead;
+
+      int length;
+      uint32_t code;
+
+      if     ((lead & 0xE0) == 0xC0) { length = 1; code = lead & 0x1F; }
+      else if((lead & 0xF0) == 0xE0) { length = 2; code = lead & 0x0F; }
+      else if((lead & 0xF8) == 0xF0) { length = 3; code = lead & 0x07; }
+      else return 0xFFFD;
+
+      if(end - c < length) return 0xFFFD;
+
+      for(int i=0; i<length; ++i) {
+        unsigned char next = (unsigned char) c[i];
+        if((next & 0xC0) != 0x80) return 0xFFFD;
+        code = (code << 6) | (next & 0x3F);
+      }
+
+      // overlong forms, surrogates and values past U+10FFFF
+      static const uint32_t minimum[4] = { 0, 0x80, 0x800, 0x10000 };
+
+      if(code < minimum[length] || code > 0x10FFFF || (code >= 0xD800 && code <= 0xDFFF)) return 0xFFFD;
+
+      c += length;
+
+      return code;
+
     }
 
     //****************************************************************************/
@@ -101,78 +370,700 @@ namespace ogl {
 
       if(loaded) return;
 
-      FT_Library ft;
+      facePath      = fontPath;
+      facePixelSize = pixelSize;
+
+      // the atlas is built on the CPU and uploaded once
+      std::vector<unsigned char> pixels((std::size_t)ATLAS_SIZE * ATLAS_SIZE, 0);
+
+      uint64_t key = cacheKey(fontPath, pixelSize);
+
+      if(!loadCache(key, pixels)) {
+        rasterize(pixels);
+        storeCache(key, pixels);
+      }
+
+      glGenTextures(1, &texture);
+      glState().bindTexture(0, texture);
+
+      // disable byte-alignment restriction
+      glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, ATLAS_SIZE, ATLAS_SIZE, 0, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+
+      // set texture options
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+      glState().bindTexture(0, 0);
+
+      loaded = true;
+
+      glCheckError();
+
+    }
+
+    //****************************************************************************/
+    // cleanInGpu() - delete the atlas with the last context; the next load()
+    //                builds it again
+    //****************************************************************************/
+    void cleanInGpu() {
+
+      if(!loaded) return;
+
+      DEBUG_LOG("glFont::cleanInGpu()");
+
+      glWindow::forgetTexture(texture);
+      glDeleteTextures(1, &texture);
+
+      texture = 0;
+
+      // the glyphs placed on demand lived only in the texture
+      table.clear();
+      tableCount = 0;
+
+      loaded = false;
+
+    }
+
+    //****************************************************************************/
+    // checkTable() - the glyph table on its own, in a scratch font without
+    //                atlas (make test): the distinct non-ASCII 'codes' are
+    //                inserted with up to 'wrapping' more code points whose home
+    //                is one of the last 4 slots, so that their cluster wraps
+    //                around the end of the table. Then half of them are erased
+    //                one by one and inserted again, then the other half, every
+    //                code looked up after each erase. Returns the lookups that
+    //                went wrong; 'wrapped' tells how many entries sat past the
+    //                end of the table, probed from its start
+    //****************************************************************************/
+    static int checkTable(const std::vector<uint32_t> & _codes, int wrapping, std::size_t & wrapped) {
+
+      glFont font;
+
+      int failures = 0;
+
+      std::vector<uint32_t> codes = _codes;
+
+      for(uint32_t code : codes) {
+        Glyph_t glyph = Glyph_t();
+        glyph.code  = code;
+        glyph.shelf = -1;
+        font.insert(glyph);
+      }
+
+      for(uint32_t code=0x80; wrapping > 0 && code<=0x10FFFF && 2 * (font.tableCount + 1) <= font.table.size(); ++code) {
+
+        if(font.slot(code) + 4 < font.table.size() || font.find(code) != nullptr) continue;
+
+        Glyph_t glyph = Glyph_t();
+        glyph.code  = code;
+        glyph.shelf = -1;
+        font.insert(glyph);
+
+        codes.push_back(code);
+
+        --wrapping;
+
+      }
+
+      wrapped = 0;
+
+      for(std::size_t i=0; i<font.table.size(); ++i)
+        if(font.table[i].code != EMPTY && font.slot(font.table[i].code) > i) ++wrapped;
+
+      std::vector<uint8_t> isErased(codes.size(), 0);
+
+      for(std::size_t half=0; half<2; ++half) {
+
+        for(std::size_t k=half; k<codes.size(); k+=2) {
+
+          Glyph_t * glyph = font.find(codes[k]);
+
+          if(glyph == nullptr) { ++failures; continue; }
+
+          font.erase((std::size_t) (glyph - font.table.data()));
+
+          isErased[k] = 1;
+
+          for(std::size_t j=0; j<codes.size(); ++j)
+            if((font.find(codes[j]) == nullptr) != (isErased[j] != 0)) ++failures;
+
+        }
+
+        if(font.tableCount != codes.size() - (codes.size() + 1 - half) / 2) ++failures;
+
+        for(std::size_t k=half; k<codes.size(); k+=2) {
+          Glyph_t glyph = Glyph_t();
+          glyph.code  = codes[k];
+          glyph.shelf = -1;
+          font.insert(glyph);
+          isErased[k] = 0;
+        }
+
+      }
+
+      for(uint32_t code : codes) if(font.find(code) == nullptr) ++failures;
+
+      if(font.tableCount != codes.size()) ++failures;
+
+      return failures;
+
+    }
+
+  private:
+
+    //****************************************************************************/
+    // openFace() - the FreeType face, opened on the first need
+    //****************************************************************************/
+    void openFace() {
+
+      if(face != nullptr) return;
 
       // All functions return a value different than 0 whenever an error occurred
-      if(FT_Init_FreeType(&ft)) {
+      if(FT_Init_FreeType(&library)) {
         fprintf(stderr, "ERROR [glFont]: could not init FreeType library\n");
         abort();
       }
 
       // load font as face
-      FT_Face face;
-      if(FT_New_Face(ft, fontPath.c_str(), 0, &face)) {
+      if(FT_New_Face(library, facePath.c_str(), 0, &face)) {
         fprintf(stderr, "ERROR [glFont]: failed to load font\n");
         abort();
       }
 
       // set size to load glyphs as
-      FT_Set_Pixel_Sizes(face, 0, pixelSize);
+      FT_Set_Pixel_Sizes(face, 0, facePixelSize);
 
-      // disable byte-alignment restriction
-      glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    }
+
+    //****************************************************************************/
+    // rasterize() - render the ASCII glyphs into the atlas pixels
+    //****************************************************************************/
+    void rasterize(std::vector<unsigned char> & pixels) {
+
+      openFace();
+
+      shelves.clear();
 
       // load first 128 characters of ASCII set
-      for(unsigned char c = 0; c < 128; c++) {
+      for(uint32_t c = 0; c < 128; c++) {
+
+        Glyph_t & glyph = ascii[c];
 
-        // Load character glyph
-        if(FT_Load_Char(face, c, FT_LOAD_RENDER)) {
+        if(!render(c, glyph)) {
           fprintf(stderr, "WARNING [glFont]: failed to load glyph for char %d\n", (int)c);
           continue;
         }
 
-        // generate texture
-        GLuint textureID;
-        glGenTextures(1, &textureID);
-        glBindTexture(GL_TEXTURE_2D, textureID);
+        if(!glyph.isMissing && glyph.character.Size.x > 0 && glyph.character.Size.y > 0) {
+
+          int x, y;
+
+          glyph.shelf = allocate(glyph.character.Size.x, glyph.character.Size.y, x, y);
 
-        glTexImage2D(GL_TEXTURE_2D,
-                     0,
-                     GL_RED,
-                     face->glyph->bitmap.width,
-                     face->glyph->bitmap.rows,
-                     0,
-                     GL_RED,
-                     GL_UNSIGNED_BYTE,
-                     face->glyph->bitmap.buffer);
+          if(glyph.shelf < 0) {
+            fprintf(stderr, "WARNING [glFont]: atlas full, glyph for char %d dropped\n", (int)c);
+            glyph.code = EMPTY;
+            continue;
+          }
 
-        // set texture options
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+          shelves[glyph.shelf].isPinned = 1;
 
-        // now store character for later use
-        Character_t character = {
-          textureID,
-          glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-          glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-          (unsigned int)face->glyph->advance.x
-        };
+          for(int row=0; row<glyph.character.Size.y; ++row)
+            memcpy(&pixels[(std::size_t)(y + row) * ATLAS_SIZE + x], &image[(std::size_t)row * glyph.character.Size.x], glyph.character.Size.x);
 
-        characters.insert(std::pair<char, Character_t>(c, character));
+          setUv(glyph.character, x, y);
+
+        }
 
       }
 
-      glBindTexture(GL_TEXTURE_2D, 0);
+    }
 
-      // destroy FreeType once we're finished
-      FT_Done_Face(face);
-      FT_Done_FreeType(ft);
+    //****************************************************************************/
+    // render() - rasterize a code point in 'image' (coverage or distance field)
+    //            and fill its metrics; false if FreeType fails
+    //****************************************************************************/
+    bool render(uint32_t code, Glyph_t & glyph) {
 
-      loaded = true;
+      glyph.code      = code;
+      glyph.shelf     = -1;
+      glyph.isMissing = 0;
 
-      glCheckError();
+      // the notdef box of the font is not drawn
+      if(code >= 128 && FT_Get_Char_Index(face, code) == 0) { glyph.isMissing = 1; return true; }
+
+      if(FT_Load_Char(face, code, FT_LOAD_RENDER)) { glyph.code = EMPTY; return false; }
+
+      const FT_Bitmap & bitmap = face->glyph->bitmap;
+
+      glyph.character = {
+        glm::ivec2(bitmap.width, bitmap.rows),
+        glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
+        (unsigned int)face->glyph->advance.x,
+        glm::vec2(0.0f),
+        glm::vec2(0.0f)
+      };
+
+      if(bitmap.width == 0 || bitmap.rows == 0) return true;
+
+      if(mode == SDF) {
+
+        // an SDF glyph carries the field around its outline too
+        distanceField(bitmap, SDF_SPREAD, image);
+
+        glyph.character.Size    += glm::ivec2(2 * SDF_SPREAD);
+        glyph.character.Bearing += glm::ivec2(-SDF_SPREAD, SDF_SPREAD);
+
+      } else {
+
+        image.resize((std::size_t)bitmap.width * bitmap.rows);
+
+        for(int row=0; row<(int)bitmap.rows; ++row)
+          memcpy(&image[(std::size_t)row * bitmap.width], bitmap.buffer + row * bitmap.pitch, bitmap.width);
+
+      }
+
+      return true;
+
+    }
+
+    //****************************************************************************/
+    // add() - rasterize a non-ASCII code point, place it in the atlas and in
+    //         the table; nullptr if there is no room this frame
+    //****************************************************************************/
+    Glyph_t * add(uint32_t code) {
+
+      openFace();
+
+      Glyph_t glyph;
+
+      if(!render(code, glyph)) {
+        fprintf(stderr, "WARNING [glFont]: failed to load glyph for code point U+%04X\n", code);
+        glyph.code      = code;
+        glyph.isMissing = 1;
+      }
+
+      if(!glyph.isMissing && glyph.character.Size.x > 0 && glyph.character.Size.y > 0) {
+
+        int x, y;
+
+        glyph.shelf = allocate(glyph.character.Size.x, glyph.character.Size.y, x, y);
+
+        if(glyph.shelf < 0 && evict(glyph.character.Size.y)) glyph.shelf = allocate(glyph.character.Size.x, glyph.character.Size.y, x, y);
+
+        // tried again on the next request
+        if(glyph.shelf < 0) return nullptr;
+
+        glState().bindTexture(0, texture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, glyph.character.Size.x, glyph.character.Size.y, GL_RED, GL_UNSIGNED_BYTE, image.data());
+
+        setUv(glyph.character, x, y);
+
+      }
+
+      return insert(glyph);
+
+    }
+
+    //****************************************************************************/
+    // evict() - empty the least recently drawn shelf that can hold a glyph
+    //           'height' pixels tall, not pinned and not drawn this frame
+    //****************************************************************************/
+    bool evict(int height) {
+
+      uint64_t frame = glWindow::getFramesCount();
+
+      int victim = -1;
+
+      for(int i=0; i<(int)shelves.size(); ++i) {
+
+        const Shelf_t & shelf = shelves[i];
+
+        if(shelf.isPinned || shelf.lastUsed == frame || shelf.height < height + 2 * PADDING) continue;
+
+        if(victim < 0 || shelf.lastUsed < shelves[victim].lastUsed) victim = i;
+
+      }
+
+      if(victim < 0) {
+        fprintf(stderr, "WARNING [glFont]: atlas full, glyphs skipped this frame\n");
+        return false;
+      }
+
+      DEBUG_LOG("glFont::evict() shelf " + std::to_string(victim));
+
+      // forget its glyphs: a deletion in a linear probing table moves the
+      // following entries back, so the slot is examined again
+      for(std::size_t i=0; i<table.size(); ) {
+        if(table[i].code != EMPTY && table[i].shelf == victim) erase(i); else ++i;
+      }
+
+      Shelf_t & shelf = shelves[victim];
+
+      // the padding of the next glyphs must read zero
+      std::vector<unsigned char> zero((std::size_t)ATLAS_SIZE * shelf.height, 0);
+
+      glState().bindTexture(0, texture);
+      glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, shelf.y, ATLAS_SIZE, shelf.height, GL_RED, GL_UNSIGNED_BYTE, zero.data());
+
+      shelf.x = 0;
+
+      ++evictedCounter;
+
+      return true;
+
+    }
+
+    //****************************************************************************/
+    // slot() - home slot of a code point (Fibonacci hashing)
+    //****************************************************************************/
+    inline std::size_t slot(uint32_t code) const { return (uint32_t)(code * 2654435769u) >> tableShift; }
+
+    //****************************************************************************/
+    // find() - glyph of a non-ASCII code point in the table, nullptr if absent
+    //****************************************************************************/
+    Glyph_t * find(uint32_t code) {
+
+      if(table.empty()) return nullptr;
+
+      std::size_t mask = table.size() - 1;
+
+      for(std::size_t i = slot(code); ; i = (i + 1) & mask) {
+        if(table[i].code == code)  return &table[i];
+        if(table[i].code == EMPTY) return nullptr;
+      }
+
+    }
+
+    //****************************************************************************/
+    // insert() - add a glyph to the table, grown to keep it at most half full
+    //****************************************************************************/
+    Glyph_t * insert(const Glyph_t & glyph) {
+
+      if(2 * (tableCount + 1) > table.size()) {
+
+        std::vector<Glyph_t> old;
+        old.swap(table);
+
+        std::size_t size = old.empty() ? 256 : 2 * old.size();
+
+        Glyph_t empty;
+        empty.code = EMPTY;
+
+        table.assign(size, empty);
+
+        tableShift = 32;
+        for(std::size_t s = size; s > 1; s >>= 1) --tableShift;
+
+        tableCount = 0;
+
+        for(const Glyph_t & entry : old) if(entry.code != EMPTY) insert(entry);
+
+      }
+
+      std::size_t mask = table.size() - 1;
+
+      std::size_t i = slot(glyph.code);
+
+      while(table[i].code != EMPTY) i = (i + 1) & mask;
+
+      table[i] = glyph;
+
+      ++tableCount;
+
+      return &table[i];
+
+    }
+
+    //****************************************************************************/
+    // erase() - remove the entry at i, moving back the entries of its cluster
+    //           that would no longer be reachable (no tombstones)
+    //****************************************************************************/
+    void erase(std::size_t i) {
+
+      std::size_t mask = table.size() - 1;
+
+      for(std::size_t j = (i + 1) & mask; table[j].code != EMPTY; j = (j + 1) & mask) {
+
+        std::size_t home = slot(table[j].code);
+
+        // the entry stays if its home lies cyclically in (i, j]
+        bool isReachable = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+
+        if(isReachable) continue;
+
+        table[i] = table[j];
+
+        i = j;
+
+      }
+
+      table[i].code = EMPTY;
+
+      --tableCount;
+
+    }
+
+    //****************************************************************************/
+    // setUv() - atlas coordinates of a glyph placed at (x, y)
+    //****************************************************************************/
+    static inline void setUv(Character_t & character, int x, int y) {
+      character.uvMin = glm::vec2(x, y) / (float)ATLAS_SIZE;
+      character.uvMax = glm::vec2(x + character.Size.x, y + character.Size.y) / (float)ATLAS_SIZE;
+    }
+
+    //****************************************************************************/
+    // distanceField() - signed distance to the outline of a coverage bitmap,
+    //                   'border' pixels larger on each side, 0.5 on the outline
+    //****************************************************************************/
+    static void distanceField(const FT_Bitmap & bitmap, int border, std::vector<unsigned char> & field) {
+
+      int width  = (int)bitmap.width + 2 * border;
+      int height = (int)bitmap.rows  + 2 * border;
+
+      std::size_t size = (std::size_t)width * height;
+
+      // squared distance to the nearest inside and outside pixel
+      std::vector<float> toInside(size), toOutside(size);
+
+      for(int y=0; y<height; ++y) {
+        for(int x=0; x<width; ++x) {
+
+          int bx = x - border;
+          int by = y - border;
+
+          bool isInside = (bx >= 0 && by >= 0 && bx < (int)bitmap.width && by < (int)bitmap.rows) && bitmap.buffer[by * bitmap.pitch + bx] >= 128;
+
+          toInside [(std::size_t)y * width + x] = isInside ? 0.0f : INFINITY;
+          toOutside[(std::size_t)y * width + x] = isInside ? INFINITY : 0.0f;
+
+        }
+      }
+
+      transform(toInside,  width, height);
+      transform(toOutside, width, height);
+
+      field.resize(size);
+
+      for(std::size_t i=0; i<size; ++i) {
+
+        // the centers of two neighbouring pixels are half a pixel from the outline
+        float distance = (toInside[i] > 0.0f) ? std::sqrt(toInside[i]) - 0.5f : 0.5f - std::sqrt(toOutside[i]);
+
+        float value = 0.5f - distance / (2.0f * SDF_SPREAD);
+
+        field[i] = (unsigned char) std::lround(std::min(std::max(value, 0.0f), 1.0f) * 255.0f);
+
+      }
+
+    }
+
+    //****************************************************************************/
+    // transform() - squared Euclidean distance transform of a grid holding 0 at
+    //               the features and infinity elsewhere (Felzenszwalb and
+    //               Huttenlocher: a 1D pass over the columns, then the rows)
+    //****************************************************************************/
+    static void transform(std::vector<float> & grid, int width, int height) {
+
+      int n = std::max(width, height);
+
+      std::vector<float> f(n), d(n), z(n + 1);
+      std::vector<int> v(n);
+
+      for(int x=0; x<width; ++x) {
+        for(int y=0; y<height; ++y) f[y] = grid[(std::size_t)y * width + x];
+        transform(f.data(), d.data(), v.data(), z.data(), height);
+        for(int y=0; y<height; ++y) grid[(std::size_t)y * width + x] = d[y];
+      }
+
+      for(int y=0; y<height; ++y) {
+        for(int x=0; x<width; ++x) f[x] = grid[(std::size_t)y * width + x];
+        transform(f.data(), d.data(), v.data(), z.data(), width);
+        for(int x=0; x<width; ++x) grid[(std::size_t)y * width + x] = d[x];
+      }
+
+    }
+
+    //****************************************************************************/
+    // transform() - 1D pass: lower envelope of the parabolas rooted at f
+    //****************************************************************************/
+    static void transform(const float * f, float * d, int * v, float * z, int n) {
+
+      int k = 0;
+
+      // the first finite sample starts the envelope
+      int first = 0;
+      while(first < n && std::isinf(f[first])) ++first;
+
+      if(first == n) { for(int q=0; q<n; ++q) d[q] = INFINITY; return; }
+
+      v[0] = first;
+      z[0] = -INFINITY;
+      z[1] =  INFINITY;
+
+      // abscissa where the parabolas rooted at q and p cross
+      auto intersect = [f](int q, int p) { return ((f[q] + (float)q * q) - (f[p] + (float)p * p)) / (2.0f * (q - p)); };
+
+      for(int q=first+1; q<n; ++q) {
+
+        // the samples away from every feature root no parabola
+        if(std::isinf(f[q])) continue;
+
+        float s = intersect(q, v[k]);
+
+        // z[0] is -infinity, so the envelope never empties
+        while(s <= z[k]) { --k; s = intersect(q, v[k]); }
+
+        ++k;
+        v[k]     = q;
+        z[k]     = s;
+        z[k + 1] = INFINITY;
+
+      }
+
+      k = 0;
+
+      for(int q=0; q<n; ++q) {
+        while(z[k + 1] < q) ++k;
+        float dq = (float)(q - v[k]);
+        d[q] = dq * dq + f[v[k]];
+      }
+
+    }
+
+    //****************************************************************************/
+    // cacheKey() - Key of the atlas: the font file, its size and time, the
+    //              pixel size, the mode and the atlas layout
+    //****************************************************************************/
+    uint64_t cacheKey(const std::string & fontPath, unsigned int pixelSize) const {
+
+      // bump when the rasterization or the layout of the data changes
+      const uint32_t version = 2;
+
+      struct stat info;
+
+      uint64_t stamp[2] = { 0, 0 };
+
+      if(stat(fontPath.c_str(), &info) == 0) { stamp[0] = (uint64_t) info.st_size; stamp[1] = (uint64_t) info.st_mtime; }
+
+      int32_t layout[4] = { ATLAS_SIZE, PADDING, SDF_SPREAD, mode };
+
+      uint64_t key = ogl::cache::hash(fontPath);
+
+      key = ogl::cache::hash(stamp,      sizeof(stamp),     key);
+      key = ogl::cache::hash(&pixelSize, sizeof(pixelSize), key);
+      key = ogl::cache::hash(layout,     sizeof(layout),    key);
+      key = ogl::cache::hash(&version,   sizeof(version),   key);
+
+      return key;
+
+    }
+
+    //****************************************************************************/
+    // loadCache() - Restore the ASCII glyphs, shelves and pixels, false on a miss
+    //****************************************************************************/
+    bool loadCache(uint64_t key, std::vector<unsigned char> & pixels) {
+
+      std::vector<char> data;
+
+      if(!ogl::cache::load("font", key, data)) return false;
+
+      uint32_t header[2];
+
+      if(data.size() < sizeof(header)) return false;
+
+      memcpy(header, data.data(), sizeof(header));
+
+      uint32_t shelvesCount = header[0];
+      uint32_t rows         = header[1];
+
+      std::size_t expected = sizeof(header) + sizeof(ascii) + shelvesCount * sizeof(Shelf_t) + (std::size_t)rows * ATLAS_SIZE;
+
+      if(data.size() != expected || rows > (uint32_t)ATLAS_SIZE) {
+        fprintf(stderr, "WARNING [glFont]: corrupted cache entry, rasterizing again\n");
+        return false;
+      }
+
+      const char * cursor = data.data() + sizeof(header);
+
+      memcpy(ascii, cursor, sizeof(ascii));
+      cursor += sizeof(ascii);
+
+      shelves.resize(shelvesCount);
+
+      memcpy(shelves.data(), cursor, shelvesCount * sizeof(Shelf_t));
+      cursor += shelvesCount * sizeof(Shelf_t);
+
+      memcpy(pixels.data(), cursor, (std::size_t)rows * ATLAS_SIZE);
+
+      return true;
+
+    }
+
+    //****************************************************************************/
+    // storeCache() - Save the ASCII glyphs, shelves and the rows of pixels in use
+    //****************************************************************************/
+    void storeCache(uint64_t key, const std::vector<unsigned char> & pixels) const {
+
+      if(!ogl::cache::isEnabled()) return;
+
+      uint32_t rows = shelves.empty() ? 0 : (uint32_t)(shelves.back().y + shelves.back().height);
+
+      uint32_t header[2] = { (uint32_t)shelves.size(), rows };
+
+      std::vector<char> data((const char *)header, (const char *)header + sizeof(header));
+
+      data.insert(data.end(), (const char *)ascii, (const char *)ascii + sizeof(ascii));
+      data.insert(data.end(), (const char *)shelves.data(), (const char *)(shelves.data() + shelves.size()));
+      data.insert(data.end(), (const char *)pixels.data(),  (const char *)pixels.data() + (std::size_t)rows * ATLAS_SIZE);
+
+      if(!ogl::cache::store("font", key, data.data(), data.size()))
+        fprintf(stderr, "WARNING [glFont]: atlas not saved in the cache\n");
+
+    }
+
+    //****************************************************************************/
+    // allocate() - place a width x height glyph (plus its padding) in the
+    //              shelf that wastes the least height, or in a new one;
+    //              returns the shelf, -1 if the atlas is full
+    //****************************************************************************/
+    int allocate(int width, int height, int & x, int & y) {
+
+      int w = width  + 2 * PADDING;
+      int h = height + 2 * PADDING;
+
+      int best = -1;
+
+      for(int i=0; i<(int)shelves.size(); ++i) {
+        const Shelf_t & shelf = shelves[i];
+        if(shelf.height < h || shelf.x + w > ATLAS_SIZE) continue;
+        if(best < 0 || shelf.height < shelves[best].height) best = i;
+      }
+
+      if(best < 0) {
+
+        int top = shelves.empty() ? 0 : shelves.back().y + shelves.back().height;
+
+        if(top + h > ATLAS_SIZE || w > ATLAS_SIZE) return -1;
+
+        shelves.push_back({ top, h, 0, 0, glWindow::getFramesCount() });
+
+        best = (int)shelves.size() - 1;
+
+      }
+
+      x = shelves[best].x + PADDING;
+      y = shelves[best].y + PADDING;
+
+      shelves[best].x += w;
+
+      return best;
 
     }
 
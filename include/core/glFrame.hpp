@@ -0,0 +1,236 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _H_OGL_GLFRAME_H_
+#define _H_OGL_GLFRAME_H_
+
+
+#ifndef _H_OGL_H_
+  #error "Do not include this header directly; include <ogl/ogl.hpp> instead."
+#endif
+
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+
+//****************************************************************************/
+// namespace ogl
+//****************************************************************************/
+namespace ogl {
+
+  //****************************************************************************/
+  // glFrame
+  //****************************************************************************/
+  // Per-context std140 uniform buffers shared by all the built-in shaders:
+  //   - "Frame"    (binding FRAME_BINDING): projection, view, 2D ortho
+  //                 projection and viewport of the camera being rendered;
+  //   - "Lighting" (binding LIGHT_BINDING): the glLight in view space.
+  // glWindow::renderBegin() sets the window camera once per frame. Objects
+  // then only call setCamera()/setLight() with what they are about to draw:
+  // the values are compared with the ones already in the buffer and uploaded
+  // only when they differ, so a frame with thousands of objects under the
+  // same camera and the same light uploads each block once instead of sending
+  // the matrices and the light through setUniform() for every draw.
+  //****************************************************************************/
+  class glFrame {
+
+  public:
+
+    static constexpr GLuint FRAME_BINDING = 0;
+    static constexpr GLuint LIGHT_BINDING = 1;
+
+    // binding of the per-draw "MaterialBlock" (see glMaterial)
+    static constexpr GLuint MATERIAL_BINDING = 2;
+
+    // std140 layout of the "Frame" block
+    struct Frame_t {
+      glm::mat4 projection;
+      glm::mat4 view;
+      glm::mat4 orthoProjection;
+      glm::vec4 viewport;
+    };
+
+    // std140 layout of the "Lighting" block (the vec3 of the GLSL Light
+    // struct are 16 bytes aligned, hence the vec4)
+    struct Light_t {
+      glm::vec4 direction;
+      glm::vec4 position;
+      glm::vec4 ambient;
+      glm::vec4 diffuse;
+      glm::vec4 specular;
+    };
+
+  private:
+
+    GLuint frameUbo = 0;
+    GLuint lightUbo = 0;
+
+    Frame_t frame;
+    Light_t light;
+
+    bool isFrameValid = false;
+    bool isLightValid = false;
+
+    uint32_t uploadCounter = 0;
+
+  public:
+
+    //****************************************************************************/
+    // glFrame
+    //****************************************************************************/
+    glFrame() { }
+
+    //****************************************************************************/
+    // The buffers belong to the window that owns the glFrame
+    //****************************************************************************/
+    glFrame(const glFrame &) = delete;
+    glFrame & operator = (const glFrame &) = delete;
+
+    //****************************************************************************/
+    // initInGpu() - create and bind the buffers, with the context current
+    //****************************************************************************/
+    void initInGpu() {
+
+      DEBUG_LOG("glFrame::initInGpu()");
+
+      glGenBuffers(1, &frameUbo);
+      glBindBuffer(GL_UNIFORM_BUFFER, frameUbo);
+      glBufferData(GL_UNIFORM_BUFFER, sizeof(Frame_t), NULL, GL_DYNAMIC_DRAW);
+
+      glGenBuffers(1, &lightUbo);
+      glBindBuffer(GL_UNIFORM_BUFFER, lightUbo);
+      glBufferData(GL_UNIFORM_BUFFER, sizeof(Light_t), NULL, GL_DYNAMIC_DRAW);
+
+      glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+      glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_BINDING, frameUbo);
+      glBindBufferBase(GL_UNIFORM_BUFFER, LIGHT_BINDING, lightUbo);
+
+      isFrameValid = false;
+      isLightValid = false;
+
+      glCheckError();
+
+    }
+
+    //****************************************************************************/
+    // cleanInGpu() - the context must be current
+    //****************************************************************************/
+    void cleanInGpu() {
+
+      if(frameUbo != 0) glDeleteBuffers(1, &frameUbo);
+      if(lightUbo != 0) glDeleteBuffers(1, &lightUbo);
+
+      frameUbo = 0;
+      lightUbo = 0;
+
+    }
+
+    //****************************************************************************/
+    // setCamera() - make the "Frame" block describe camera
+    //****************************************************************************/
+    inline void setCamera(const glCamera & camera) {
+      set(camera.getProjection(), camera.getView(), camera.getOrthoProjection(), camera.getViewport());
+    }
+
+    //****************************************************************************/
+    // set() - explicit matrices, for overlays with their own projection
+    //****************************************************************************/
+    inline void set(const glm::mat4 & projection, const glm::mat4 & view, const glm::mat4 & orthoProjection, const glm::vec2 & viewport) {
+
+      Frame_t value;
+
+      value.projection      = projection;
+      value.view            = view;
+      value.orthoProjection = orthoProjection;
+      value.viewport        = glm::vec4(viewport, 0.0f, 0.0f);
+
+      if(isFrameValid && memcmp(&value, &frame, sizeof(Frame_t)) == 0) return;
+
+      frame = value;
+
+      upload(frameUbo, &frame, sizeof(Frame_t));
+
+      isFrameValid = true;
+
+    }
+
+    //****************************************************************************/
+    // setLight() - make the "Lighting" block describe a light (view space)
+    //****************************************************************************/
+    inline void setLight(const Light_t & value) {
+
+      if(isLightValid && memcmp(&value, &light, sizeof(Light_t)) == 0) return;
+
+      light = value;
+
+      upload(lightUbo, &light, sizeof(Light_t));
+
+      isLightValid = true;
+
+    }
+
+    //****************************************************************************/
+    // get() - values currently in the buffers
+    //****************************************************************************/
+    inline const Frame_t & getFrame() const { return frame; }
+    inline const Light_t & getLight() const { return light; }
+
+    //****************************************************************************/
+    // getUploadCount() - number of buffer updates since creation
+    //****************************************************************************/
+    inline uint32_t getUploadCount() const { return uploadCounter; }
+
+    //****************************************************************************/
+    // bindBlocks() - attach the blocks a program declares to their binding
+    // points (GLSL 330 has no layout(binding = N) for uniform blocks)
+    //****************************************************************************/
+    static void bindBlocks(GLuint program) {
+
+      GLuint index = glGetUniformBlockIndex(program, "Frame");
+      if(index != GL_INVALID_INDEX) glUniformBlockBinding(program, index, FRAME_BINDING);
+
+      index = glGetUniformBlockIndex(program, "Lighting");
+      if(index != GL_INVALID_INDEX) glUniformBlockBinding(program, index, LIGHT_BINDING);
+
+      index = glGetUniformBlockIndex(program, "MaterialBlock");
+      if(index != GL_INVALID_INDEX) glUniformBlockBinding(program, index, MATERIAL_BINDING);
+
+    }
+
+  private:
+
+    //****************************************************************************/
+    // upload()
+    //****************************************************************************/
+    inline void upload(GLuint ubo, const void * data, size_t size) {
+
+      glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+      glBufferSubData(GL_UNIFORM_BUFFER, 0, size, data);
+      glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+      ++uploadCounter;
+
+    }
+
+  };
+
+} /* namespace ogl */
+
+#endif /* _H_OGL_GLFRAME_H_ */
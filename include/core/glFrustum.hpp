@@ -0,0 +1,191 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _H_OGL_GLFRUSTUM_H_
+#define _H_OGL_GLFRUSTUM_H_
+
+
+#ifndef _H_OGL_H_
+  #error "Do not include this header directly; include <ogl/ogl.hpp> instead."
+#endif
+
+#include <cstdlib>
+#include <cstdio>
+#include <cfloat>
+
+//****************************************************************************/
+// namespace ogl
+//****************************************************************************/
+namespace ogl {
+
+  //****************************************************************************/
+  // glAABB
+  //****************************************************************************/
+  // Axis-aligned bounding box. An empty box has min > max.
+  //****************************************************************************/
+  struct glAABB {
+
+    glm::vec3 min = glm::vec3(+FLT_MAX);
+    glm::vec3 max = glm::vec3(-FLT_MAX);
+
+    //****************************************************************************/
+    // expand() - grow the box to contain a point / another box
+    //****************************************************************************/
+    inline void expand(const glm::vec3 & point) { min = glm::min(min, point); max = glm::max(max, point); }
+    inline void expand(const glAABB & box)      { min = glm::min(min, box.min); max = glm::max(max, box.max); }
+
+    //****************************************************************************/
+    // isEmpty()
+    //****************************************************************************/
+    inline bool isEmpty() const { return min.x > max.x || min.y > max.y || min.z > max.z; }
+
+    //****************************************************************************/
+    // getCenter() / getSize() / getRadius() - radius of the bounding sphere
+    //****************************************************************************/
+    inline glm::vec3 getCenter() const { return isEmpty() ? glm::vec3(0.0f) : (min + max) * 0.5f; }
+    inline glm::vec3 getSize()   const { return isEmpty() ? glm::vec3(0.0f) : (max - min); }
+    inline float     getRadius() const { return glm::length(getSize()) * 0.5f; }
+
+  };
+
+  //****************************************************************************/
+  // glFrustum
+  //****************************************************************************/
+  // The six planes of a clip matrix (Gribb & Hartmann). Built from
+  // projection * view * model, the planes live in the object space of the
+  // model, so the bounds of its meshes are tested without transforming them.
+  // Planes are normalized and point inside: a point p is inside a plane when
+  // dot(plane.xyz, p) + plane.w >= 0.
+  //****************************************************************************/
+  class glFrustum {
+
+  public:
+
+    enum CONTAINMENT { OUTSIDE, INTERSECTS, INSIDE };
+
+  private:
+
+    glm::vec4 planes[6];
+
+  public:
+
+    //****************************************************************************/
+    // glFrustum
+    //****************************************************************************/
+    glFrustum() { }
+
+    glFrustum(const glm::mat4 & matrix) { set(matrix); }
+
+    //****************************************************************************/
+    // set() - extract the planes of a clip matrix
+    //****************************************************************************/
+    void set(const glm::mat4 & m) {
+
+      // rows of the matrix (glm is column major)
+      glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+      glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+      glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+      glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+      planes[0] = row3 + row0; // left
+      planes[1] = row3 - row0; // right
+      planes[2] = row3 + row1; // bottom
+      planes[3] = row3 - row1; // top
+      planes[4] = row3 + row2; // near
+      planes[5] = row3 - row2; // far
+
+      for(int i=0; i<6; ++i) {
+        float length = glm::length(glm::vec3(planes[i]));
+        if(length > 0.0f) planes[i] /= length;
+      }
+
+    }
+
+    //****************************************************************************/
+    // isVisible() - false when the sphere is entirely outside a plane
+    //****************************************************************************/
+    bool isVisible(const glm::vec3 & center, float radius) const {
+
+      for(int i=0; i<6; ++i)
+        if(glm::dot(glm::vec3(planes[i]), center) + planes[i].w < -radius) return false;
+
+      return true;
+
+    }
+
+    //****************************************************************************/
+    // isVisible() - false when the box is entirely outside a plane (the corner
+    //               farthest along the plane normal is tested)
+    //****************************************************************************/
+    bool isVisible(const glAABB & box) const {
+
+      if(box.isEmpty()) return false;
+
+      for(int i=0; i<6; ++i) {
+
+        glm::vec3 corner((planes[i].x > 0.0f) ? box.max.x : box.min.x,
+                         (planes[i].y > 0.0f) ? box.max.y : box.min.y,
+                         (planes[i].z > 0.0f) ? box.max.z : box.min.z);
+
+        if(glm::dot(glm::vec3(planes[i]), corner) + planes[i].w < 0.0f) return false;
+
+      }
+
+      return true;
+
+    }
+
+    //****************************************************************************/
+    // classify() - OUTSIDE, INSIDE (every corner inside every plane) or
+    //              INTERSECTS; a hierarchy stops testing below an INSIDE box
+    //****************************************************************************/
+    CONTAINMENT classify(const glAABB & box) const {
+
+      if(box.isEmpty()) return OUTSIDE;
+
+      CONTAINMENT result = INSIDE;
+
+      for(int i=0; i<6; ++i) {
+
+        glm::vec3 normal(planes[i]);
+
+        glm::vec3 farthest((normal.x > 0.0f) ? box.max.x : box.min.x,
+                           (normal.y > 0.0f) ? box.max.y : box.min.y,
+                           (normal.z > 0.0f) ? box.max.z : box.min.z);
+
+        if(glm::dot(normal, farthest) + planes[i].w < 0.0f) return OUTSIDE;
+
+        glm::vec3 nearest((normal.x > 0.0f) ? box.min.x : box.max.x,
+                          (normal.y > 0.0f) ? box.min.y : box.max.y,
+                          (normal.z > 0.0f) ? box.min.z : box.max.z);
+
+        if(glm::dot(normal, nearest) + planes[i].w < 0.0f) result = INTERSECTS;
+
+      }
+
+      return result;
+
+    }
+
+  };
+
+} /* namespace ogl */
+
+#endif /* _H_OGL_GLFRUSTUM_H_ */
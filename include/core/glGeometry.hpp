@@ -0,0 +1,436 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _H_OGL_GLGEOMETRY_H_
+#define _H_OGL_GLGEOMETRY_H_
+
+
+#ifndef _H_OGL_H_
+  #error "Do not include this header directly; include <ogl/ogl.hpp> instead."
+#endif
+
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <cstdint>
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+//****************************************************************************/
+// namespace ogl
+//****************************************************************************/
+namespace ogl {
+
+  //****************************************************************************/
+  // glGeometry
+  //****************************************************************************/
+  // CPU side indexed mesh (positions, normals, texture coordinates) and the
+  // builders of the unit shapes the objects are scaled from.
+  //****************************************************************************/
+  struct glGeometry {
+
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec2> texCoords;
+    std::vector<GLuint>    indices;
+
+    //****************************************************************************/
+    // sphere() - UV sphere of radius 1 centered in the origin
+    //****************************************************************************/
+    static glGeometry sphere(int stacks, int slices) {
+
+      glGeometry geometry;
+
+      for(int i=0; i<=stacks; ++i) {
+
+        // V texture coordinate
+        float V   = i / (float)stacks;
+        float phi = V * M_PI - M_PI/2.0;
+
+        for(int j=0; j<=slices; ++j) {
+
+          // U texture coordinate
+          float U     = j / (float)slices;
+          float theta = U * 2.0f * M_PI;
+
+          glm::vec3 position(cos(phi) * cos(theta), cos(phi) * sin(theta), sin(phi));
+
+          // on the unit sphere the normal is the position itself
+          geometry.positions.push_back(position);
+          geometry.normals.push_back(position);
+          geometry.texCoords.push_back(glm::vec2(U, V));
+
+        }
+
+      }
+
+      int noPerSlice = slices + 1;
+
+      for(int i=0; i<stacks; ++i) {
+
+        for(int j=0; j<slices; ++j) {
+
+          GLuint start = (i * noPerSlice) + j;
+
+          geometry.indices.push_back(start);
+          geometry.indices.push_back(start + noPerSlice + 1);
+          geometry.indices.push_back(start + noPerSlice);
+
+          geometry.indices.push_back(start + noPerSlice + 1);
+          geometry.indices.push_back(start);
+          geometry.indices.push_back(start + 1);
+
+        }
+
+      }
+
+      return geometry;
+
+    }
+
+    //****************************************************************************/
+    // cuboid() - cube of side 1 centered in the origin. The 8 shared corners
+    //            cannot carry per-face normals, so each face gets its own 4
+    //            vertices with a flat outward normal.
+    //****************************************************************************/
+    static glGeometry cuboid() {
+
+      glGeometry geometry;
+
+      const glm::vec3 corners[8] = {
+        {-0.5f,  0.5f,  0.5f},
+        { 0.5f,  0.5f,  0.5f},
+        { 0.5f, -0.5f,  0.5f},
+        {-0.5f, -0.5f,  0.5f},
+        {-0.5f,  0.5f, -0.5f},
+        { 0.5f,  0.5f, -0.5f},
+        { 0.5f, -0.5f, -0.5f},
+        {-0.5f, -0.5f, -0.5f}
+      };
+
+      // corners of each face, counter-clockwise seen from outside
+      const int faceCorner[6][4] = {
+        { 0, 3, 2, 1 }, // Front
+        { 1, 2, 6, 5 }, // Right
+        { 5, 6, 7, 4 }, // Back
+        { 4, 7, 3, 0 }, // Left
+        { 4, 0, 1, 5 }, // Top
+        { 3, 7, 6, 2 }  // Bottom
+      };
+
+      const glm::vec3 faceNormal[6] = {
+        { 0,  0,  1}, // Front
+        { 1,  0,  0}, // Right
+        { 0,  0, -1}, // Back
+        {-1,  0,  0}, // Left
+        { 0,  1,  0}, // Top
+        { 0, -1,  0}  // Bottom
+      };
+
+      const glm::vec2 faceUV[4] = { {0, 1}, {0, 0}, {1, 0}, {1, 1} };
+
+      for(int f=0; f<6; ++f) {
+
+        GLuint base = (GLuint)geometry.positions.size();
+
+        for(int k=0; k<4; ++k) {
+          geometry.positions.push_back(corners[faceCorner[f][k]]);
+          geometry.normals.push_back(faceNormal[f]);
+          geometry.texCoords.push_back(faceUV[k]);
+        }
+
+        const GLuint quad[6] = { 0, 1, 2, 2, 3, 0 };
+
+        for(int k=0; k<6; ++k) geometry.indices.push_back(base + quad[k]);
+
+      }
+
+      return geometry;
+
+    }
+
+    //****************************************************************************/
+    // quad() - square of side 1 in the XY plane centered in the origin, facing +Z
+    //****************************************************************************/
+    static glGeometry quad() {
+
+      glGeometry geometry;
+
+      geometry.positions = { {-0.5f,  0.5f, 0.0f}, {-0.5f, -0.5f, 0.0f}, { 0.5f, -0.5f, 0.0f}, { 0.5f,  0.5f, 0.0f} };
+      geometry.normals   = std::vector<glm::vec3>(4, glm::vec3(0.0f, 0.0f, 1.0f));
+      geometry.texCoords = { {0, 1}, {0, 0}, {1, 0}, {1, 1} };
+      geometry.indices   = { 0, 1, 2, 0, 2, 3 };
+
+      return geometry;
+
+    }
+
+  };
+
+  //****************************************************************************/
+  // glGeometries
+  //****************************************************************************/
+  // Process-wide registry of the unit meshes in GPU memory, keyed by
+  // (geometry key, share group) and reference counted like the glPrograms.
+  // The key names the primitive and its tessellation (e.g. "sphere/16x32");
+  // the size of each object goes in its model matrix, so a thousand spheres
+  // with the same stacks and slices share one set of buffers instead of
+  // uploading their own copy (and one vertex array per window).
+  //****************************************************************************/
+  class glGeometries {
+
+    public:
+
+      // Buffers of positions (0), normals (1), texture coordinates (2) and
+      // GLuint indices, and the vertex array that reads them
+      struct Mesh_t {
+        GLuint vbo[4] = { 0, 0, 0, 0 };
+        GLsizei count = 0;
+        GLenum type = GL_UNSIGNED_INT;
+        uint32_t references = 0;
+        glVertexArray vao;
+      };
+
+    private:
+
+      static std::unordered_map<std::string, Mesh_t> meshes;
+
+      static uint32_t uploadedCounter;
+
+    public:
+
+      //****************************************************************************/
+      // acquire() - get the mesh of a key in a share group, uploading the
+      // geometry returned by build() on the first request. The returned entry
+      // stays valid until release().
+      //****************************************************************************/
+      template <class Builder>
+      static Mesh_t * acquire(const std::string & geometryKey, uint32_t shareGroup, Builder build) {
+
+        Mesh_t & mesh = meshes[geometryKey + '@' + std::to_string(shareGroup)];
+
+        if(mesh.references++ == 0) {
+
+          DEBUG_LOG("glGeometries::acquire(" + geometryKey + ") upload on share group " + std::to_string(shareGroup));
+
+          uint32_t references = mesh.references;
+
+          mesh = upload(build());
+
+          mesh.references = references;
+
+        }
+
+        return &mesh;
+
+      }
+
+      //****************************************************************************/
+      // release() - drop a reference, the mesh is deleted with the last one
+      //****************************************************************************/
+      static void release(const std::string & geometryKey, uint32_t shareGroup) {
+
+        auto it = meshes.find(geometryKey + '@' + std::to_string(shareGroup));
+
+        if(it == meshes.end()) return;
+
+        if(--it->second.references == 0) {
+
+          DEBUG_LOG("glGeometries::release(" + geometryKey + ") on share group " + std::to_string(shareGroup));
+
+          if(glfwGetCurrentContext() != NULL) destroy(it->second);
+
+          meshes.erase(it);
+
+        }
+
+      }
+
+      //****************************************************************************/
+      // upload() - create the buffers of a geometry (attributes without data are
+      // left disabled). Meshes made this way outside acquire() are owned by the
+      // caller, who frees them with destroy().
+      //****************************************************************************/
+      static Mesh_t upload(const glGeometry & geometry) {
+
+        Mesh_t mesh;
+
+        mesh.count = (GLsizei)geometry.indices.size();
+
+        glGenBuffers(4, mesh.vbo);
+
+        // Positions
+        glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo[0]);
+        glBufferData(GL_ARRAY_BUFFER, geometry.positions.size() * sizeof(glm::vec3), geometry.positions.data(), GL_STATIC_DRAW);
+        mesh.vao.attribute(0, mesh.vbo[0], 3, GL_FLOAT);
+
+        // Normals
+        if(!geometry.normals.empty()) {
+          glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo[1]);
+          glBufferData(GL_ARRAY_BUFFER, geometry.normals.size() * sizeof(glm::vec3), geometry.normals.data(), GL_STATIC_DRAW);
+          mesh.vao.attribute(1, mesh.vbo[1], 3, GL_FLOAT);
+        }
+
+        // TexCoords
+        if(!geometry.texCoords.empty()) {
+          glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo[2]);
+          glBufferData(GL_ARRAY_BUFFER, geometry.texCoords.size() * sizeof(glm::vec2), geometry.texCoords.data(), GL_STATIC_DRAW);
+          mesh.vao.attribute(2, mesh.vbo[2], 2, GL_FLOAT);
+        }
+
+        // Indices (the element binding belongs to the bound vertex array)
+        glState().bindVertexArray(0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.vbo[3]);
+        mesh.type = glIndices::upload(geometry.indices);
+        mesh.vao.elements(mesh.vbo[3]);
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        glCheckError();
+
+        ++uploadedCounter;
+
+        return mesh;
+
+      }
+
+      //****************************************************************************/
+      // destroy() - free the buffers and the vertex arrays of a mesh
+      //****************************************************************************/
+      static void destroy(Mesh_t & mesh) {
+
+        if(mesh.vbo[0] == 0) return;
+
+        glDeleteBuffers(4, mesh.vbo);
+
+        mesh.vao.clear();
+
+        mesh = Mesh_t();
+
+      }
+
+      //****************************************************************************/
+      // size() - number of live shared meshes (all share groups)
+      //****************************************************************************/
+      static size_t size() { return meshes.size(); }
+
+      //****************************************************************************/
+      // getUploadedCount() - meshes uploaded to the GPU since startup
+      //****************************************************************************/
+      static uint32_t getUploadedCount() { return uploadedCounter; }
+
+  };
+
+  inline std::unordered_map<std::string, glGeometries::Mesh_t> glGeometries::meshes = std::unordered_map<std::string, glGeometries::Mesh_t>();
+  inline uint32_t glGeometries::uploadedCounter = 0;
+
+  //****************************************************************************/
+  // glSharedGeometry
+  //****************************************************************************/
+  // Reference an object holds on a glGeometries mesh of the current share
+  // group. acquire() gives back the reference held on a previous group first.
+  //****************************************************************************/
+  class glSharedGeometry {
+
+    private:
+
+      std::string key;
+
+      uint32_t shareGroup = 0;
+
+      glGeometries::Mesh_t * mesh = nullptr;
+
+    public:
+
+      //****************************************************************************/
+      // glSharedGeometry
+      //****************************************************************************/
+      glSharedGeometry() { }
+
+      //****************************************************************************/
+      // ~glSharedGeometry
+      //****************************************************************************/
+      ~glSharedGeometry() { release(); }
+
+      //****************************************************************************/
+      // A reference is owned by one object: moving transfers it
+      //****************************************************************************/
+      glSharedGeometry(const glSharedGeometry &) = delete;
+      glSharedGeometry & operator = (const glSharedGeometry &) = delete;
+
+      glSharedGeometry(glSharedGeometry && o) noexcept : key(std::move(o.key)), shareGroup(o.shareGroup), mesh(o.mesh) { o.mesh = nullptr; }
+
+      glSharedGeometry & operator = (glSharedGeometry && o) noexcept {
+        if(this != &o) {
+          release();
+          key        = std::move(o.key);
+          shareGroup = o.shareGroup;
+          mesh       = o.mesh;
+          o.mesh     = nullptr;
+        }
+        return *this;
+      }
+
+      //****************************************************************************/
+      // acquire() - reference the mesh of geometryKey in the current share group
+      //****************************************************************************/
+      template <class Builder>
+      void acquire(const std::string & geometryKey, Builder build) {
+
+        release();
+
+        key        = geometryKey;
+        shareGroup = glWindow::current()->getShareGroup();
+        mesh       = glGeometries::acquire(key, shareGroup, build);
+
+      }
+
+      //****************************************************************************/
+      // release() - give back the reference, if any
+      //****************************************************************************/
+      void release() {
+
+        if(mesh != nullptr) glGeometries::release(key, shareGroup);
+
+        mesh = nullptr;
+
+      }
+
+      //****************************************************************************/
+      // bind() - bind the vertex array of the mesh in the current context
+      //****************************************************************************/
+      inline void bind() { if(mesh != nullptr) mesh->vao.bind(); }
+
+      //****************************************************************************/
+      // getCount() - number of indices
+      //****************************************************************************/
+      inline GLsizei getCount() const { return (mesh != nullptr) ? mesh->count : 0; }
+
+      //****************************************************************************/
+      // getType() - type of the indices
+      //****************************************************************************/
+      inline GLenum getType() const { return (mesh != nullptr) ? mesh->type : GL_UNSIGNED_INT; }
+
+  };
+
+} /* namespace ogl */
+
+#endif /* _H_OGL_GLGEOMETRY_H_ */
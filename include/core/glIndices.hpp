@@ -0,0 +1,121 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _H_OGL_GLINDICES_H_
+#define _H_OGL_GLINDICES_H_
+
+
+#ifndef _H_OGL_H_
+  #error "Do not include this header directly; include <ogl/ogl.hpp> instead."
+#endif
+
+#include <cstdint>
+
+#include <vector>
+#include <algorithm>
+
+
+//****************************************************************************/
+// namespace ogl
+//****************************************************************************/
+namespace ogl {
+
+  //****************************************************************************/
+  // glIndices
+  //****************************************************************************/
+  // Index lists are built as GLuint and uploaded in the narrowest type that
+  // holds them: GL_UNSIGNED_SHORT when every index is below RESTART16 (kept
+  // free for primitive restart), GL_UNSIGNED_INT otherwise. Draw calls use
+  // the returned type and getSize() to turn an index offset into bytes.
+  //****************************************************************************/
+  class glIndices {
+
+  public:
+
+    static constexpr GLuint RESTART16 = 0xFFFF;
+    static constexpr GLuint RESTART32 = 0xFFFFFFFF;
+
+    //****************************************************************************/
+    // getType() - narrowest type of an index list
+    //****************************************************************************/
+    static GLenum getType(const GLuint * indices, std::size_t count) {
+
+      GLuint max = 0;
+
+      for(std::size_t i=0; i<count; ++i) if(indices[i] != RESTART32) max = std::max(max, indices[i]);
+
+      return (max < RESTART16) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
+    }
+
+    static GLenum getType(const std::vector<GLuint> & indices) { return getType(indices.data(), indices.size()); }
+
+    //****************************************************************************/
+    // getSize() - bytes of an index of a type
+    //****************************************************************************/
+    static inline std::size_t getSize(GLenum type) { return (type == GL_UNSIGNED_SHORT) ? sizeof(uint16_t) : sizeof(GLuint); }
+
+    //****************************************************************************/
+    // getRestart() - primitive restart index of a type
+    //****************************************************************************/
+    static inline GLuint getRestart(GLenum type) { return (type == GL_UNSIGNED_SHORT) ? RESTART16 : RESTART32; }
+
+    //****************************************************************************/
+    // upload() - fill the bound element buffer in the narrowest type, returns it
+    //****************************************************************************/
+    static GLenum upload(const std::vector<GLuint> & indices, GLenum usage = GL_STATIC_DRAW) {
+
+      GLenum type = getType(indices);
+
+      glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * getSize(type), nullptr, usage);
+
+      upload(type, indices.data(), indices.size(), 0);
+
+      return type;
+
+    }
+
+    //****************************************************************************/
+    // upload() - write count indices at byteOffset of the bound element buffer;
+    //            a RESTART32 index becomes the restart index of the type
+    //****************************************************************************/
+    static void upload(GLenum type, const GLuint * indices, std::size_t count, GLintptr byteOffset) {
+
+      if(count == 0) return;
+
+      if(type == GL_UNSIGNED_INT) {
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, byteOffset, count * sizeof(GLuint), indices);
+        return;
+      }
+
+      std::vector<uint16_t> narrow(count);
+
+      for(std::size_t i=0; i<count; ++i) narrow[i] = (indices[i] == RESTART32) ? (uint16_t) RESTART16 : (uint16_t) indices[i];
+
+      glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, byteOffset, count * sizeof(uint16_t), narrow.data());
+
+    }
+
+  };
+
+} /* namespace ogl */
+
+#endif /* _H_OGL_GLINDICES_H_ */
+
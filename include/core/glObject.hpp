@@ -41,7 +41,7 @@ namespace ogl {
   // Base class for every drawable. It holds the transform (TRS), a shader, and
   // the bookkeeping flags that drive the lazy GPU upload pattern:
   //   - isInited       : CPU-side data is ready (set by the subclass init/ctor)
-  //   - isInitedInGpu  : GPU buffers are uploaded for the current context
+  //   - isInitedInGpu  : GPU buffers are uploaded for the current share group
   //   - isToUpdateInGpu: data changed, buffers must be re-uploaded next frame
   //
   // On the first render() call, isToInitInGpu() returns true and initInGpu()
@@ -55,7 +55,7 @@ namespace ogl {
     
     std::string name;
     
-    uint32_t windowID;
+    uint32_t shareGroup;
     
     glShader shader;
     
@@ -89,7 +89,7 @@ namespace ogl {
       _rotation = glm::vec3(0.0);
       _scale    = glm::vec3(1.0);
 
-      windowID = 0;
+      shareGroup = 0;
 
       isInited        = false;
       isInitedInGpu   = false;
@@ -124,20 +124,20 @@ namespace ogl {
     // source will never delete the handles now owned by the destination.
     //***************************************************************************
     glObject(glObject && o) noexcept
-      : name(std::move(o.name)), windowID(o.windowID), shader(std::move(o.shader)),
+      : name(std::move(o.name)), shareGroup(o.shareGroup), shader(std::move(o.shader)),
         isInited(o.isInited), isInitedInGpu(o.isInitedInGpu), isToUpdateInGpu(o.isToUpdateInGpu),
         _position(o._position), _rotation(o._rotation), _scale(o._scale),
         modelMatrix(o.modelMatrix), style(o.style), lineWidth(o.lineWidth), color(o.color) {
       o.isInited        = false;
       o.isInitedInGpu   = false;
       o.isToUpdateInGpu = false;
-      o.windowID        = 0;
+      o.shareGroup      = 0;
     }
 
     glObject & operator = (glObject && o) noexcept {
       if(this != &o) {
         name            = std::move(o.name);
-        windowID        = o.windowID;
+        shareGroup      = o.shareGroup;
         shader          = std::move(o.shader);
         isInited        = o.isInited;
         isInitedInGpu   = o.isInitedInGpu;
@@ -152,7 +152,7 @@ namespace ogl {
         o.isInited        = false;
         o.isInitedInGpu   = false;
         o.isToUpdateInGpu = false;
-        o.windowID        = 0;
+        o.shareGroup      = 0;
       }
       return *this;
     }
@@ -162,7 +162,7 @@ namespace ogl {
     //****************************************************************************
     void initInGpu() {
       
-      windowID = ((glWindow*)glfwGetWindowUserPointer(glfwGetCurrentContext()))->id;
+      shareGroup = glWindow::current()->getShareGroup();
       
       DEBUG_LOG("glObject::initInGpu(" + name + ")");
       
@@ -247,6 +247,16 @@ namespace ogl {
 
     }
     
+    //****************************************************************************
+    // setInFrame - make the per-frame uniform block (projection, view, viewport)
+    // of the current window describe camera. Uploads only if it changed.
+    //****************************************************************************
+    inline void setInFrame(const glCamera & camera) const {
+
+      glWindow::current()->getFrame().setCamera(camera);
+
+    }
+
     //****************************************************************************
     // setInGpu
     //****************************************************************************
@@ -262,20 +272,22 @@ namespace ogl {
     //****************************************************************************
     void _setInGpu() {
       
-      windowID = ((glWindow*)glfwGetWindowUserPointer(glfwGetCurrentContext()))->id;
+      shareGroup = glWindow::current()->getShareGroup();
       
     }
     
     //****************************************************************************
     // isToInitInGpu - returns true when GPU buffers need to be (re-)uploaded.
-    // This happens on the very first render, when the context changes (different
-    // window), or when the caller sets isToUpdateInGpu after a data change.
+    // This happens on the very first render, when a context of another share
+    // group becomes current, or when the caller sets isToUpdateInGpu after a
+    // data change. The windows of a share group use the same buffers, only
+    // their vertex arrays differ (see glVertexArray).
     //****************************************************************************
     inline bool isToInitInGpu() {
 
       DEBUG_LOG("glObject::isToInitInGpu(" + name + ")");
 
-      if(windowID != ((glWindow*)glfwGetWindowUserPointer(glfwGetCurrentContext()))->id || !isInitedInGpu) {
+      if(shareGroup != glWindow::current()->getShareGroup() || !isInitedInGpu) {
         isInitedInGpu = false;
         return true;
       }
@@ -0,0 +1,514 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef _H_OGL_GLOCCLUSIONBUFFER_H_
+#define _H_OGL_GLOCCLUSIONBUFFER_H_
+
+
+#ifndef _H_OGL_H_
+  #error "Do not include this header directly; include <ogl/ogl.hpp> instead."
+#endif
+
+#include <cstdlib>
+#include <cstdio>
+#include <cstdint>
+#include <cfloat>
+#include <cmath>
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+
+#if defined(__AVX2__)
+  #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+  #include <emmintrin.h>
+#endif
+
+//****************************************************************************/
+// namespace ogl
+//****************************************************************************/
+namespace ogl {
+
+  //****************************************************************************/
+  // glOcclusionBuffer
+  //****************************************************************************/
+  // A small depth only software rasterizer, independent of the GPU and of its
+  // query latency. A frame goes:
+  //
+  //   buffer.begin(projection * view);
+  //   buffer.addOccluder(model, positions, stride, indices, count); // ...
+  //   buffer.rasterize();
+  //   if(buffer.isVisible(box, projection * view * model)) ...
+  //
+  // Occluders are transformed and clipped against the near plane as they are
+  // added; rasterize() fills the low resolution buffer in horizontal bands,
+  // one band per worker thread, 8 (AVX2) or 4 (SSE2) pixels at a time, or one
+  // with the scalar fallback. It then keeps the farthest depth of every
+  // 8 x 8 tile: isVisible() rejects whole tiles with it and only reads the
+  // pixels of the tiles it cannot decide. Depth is z / w mapped to [0, 1].
+  //
+  // Everything runs on the CPU: no GL context is needed.
+  //****************************************************************************/
+  class glOcclusionBuffer {
+
+  public:
+
+    static constexpr int TILE = 8;
+    static constexpr int BAND = 2 * TILE;
+
+  #if defined(__AVX2__)
+    static constexpr int LANES = 8;
+  #elif defined(__SSE2__) || defined(_M_X64)
+    static constexpr int LANES = 4;
+  #else
+    static constexpr int LANES = 1;
+  #endif
+
+  private:
+
+    // A triangle ready to scan: interior where the three edge functions
+    // a * x + b * y + c are >= 0, depth on the plane z = a * x + b * y + c.
+    struct Triangle_t {
+      float edges[3][3];
+      float depth[3];
+      int   minX, maxX, minY, maxY;
+    };
+
+    int width  = 0;
+    int height = 0;
+    int stride = 0;
+    int tilesX = 0;
+    int tilesY = 0;
+
+    std::vector<float> depth;
+    std::vector<float> tiles;
+
+    std::vector<Triangle_t> triangles;
+
+    glm::mat4 viewProjection = glm::mat4(1.0f);
+
+    unsigned threads = 0;
+
+  public:
+
+    //****************************************************************************/
+    // glOcclusionBuffer
+    //****************************************************************************/
+    glOcclusionBuffer(int _width = 256, int _height = 128) { resize(_width, _height); }
+
+    //****************************************************************************/
+    // resize() - the size is rounded up to whole tiles
+    //****************************************************************************/
+    void resize(int _width, int _height) {
+
+      if(_width <= 0 || _height <= 0) {
+        fprintf(stderr, "ERROR [glOcclusionBuffer]: size must be positive (%d x %d)\n", _width, _height);
+        abort();
+      }
+
+      tilesX = (_width  + TILE - 1) / TILE;
+      tilesY = (_height + BAND - 1) / BAND * (BAND / TILE);
+
+      width  = tilesX * TILE;
+      height = tilesY * TILE;
+      stride = width;
+
+      depth.assign((std::size_t) stride * height, 1.0f);
+      tiles.assign((std::size_t) tilesX * tilesY, 1.0f);
+
+    }
+
+    //****************************************************************************/
+    // setThreads() - workers of rasterize(), 0 for one per hardware thread
+    //****************************************************************************/
+    inline void setThreads(unsigned count) { threads = count; }
+
+    //****************************************************************************/
+    // begin() - start a frame seen through projection * view
+    //****************************************************************************/
+    void begin(const glm::mat4 & _viewProjection) {
+
+      viewProjection = _viewProjection;
+
+      triangles.clear();
+
+    }
+
+    //****************************************************************************/
+    // addOccluder() - queue the triangles of a mesh: count indices into
+    //                 positions (three floats every stride bytes), placed by
+    //                 the model matrix. Both faces occlude.
+    //****************************************************************************/
+    void addOccluder(const glm::mat4 & model, const float * positions, std::size_t stride, const GLuint * indices, std::size_t count) {
+
+      glm::mat4 clip = viewProjection * model;
+
+      const char * base = reinterpret_cast<const char *>(positions);
+
+      for(std::size_t i=0; i+2<count; i+=3) {
+
+        glm::vec4 vertices[3];
+
+        for(int k=0; k<3; ++k) {
+          const float * p = reinterpret_cast<const float *>(base + indices[i + k] * stride);
+          vertices[k] = clip * glm::vec4(p[0], p[1], p[2], 1.0f);
+        }
+
+        addTriangle(vertices);
+
+      }
+
+    }
+
+    //****************************************************************************/
+    // rasterize() - fill the depth of the queued occluders and its tiles
+    //****************************************************************************/
+    void rasterize() {
+
+      int bands = height / BAND;
+
+      unsigned workers = (threads > 0) ? threads : std::max(1u, std::thread::hardware_concurrency());
+
+      workers = std::min<unsigned>(workers, (unsigned) bands);
+
+      std::atomic<int> next(0);
+
+      auto worker = [&]() {
+        for(int band = next++; band < bands; band = next++) rasterizeBand(band);
+      };
+
+      std::vector<std::thread> pool;
+
+      for(unsigned i=1; i<workers; ++i) pool.emplace_back(worker);
+
+      worker();
+
+      for(std::size_t i=0; i<pool.size(); ++i) pool[i].join();
+
+    }
+
+    //****************************************************************************/
+    // isVisible() - false when the box, seen through clip (projection * view *
+    //               model), lies behind the occluders everywhere it covers.
+    //               A box crossing the near plane is always visible.
+    //****************************************************************************/
+    bool isVisible(const glAABB & box, const glm::mat4 & clip) const {
+
+      if(box.isEmpty()) return false;
+
+      float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+      float nearest = FLT_MAX;
+
+      for(int c=0; c<8; ++c) {
+
+        glm::vec4 corner = clip * glm::vec4((c & 1) ? box.max.x : box.min.x, (c & 2) ? box.max.y : box.min.y, (c & 4) ? box.max.z : box.min.z, 1.0f);
+
+        if(corner.w <= 0.0f || corner.z < -corner.w) return true;
+
+        float x = (corner.x / corner.w * 0.5f + 0.5f) * width;
+        float y = (corner.y / corner.w * 0.5f + 0.5f) * height;
+
+        minX = std::min(minX, x); maxX = std::max(maxX, x);
+        minY = std::min(minY, y); maxY = std::max(maxY, y);
+
+        nearest = std::min(nearest, corner.z / corner.w * 0.5f + 0.5f);
+
+      }
+
+      // the pixels whose center the box may cover, grown by one for safety
+      int x0 = std::max(0, (int) std::floor(minX) - 1), x1 = std::min(width  - 1, (int) std::ceil(maxX));
+      int y0 = std::max(0, (int) std::floor(minY) - 1), y1 = std::min(height - 1, (int) std::ceil(maxY));
+
+      if(x0 > x1 || y0 > y1) return false;
+
+      for(int ty = y0 / TILE; ty <= y1 / TILE; ++ty) {
+        for(int tx = x0 / TILE; tx <= x1 / TILE; ++tx) {
+
+          // the farthest occluder of the tile is in front of the box
+          if(tiles[ty * tilesX + tx] < nearest) continue;
+
+          int py1 = std::min(y1, ty * TILE + TILE - 1);
+          int px1 = std::min(x1, tx * TILE + TILE - 1);
+
+          for(int y = std::max(y0, ty * TILE); y <= py1; ++y) {
+            const float * row = &depth[(std::size_t) y * stride];
+            for(int x = std::max(x0, tx * TILE); x <= px1; ++x)
+              if(row[x] >= nearest) return true;
+          }
+
+        }
+      }
+
+      return false;
+
+    }
+
+    //****************************************************************************/
+    // getWidth() / getHeight() / getDepth() - the buffer, row by row from the bottom
+    //****************************************************************************/
+    inline int getWidth()  const { return width; }
+    inline int getHeight() const { return height; }
+    inline const std::vector<float> & getDepth() const { return depth; }
+
+    //****************************************************************************/
+    // getTrianglesCount() - Triangles queued since begin(), after clipping
+    //****************************************************************************/
+    inline std::size_t getTrianglesCount() const { return triangles.size(); }
+
+    //****************************************************************************/
+    // getInstructionSet() - the instructions of the scan loop
+    //****************************************************************************/
+    static const char * getInstructionSet() {
+      #if defined(__AVX2__)
+        return "AVX2";
+      #elif defined(__SSE2__) || defined(_M_X64)
+        return "SSE2";
+      #else
+        return "scalar";
+      #endif
+    }
+
+  private:
+
+    //****************************************************************************/
+    // addTriangle() - clip a triangle against the near plane (z >= -w) and
+    //                 queue the pieces in front of it
+    //****************************************************************************/
+    void addTriangle(const glm::vec4 vertices[3]) {
+
+      float distance[3];
+
+      int inside = 0;
+
+      for(int k=0; k<3; ++k) { distance[k] = vertices[k].z + vertices[k].w; if(distance[k] > 0.0f) ++inside; }
+
+      if(inside == 3) { setupTriangle(vertices[0], vertices[1], vertices[2]); return; }
+
+      if(inside == 0) return;
+
+      // Sutherland-Hodgman against one plane: at most four vertices
+      glm::vec4 polygon[4];
+
+      int size = 0;
+
+      for(int k=0; k<3; ++k) {
+
+        int n = (k + 1) % 3;
+
+        if(distance[k] > 0.0f) polygon[size++] = vertices[k];
+
+        if((distance[k] > 0.0f) != (distance[n] > 0.0f)) {
+          float t = distance[k] / (distance[k] - distance[n]);
+          polygon[size++] = vertices[k] + t * (vertices[n] - vertices[k]);
+        }
+
+      }
+
+      for(int k=1; k+1<size; ++k) setupTriangle(polygon[0], polygon[k], polygon[k + 1]);
+
+    }
+
+    //****************************************************************************/
+    // setupTriangle() - project a triangle in front of the near plane and
+    //                   compute its edge and depth planes
+    //****************************************************************************/
+    void setupTriangle(const glm::vec4 & a, const glm::vec4 & b, const glm::vec4 & c) {
+
+      const glm::vec4 * clip[3] = { &a, &b, &c };
+
+      float x[3], y[3], z[3];
+
+      for(int k=0; k<3; ++k) {
+        float w = std::max(clip[k]->w, 1e-6f);
+        x[k] = (clip[k]->x / w * 0.5f + 0.5f) * width;
+        y[k] = (clip[k]->y / w * 0.5f + 0.5f) * height;
+        z[k] =  clip[k]->z / w * 0.5f + 0.5f;
+      }
+
+      float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+
+      if(std::fabs(area) < 1e-8f) return;
+
+      Triangle_t triangle;
+
+      triangle.minX = std::max(0,          (int) std::floor(std::min(x[0], std::min(x[1], x[2]))));
+      triangle.maxX = std::min(width  - 1, (int) std::ceil (std::max(x[0], std::max(x[1], x[2]))));
+      triangle.minY = std::max(0,          (int) std::floor(std::min(y[0], std::min(y[1], y[2]))));
+      triangle.maxY = std::min(height - 1, (int) std::ceil (std::max(y[0], std::max(y[1], y[2]))));
+
+      if(triangle.minX > triangle.maxX || triangle.minY > triangle.maxY) return;
+
+      // both windings: the edges point inside
+      float sign = (area > 0.0f) ? 1.0f : -1.0f;
+
+      for(int k=0; k<3; ++k) {
+        int n = (k + 1) % 3;
+        triangle.edges[k][0] = sign * (y[k] - y[n]);
+        triangle.edges[k][1] = sign * (x[n] - x[k]);
+        triangle.edges[k][2] = sign * (x[k] * y[n] - y[k] * x[n]);
+      }
+
+      float dzdx = ((z[1] - z[0]) * (y[2] - y[0]) - (z[2] - z[0]) * (y[1] - y[0])) / area;
+      float dzdy = ((z[2] - z[0]) * (x[1] - x[0]) - (z[1] - z[0]) * (x[2] - x[0])) / area;
+
+      triangle.depth[0] = dzdx;
+      triangle.depth[1] = dzdy;
+      triangle.depth[2] = z[0] - dzdx * x[0] - dzdy * y[0];
+
+      triangles.push_back(triangle);
+
+    }
+
+    //****************************************************************************/
+    // rasterizeBand() - clear a band, scan every triangle crossing it and
+    //                   update the farthest depth of its tiles
+    //****************************************************************************/
+    void rasterizeBand(int band) {
+
+      int y0 = band * BAND;
+      int y1 = y0 + BAND - 1;
+
+      std::fill(depth.begin() + (std::size_t) y0 * stride, depth.begin() + (std::size_t) (y1 + 1) * stride, 1.0f);
+
+      for(std::size_t i=0; i<triangles.size(); ++i) {
+
+        const Triangle_t & triangle = triangles[i];
+
+        if(triangle.maxY < y0 || triangle.minY > y1) continue;
+
+        int rowFirst = std::max(y0, triangle.minY);
+        int rowLast  = std::min(y1, triangle.maxY);
+
+        int x0 = triangle.minX - triangle.minX % LANES;
+
+        for(int y=rowFirst; y<=rowLast; ++y) scanRow(&depth[(std::size_t) y * stride], x0, triangle.maxX, y + 0.5f, triangle);
+
+      }
+
+      for(int ty = y0 / TILE; ty <= y1 / TILE; ++ty) {
+
+        for(int tx=0; tx<tilesX; ++tx) {
+
+          float farthest = 0.0f;
+
+          for(int y = ty * TILE; y < ty * TILE + TILE; ++y) {
+            const float * row = &depth[(std::size_t) y * stride + tx * TILE];
+            for(int x=0; x<TILE; ++x) farthest = std::max(farthest, row[x]);
+          }
+
+          tiles[ty * tilesX + tx] = farthest;
+
+        }
+
+      }
+
+    }
+
+    //****************************************************************************/
+    // scanRow() - keep the nearest depth of the pixels of a row, from x0 (a
+    //             multiple of LANES) to x1, inside a triangle. A pixel is
+    //             inside when the sign bits of its three edge values are clear.
+    //****************************************************************************/
+    static void scanRow(float * row, int x0, int x1, float y, const Triangle_t & t) {
+
+      float c0 = t.edges[0][1] * y + t.edges[0][2];
+      float c1 = t.edges[1][1] * y + t.edges[1][2];
+      float c2 = t.edges[2][1] * y + t.edges[2][2];
+      float cz = t.depth[1]    * y + t.depth[2];
+
+    #if defined(__AVX2__)
+
+      const __m256 offsets = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+
+      __m256 a0 = _mm256_set1_ps(t.edges[0][0]), b0 = _mm256_set1_ps(c0);
+      __m256 a1 = _mm256_set1_ps(t.edges[1][0]), b1 = _mm256_set1_ps(c1);
+      __m256 a2 = _mm256_set1_ps(t.edges[2][0]), b2 = _mm256_set1_ps(c2);
+      __m256 az = _mm256_set1_ps(t.depth[0]),    bz = _mm256_set1_ps(cz);
+
+      for(int x=x0; x<=x1; x+=LANES) {
+
+        __m256 px = _mm256_add_ps(_mm256_set1_ps((float) x), offsets);
+
+        __m256 outside = _mm256_or_ps(_mm256_add_ps(_mm256_mul_ps(a0, px), b0),
+                         _mm256_or_ps(_mm256_add_ps(_mm256_mul_ps(a1, px), b1),
+                                      _mm256_add_ps(_mm256_mul_ps(a2, px), b2)));
+
+        __m256 current = _mm256_loadu_ps(row + x);
+        __m256 nearest = _mm256_min_ps(current, _mm256_add_ps(_mm256_mul_ps(az, px), bz));
+
+        _mm256_storeu_ps(row + x, _mm256_blendv_ps(nearest, current, outside));
+
+      }
+
+    #elif defined(__SSE2__) || defined(_M_X64)
+
+      const __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+
+      __m128 a0 = _mm_set1_ps(t.edges[0][0]), b0 = _mm_set1_ps(c0);
+      __m128 a1 = _mm_set1_ps(t.edges[1][0]), b1 = _mm_set1_ps(c1);
+      __m128 a2 = _mm_set1_ps(t.edges[2][0]), b2 = _mm_set1_ps(c2);
+      __m128 az = _mm_set1_ps(t.depth[0]),    bz = _mm_set1_ps(cz);
+
+      for(int x=x0; x<=x1; x+=LANES) {
+
+        __m128 px = _mm_add_ps(_mm_set1_ps((float) x), offsets);
+
+        __m128 outside = _mm_or_ps(_mm_add_ps(_mm_mul_ps(a0, px), b0),
+                         _mm_or_ps(_mm_add_ps(_mm_mul_ps(a1, px), b1),
+                                   _mm_add_ps(_mm_mul_ps(a2, px), b2)));
+
+        // no blendv in SSE2: spread the sign bit over the lane
+        __m128 mask = _mm_castsi128_ps(_mm_srai_epi32(_mm_castps_si128(outside), 31));
+
+        __m128 current = _mm_loadu_ps(row + x);
+        __m128 nearest = _mm_min_ps(current, _mm_add_ps(_mm_mul_ps(az, px), bz));
+
+        _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(mask, current), _mm_andnot_ps(mask, nearest)));
+
+      }
+
+    #else
+
+      for(int x=x0; x<=x1; ++x) {
+
+        float px = x + 0.5f;
+
+        float e0 = t.edges[0][0] * px + c0;
+        float e1 = t.edges[1][0] * px + c1;
+        float e2 = t.edges[2][0] * px + c2;
+
+        if(std::signbit(e0) || std::signbit(e1) || std::signbit(e2)) continue;
+
+        row[x] = std::min(row[x], t.depth[0] * px + cz);
+
+      }
+
+    #endif
+
+    }
+
+  };
+
+} /* namespace ogl */
+
+#endif /* _H_OGL_GLOCCLUSIONBUFFER_H_ */
@@ -0,0 +1,435 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _H_OGL_GLRENDERQUEUE_H_
+#define _H_OGL_GLRENDERQUEUE_H_
+
+
+#ifndef _H_OGL_H_
+  #error "Do not include this header directly; include <ogl/ogl.hpp> instead."
+#endif
+
+#include <cstdlib>
+#include <cstdio>
+#include <cstdint>
+
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <type_traits>
+#include <utility>
+
+//****************************************************************************/
+// namespace ogl
+//****************************************************************************/
+namespace ogl {
+
+  //****************************************************************************/
+  // glRenderQueue
+  //****************************************************************************/
+  // Objects are submitted every frame and drawn by render() sorted on a 64 bit
+  // key, so that objects sharing a program, a texture and a vertex array are
+  // drawn one after the other and the glStateCache can skip the rebinds:
+  //
+  //   OPAQUE      | pass | program | texture | vao | depth (front to back) |
+  //   TRANSPARENT | pass | depth (back to front) | program | texture | vao |
+  //   OVERLAY     | pass | submission order                                |
+  //
+  // Any glObject works unmodified: submit() stores a pointer and a thunk that
+  // calls its render(camera). The program, vertex array and texture of an
+  // object are not part of the glObject interface, so the queue learns them
+  // from the state cache after the object has been drawn once; the first
+  // frame an object is drawn it is sorted by program only. What is learned
+  // about an object is dropped the first render() it is not submitted to,
+  // so a destroyed object does not leave its state behind. The text the
+  // objects queued in the glTextBatch is drawn after the OVERLAY pass, with
+  // one call.
+  //
+  // With glWindow::setDepthPrePass(true) the opaque objects that can draw
+  // their depth alone (a renderDepth(camera) method: glModel and the SOLID
+  // glShape objects) do so first, with the color writes masked; their color
+  // pass then runs without depth writes and shades each pixel once. The
+  // pre-pass pays off with expensive fragments and high overdraw only:
+  // setTiming(true) measures both passes on the GPU (timer queries read a
+  // few frames later, never waited for).
+  //****************************************************************************/
+  class glRenderQueue {
+
+  public:
+
+    enum PASS { OPAQUE, TRANSPARENT, OVERLAY };
+
+    // Statistics of the last render()
+    struct Stats_t {
+      uint32_t objects        = 0;  // objects drawn
+      uint32_t programChanges = 0;  // consecutive objects with a different program
+      uint32_t textureChanges = 0;  // ... with a different texture
+      uint32_t vaoChanges     = 0;  // ... with a different vertex array
+      uint64_t issued         = 0;  // state calls sent to the driver (glStateCache)
+      uint64_t skipped        = 0;  // state calls skipped by the glStateCache
+      uint32_t prePassed      = 0;  // objects drawn in the depth pre-pass
+      float depthPassTime     = 0;  // GPU milliseconds of the pre-pass  (setTiming, a few frames old)
+      float colorPassTime     = 0;  // GPU milliseconds of the other draws (setTiming, a few frames old)
+    };
+
+  private:
+
+    // Submitted object
+    struct Item_t {
+      uint64_t key;
+      uint32_t order;
+      PASS pass;
+      void * object;
+      const glObject * base;
+      void (*draw)(void * object, const glCamera & camera);
+      void (*drawDepth)(void * object, const glCamera & camera);
+    };
+
+    // State an object was seen using
+    struct Learned_t {
+      GLuint program     = 0;
+      GLuint texture     = 0;
+      GLuint vertexArray = 0;
+      uint32_t render    = 0;  // last render() the object was drawn by
+    };
+
+    std::vector<Item_t> items;
+
+    std::unordered_map<const void *, Learned_t> learned;
+
+    uint32_t rendersCounter = 0;
+
+    bool isSorted = true;
+
+    Stats_t stats;
+
+    // Timer queries of the two passes, in a ring of frames, on one window
+    static constexpr int TIMER_FRAMES = 3;
+
+    bool isTiming = false;
+    uint32_t timerWindow = 0;
+    GLuint timers[TIMER_FRAMES][2] = { };
+    bool isTimerPending[TIMER_FRAMES] = { };
+    int timerFrame = 0;
+    float passTimes[2] = { 0.0f, 0.0f };
+
+  public:
+
+    //****************************************************************************/
+    // glRenderQueue
+    //****************************************************************************/
+    glRenderQueue() { }
+
+    //****************************************************************************/
+    // ~glRenderQueue
+    //****************************************************************************/
+    ~glRenderQueue() { releaseTimers(); }
+
+    //****************************************************************************/
+    // The timer queries belong to one queue
+    //****************************************************************************/
+    glRenderQueue(const glRenderQueue &) = delete;
+    glRenderQueue & operator = (const glRenderQueue &) = delete;
+
+    //****************************************************************************/
+    // submit() - queue an object for the next render()
+    //****************************************************************************/
+    template <class T>
+    void submit(T & object, PASS pass = OPAQUE) {
+
+      static_assert(std::is_base_of<glObject, T>::value, "glRenderQueue::submit() expects a glObject");
+
+      Item_t item;
+
+      item.key    = 0;
+      item.order  = (uint32_t)items.size();
+      item.pass   = pass;
+      item.object = &object;
+      item.base   = &object;
+      item.draw   = [](void * object, const glCamera & camera) { static_cast<T*>(object)->render(camera); };
+
+      item.drawDepth = depthThunk<T>(0);
+
+      items.push_back(item);
+
+    }
+
+    //****************************************************************************/
+    // render() - draw the submitted objects and empty the queue
+    //****************************************************************************/
+    void render(const glCamera & camera) {
+
+      glStateCache & state = glState();
+
+      uint64_t issued  = state.getIssuedCount();
+      uint64_t skipped = state.getSkippedCount();
+
+      stats = Stats_t();
+
+      ++rendersCounter;
+
+      if(isSorted) {
+
+        for(Item_t & item : items) item.key = key(item, camera);
+
+        std::sort(items.begin(), items.end(), [](const Item_t & a, const Item_t & b) {
+          return (a.key != b.key) ? a.key < b.key : a.order < b.order;
+        });
+
+      }
+
+      bool isPrePass = glWindow::current()->getDepthPrePass();
+
+      if(isTiming) beginTimer(0);
+
+      if(isPrePass) {
+
+        state.colorMask(GL_FALSE);
+
+        for(const Item_t & item : items) {
+          if(item.pass != OPAQUE || item.drawDepth == nullptr) continue;
+          item.drawDepth(item.object, camera);
+          ++stats.prePassed;
+        }
+
+        state.colorMask(GL_TRUE);
+
+      }
+
+      if(isTiming) { glEndQuery(GL_TIME_ELAPSED); beginTimer(1); }
+
+      Learned_t previous;
+
+      // depth writes are off for the objects whose depth is already there
+      bool isDepthMasked = false;
+
+      for(std::size_t i=0; i<items.size(); ++i) {
+
+        const Item_t & item = items[i];
+
+        bool isPrePassed = isPrePass && item.pass == OPAQUE && item.drawDepth != nullptr;
+
+        if(isPrePassed != isDepthMasked) { state.depthMask(isPrePassed ? GL_FALSE : GL_TRUE); isDepthMasked = isPrePassed; }
+
+        GLuint textureBefore = state.getTexture(0);
+
+        item.draw(item.object, camera);
+
+        Learned_t & current = learned[item.object];
+
+        current.program     = known(state.getProgram());
+        current.vertexArray = known(state.getVertexArray());
+        current.render      = rendersCounter;
+
+        // unit 0 keeps the texture of whoever used it last: only a change tells
+        // that this object binds one
+        if(state.getTexture(0) != textureBefore) current.texture = known(state.getTexture(0));
+
+        if(i > 0) {
+          if(current.program     != previous.program)     ++stats.programChanges;
+          if(current.texture     != previous.texture)     ++stats.textureChanges;
+          if(current.vertexArray != previous.vertexArray) ++stats.vaoChanges;
+        }
+
+        previous = current;
+
+      }
+
+      if(isDepthMasked) state.depthMask(GL_TRUE);
+
+      // the objects missing from this frame may be gone: a new object
+      // allocated at the same address would inherit their state (it only
+      // sorts, so at worst one frame is sorted on the state of the old one)
+      if(learned.size() > items.size()) {
+        for(auto it = learned.begin(); it != learned.end(); ) {
+          if(it->second.render != rendersCounter) it = learned.erase(it); else ++it;
+        }
+      }
+
+      // the text queued by the overlays (or any other object) closes the pass
+      glTextBatch::instance().flush(camera);
+
+      if(isTiming) {
+        glEndQuery(GL_TIME_ELAPSED);
+        isTimerPending[timerFrame] = true;
+        timerFrame = (timerFrame + 1) % TIMER_FRAMES;
+      }
+
+      stats.depthPassTime = passTimes[0];
+      stats.colorPassTime = passTimes[1];
+
+      stats.objects = (uint32_t)items.size();
+      stats.issued  = state.getIssuedCount()  - issued;
+      stats.skipped = state.getSkippedCount() - skipped;
+
+      items.clear();
+
+    }
+
+    //****************************************************************************/
+    // clear() - drop the submitted objects without drawing them
+    //****************************************************************************/
+    inline void clear() { items.clear(); }
+
+    //****************************************************************************/
+    // forget() - drop what was learned about the objects (e.g. after they have
+    //            been uploaded to another context)
+    //****************************************************************************/
+    inline void forget() { learned.clear(); }
+
+    //****************************************************************************/
+    // setSorted() - false draws in submission order (to measure the sorting)
+    //****************************************************************************/
+    inline void setSorted(bool value) { isSorted = value; }
+
+    //****************************************************************************/
+    // setTiming() - measure the GPU time of the passes (getStats())
+    //****************************************************************************/
+    inline void setTiming(bool value) { isTiming = value; }
+
+    //****************************************************************************/
+    // size() - objects waiting for render()
+    //****************************************************************************/
+    inline std::size_t size() const { return items.size(); }
+
+    //****************************************************************************/
+    // getStats() - statistics of the last render()
+    //****************************************************************************/
+    inline const Stats_t & getStats() const { return stats; }
+
+  private:
+
+    //****************************************************************************/
+    // depthThunk() - calls T::renderDepth(camera), nullptr when T has none
+    //****************************************************************************/
+    template <class T>
+    static auto depthThunk(int) -> decltype(std::declval<T&>().renderDepth(std::declval<const glCamera &>()), (void (*)(void *, const glCamera &)) nullptr) {
+      return [](void * object, const glCamera & camera) { static_cast<T*>(object)->renderDepth(camera); };
+    }
+
+    template <class T>
+    static void (*depthThunk(...))(void *, const glCamera &) { return nullptr; }
+
+    //****************************************************************************/
+    // beginTimer() - read the oldest frame of the ring if the GPU has it, then
+    //                start timing a pass of the current frame there
+    //****************************************************************************/
+    void beginTimer(int pass) {
+
+      uint32_t windowID = glWindow::current()->id;
+
+      // the queries live in the context of the window that made them
+      if(timers[0][0] == 0 || timerWindow != windowID) {
+        releaseTimers();
+        glGenQueries(2 * TIMER_FRAMES, &timers[0][0]);
+        timerWindow = windowID;
+      }
+
+      if(pass == 0 && isTimerPending[timerFrame]) {
+
+        GLuint available = 0;
+
+        glGetQueryObjectuiv(timers[timerFrame][1], GL_QUERY_RESULT_AVAILABLE, &available);
+
+        if(available) {
+          for(int k=0; k<2; ++k) {
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(timers[timerFrame][k], GL_QUERY_RESULT, &elapsed);
+            passTimes[k] = (float) (elapsed * 1e-6);
+          }
+        }
+
+        isTimerPending[timerFrame] = false;
+
+      }
+
+      glBeginQuery(GL_TIME_ELAPSED, timers[timerFrame][pass]);
+
+    }
+
+    //****************************************************************************/
+    // releaseTimers() - give the timer queries back to their window
+    //****************************************************************************/
+    void releaseTimers() {
+
+      if(timers[0][0] == 0) return;
+
+      glWindow * window = glWindow::find(timerWindow);
+
+      if(window != NULL) window->releaseQueries(std::vector<GLuint>(&timers[0][0], &timers[0][0] + 2 * TIMER_FRAMES));
+
+      for(int i=0; i<TIMER_FRAMES; ++i) { timers[i][0] = timers[i][1] = 0; isTimerPending[i] = false; }
+
+    }
+
+    //****************************************************************************/
+    // known() - a state the cache does not know counts as unbound
+    //****************************************************************************/
+    static inline GLuint known(GLuint value) { return (value == glStateCache::UNKNOWN) ? 0 : value; }
+
+    //****************************************************************************/
+    // field() - value truncated to bits and shifted in place
+    //****************************************************************************/
+    static inline uint64_t field(uint64_t value, int bits, int shift) { return (value & ((1ULL << bits) - 1)) << shift; }
+
+    //****************************************************************************/
+    // key() - sort key of an item
+    //****************************************************************************/
+    uint64_t key(const Item_t & item, const glCamera & camera) const {
+
+      uint64_t key = field(item.pass, 2, 62);
+
+      if(item.pass == OVERLAY) return key | item.order;
+
+      Learned_t state;
+
+      auto it = learned.find(item.object);
+
+      if(it != learned.end()) state = it->second;
+      else state.program = item.base->getShader().get();
+
+      // view space distance of the object origin, quantized on [zNear, zFar]
+      glm::vec4 position = camera.getView() * item.base->getModelMatrix() * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+
+      float range = camera.getzFar() - camera.getzNear();
+      float t = (range > 0.0f) ? (-position.z - camera.getzNear()) / range : 0.0f;
+
+      uint64_t depth = (uint64_t)(glm::clamp(t, 0.0f, 1.0f) * 16777215.0f);
+
+      if(item.pass == OPAQUE) {
+        key |= field(state.program,     12, 50);
+        key |= field(state.texture,     12, 38);
+        key |= field(state.vertexArray, 14, 24);
+        key |= field(depth,             24,  0);
+      } else {
+        key |= field(16777215 - depth,  24, 38);
+        key |= field(state.program,     12, 26);
+        key |= field(state.texture,     12, 14);
+        key |= field(state.vertexArray, 14,  0);
+      }
+
+      return key;
+
+    }
+
+  };
+
+} /* namespace ogl */
+
+#endif /* _H_OGL_GLRENDERQUEUE_H_ */
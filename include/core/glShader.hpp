@@ -29,6 +29,8 @@
 #include <cstdio>
 
 #include <string>
+#include <vector>
+#include <memory>
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -39,41 +41,449 @@
 //****************************************************************************/
 namespace ogl {
   
+  //****************************************************************************/
+  // glPrograms
+  //****************************************************************************/
+  // Process-wide registry of GLSL programs shared by every glShader.
+  // Sources are keyed by (stage paths, defines) and read from disk only once;
+  // linked programs are keyed by (source key, share group) and reference
+  // counted, so a thousand glSphere objects end up sharing a single "solid"
+  // program per share group (see glWindow) instead of compiling and linking
+  // their own copy.
+  // The uniform location cache lives with the program for the same reason.
+  //
+  // When the ogl::cache directory is enabled, linked programs are also saved
+  // as driver binaries (glGetProgramBinary) keyed by a hash of their sources
+  // and of the GL vendor/renderer/version strings; later runs reload them
+  // with glProgramBinary and fall back to a normal compile if the driver
+  // rejects the binary (e.g. after a driver update).
+  //****************************************************************************/
+  class glPrograms {
+
+    public:
+
+      struct Source_t {
+        std::string vertex;
+        std::string fragment;
+        std::string geometry;
+      };
+
+      struct Program_t {
+        GLuint id = 0;
+        uint32_t references = 0;
+        std::unordered_map<std::string, GLint> uniformLocations;
+      };
+
+    private:
+
+      static std::unordered_map<std::string, std::shared_ptr<const Source_t>> sources;
+
+      static std::unordered_map<std::string, Program_t> programs;
+
+      static uint32_t compiledCounter;
+      static uint32_t cachedCounter;
+
+      static std::string builtinDirectory;
+
+    public:
+
+      //****************************************************************************/
+      // setBuiltinDirectory() - load the built-in shaders from dir instead of the
+      // copy embedded in the library (shader development). An empty string goes
+      // back to the embedded sources. The OGL_SHADER_DIR environment variable
+      // sets the same override at startup.
+      //****************************************************************************/
+      static void setBuiltinDirectory(const std::string & dir) { builtinDirectory = dir; }
+      static const std::string & getBuiltinDirectory() { return builtinDirectory; }
+
+      //****************************************************************************/
+      // key() - registry key of a (vertex, fragment, geometry, defines) tuple
+      //****************************************************************************/
+      static std::string key(const std::string & vertexPath, const std::string & fragmentPath, const std::string & geometryPath, const std::string & defines) {
+        return vertexPath + '|' + fragmentPath + '|' + geometryPath + '|' + defines;
+      }
+
+      //****************************************************************************/
+      // load() - read (once) the sources of a program, defines already injected.
+      // The stage names are file paths, or the names of built-in shaders
+      // (e.g. "solid.vs") when isBuiltin is set.
+      //****************************************************************************/
+      static std::shared_ptr<const Source_t> load(const std::string & sourceKey, const std::string & vertexPath, const std::string & fragmentPath, const std::string & geometryPath, const std::string & defines, bool isBuiltin = false) {
+
+        auto it = sources.find(sourceKey);
+
+        if(it != sources.end()) return it->second;
+
+        DEBUG_LOG("glPrograms::load(" + sourceKey + ")");
+
+        std::shared_ptr<Source_t> source = std::make_shared<Source_t>();
+
+        source->vertex   = injectDefines(isBuiltin ? readBuiltin(vertexPath)   : readFile(vertexPath),   defines);
+        source->fragment = injectDefines(isBuiltin ? readBuiltin(fragmentPath) : readFile(fragmentPath), defines);
+
+        if(!geometryPath.empty()) source->geometry = injectDefines(isBuiltin ? readBuiltin(geometryPath) : readFile(geometryPath), defines);
+
+        sources[sourceKey] = source;
+
+        return source;
+
+      }
+
+      //****************************************************************************/
+      // acquire() - get the program of a source in a context, compiling it on
+      // the first request. The returned entry stays valid until release().
+      //****************************************************************************/
+      static Program_t * acquire(const std::string & sourceKey, const Source_t & source, uint32_t shareGroup) {
+
+        Program_t & program = programs[sourceKey + '@' + std::to_string(shareGroup)];
+
+        if(program.references++ == 0) {
+
+          DEBUG_LOG("glPrograms::acquire(" + sourceKey + ") compile on share group " + std::to_string(shareGroup));
+
+          program.id = compile(source);
+
+          glFrame::bindBlocks(program.id);
+
+          program.uniformLocations.clear();
+
+        }
+
+        return &program;
+
+      }
+
+      //****************************************************************************/
+      // release() - drop a reference, the program is deleted with the last one
+      //****************************************************************************/
+      static void release(const std::string & sourceKey, uint32_t shareGroup) {
+
+        auto it = programs.find(sourceKey + '@' + std::to_string(shareGroup));
+
+        if(it == programs.end()) return;
+
+        if(--it->second.references == 0) {
+
+          DEBUG_LOG("glPrograms::release(" + sourceKey + ") on share group " + std::to_string(shareGroup));
+
+          if(glfwGetCurrentContext() != NULL) glDeleteProgram(it->second.id);
+
+          programs.erase(it);
+
+        }
+
+      }
+
+      //****************************************************************************/
+      // size() - number of live programs (all contexts)
+      //****************************************************************************/
+      static size_t size() { return programs.size(); }
+
+      //****************************************************************************/
+      // getCompiledCount() / getCachedCount() - programs built from source and
+      // programs restored from the on-disk binary cache since startup
+      //****************************************************************************/
+      static uint32_t getCompiledCount() { return compiledCounter; }
+      static uint32_t getCachedCount()   { return cachedCounter;   }
+
+    private:
+
+      //****************************************************************************/
+      // readFile()
+      //****************************************************************************/
+      static std::string readFile(std::string path) {
+
+        ogl::io::expandPath(path);
+
+        std::ifstream file;
+
+        // ensures ifstream objects can throw exceptions:
+        file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+
+        std::stringstream stream;
+
+        try {
+
+          file.open(path.c_str());
+
+          stream << file.rdbuf();
+
+          file.close();
+
+        } catch (std::system_error & e) {
+          fprintf(stderr, "ERROR [glShader]: file '%s' not successfully read: %s\n", path.c_str(), strerror(errno));
+          abort();
+        }
+
+        return stream.str();
+
+      }
+
+      //****************************************************************************/
+      // readBuiltin()
+      //****************************************************************************/
+      static std::string readBuiltin(const std::string & name) {
+
+        const char * code = ogl::shaders::find(name.c_str());
+
+        if(code == NULL) {
+          fprintf(stderr, "ERROR [glShader]: unknown built-in shader '%s'\n", name.c_str());
+          abort();
+        }
+
+        return code;
+
+      }
+
+      //****************************************************************************/
+      // injectDefines() - the defines go right after the #version line
+      //****************************************************************************/
+      static std::string injectDefines(const std::string & code, const std::string & defines) {
+
+        if(defines.empty()) return code;
+
+        size_t pos = 0;
+
+        if(code.compare(0, 8, "#version") == 0) {
+          pos = code.find('\n');
+          pos = (pos == std::string::npos) ? code.size() : pos + 1;
+        }
+
+        return code.substr(0, pos) + defines + '\n' + code.substr(pos);
+
+      }
+
+      //****************************************************************************/
+      // compileStage()
+      //****************************************************************************/
+      static GLuint compileStage(GLenum type, const std::string & code, const char * stageName) {
+
+        const GLchar * shaderCode = code.c_str();
+
+        GLint success;
+        GLchar infoLog[512];
+
+        GLuint shader = glCreateShader(type);
+        glShaderSource(shader, 1, &shaderCode, NULL);
+        glCompileShader(shader);
+
+        // Print compile errors if any
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+
+        if(!success) {
+          glGetShaderInfoLog(shader, 512, NULL, infoLog);
+          fprintf(stderr, "ERROR [glShader]: %s shader compilation failed\n%s\n", stageName, infoLog);
+          abort();
+        }
+
+        return shader;
+
+      }
+
+      //****************************************************************************/
+      // BinaryHeader_t - header of a program binary cache entry
+      //****************************************************************************/
+      struct BinaryHeader_t {
+        char     magic[4];
+        uint32_t version;
+        uint32_t format;
+        uint32_t length;
+      };
+
+      //****************************************************************************/
+      // binaryKey() - sources + driver identification, so a driver update or a
+      // different GPU never picks up an incompatible binary
+      //****************************************************************************/
+      static uint64_t binaryKey(const Source_t & source) {
+
+        uint64_t key = ogl::cache::hash(source.vertex);
+
+        key = ogl::cache::hash(source.geometry, key);
+        key = ogl::cache::hash(source.fragment, key);
+
+        for(GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+          const GLubyte * str = glGetString(name);
+          key = ogl::cache::hash((str != NULL) ? (const char *) str : "", key);
+        }
+
+        return key;
+
+      }
+
+      //****************************************************************************/
+      // loadBinary() - restore a program from the cache, 0 on miss or rejection
+      //****************************************************************************/
+      static GLuint loadBinary(uint64_t key) {
+
+        std::vector<char> data;
+
+        if(!ogl::cache::load("program", key, data)) return 0;
+
+        BinaryHeader_t header;
+
+        if(data.size() < sizeof(header)) return 0;
+
+        memcpy(&header, data.data(), sizeof(header));
+
+        if(memcmp(header.magic, "OGLP", 4) != 0 || header.version != 1 || header.length != data.size() - sizeof(header)) return 0;
+
+        GLuint program = glCreateProgram();
+
+        glProgramBinary(program, header.format, data.data() + sizeof(header), header.length);
+
+        GLint success;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+
+        if(!success) {
+          DEBUG_LOG("glPrograms::loadBinary() binary rejected by the driver");
+          glDeleteProgram(program);
+          return 0;
+        }
+
+        return program;
+
+      }
+
+      //****************************************************************************/
+      // storeBinary() - save a linked program in the cache
+      //****************************************************************************/
+      static void storeBinary(uint64_t key, GLuint program) {
+
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+
+        if(length <= 0) return;
+
+        std::vector<char> data(sizeof(BinaryHeader_t) + length);
+
+        BinaryHeader_t header = { { 'O', 'G', 'L', 'P' }, 1, 0, (uint32_t) length };
+
+        GLenum format = 0;
+        glGetProgramBinary(program, length, NULL, &format, data.data() + sizeof(header));
+
+        header.format = format;
+
+        memcpy(data.data(), &header, sizeof(header));
+
+        if(!ogl::cache::store("program", key, data.data(), data.size()))
+          fprintf(stderr, "WARNING [glShader]: program binary not saved in the cache\n");
+
+      }
+
+      //****************************************************************************/
+      // compile() - compile and link a program from its sources, or restore it
+      // from the binary cache when enabled
+      //****************************************************************************/
+      static GLuint compile(const Source_t & source) {
+
+        GLint formats = 0;
+
+        if(ogl::cache::isEnabled()) glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+
+        bool isCacheable = (formats > 0);
+
+        uint64_t key = 0;
+
+        if(isCacheable) {
+
+          key = binaryKey(source);
+
+          GLuint program = loadBinary(key);
+
+          if(program != 0) { ++cachedCounter; return program; }
+
+        }
+
+        GLint success;
+        GLchar infoLog[512];
+
+        GLuint vertex   = compileStage(GL_VERTEX_SHADER,   source.vertex,   "vertex");
+        GLuint fragment = compileStage(GL_FRAGMENT_SHADER, source.fragment, "fragment");
+
+        // if geometry shader is given, compile geometry shader
+        GLuint geometry = 0;
+        if(!source.geometry.empty()) geometry = compileStage(GL_GEOMETRY_SHADER, source.geometry, "geometry");
+
+        // Shader Program
+        GLuint program = glCreateProgram();
+
+        glAttachShader(program, vertex);
+        glAttachShader(program, fragment);
+
+        if(geometry != 0) glAttachShader(program, geometry);
+
+        if(isCacheable) glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+        glLinkProgram(program);
+
+        // Print linking errors if any
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+
+        if(!success) {
+          glGetProgramInfoLog(program, 512, NULL, infoLog);
+          fprintf(stderr, "ERROR [glShader]: program linking failed\n%s\n", infoLog);
+          abort();
+        }
+
+        // Delete the shaders as they're linked into our program now and no longer necessery
+        glDeleteShader(vertex);
+        glDeleteShader(fragment);
+
+        if(geometry != 0) glDeleteShader(geometry);
+
+        if(isCacheable) storeBinary(key, program);
+
+        ++compiledCounter;
+
+        return program;
+
+      }
+
+  };
+
+  inline std::unordered_map<std::string, std::shared_ptr<const glPrograms::Source_t>> glPrograms::sources  = std::unordered_map<std::string, std::shared_ptr<const glPrograms::Source_t>>();
+  inline std::unordered_map<std::string, glPrograms::Program_t>                       glPrograms::programs = std::unordered_map<std::string, glPrograms::Program_t>();
+  inline uint32_t glPrograms::compiledCounter = 0;
+  inline uint32_t glPrograms::cachedCounter   = 0;
+  inline std::string glPrograms::builtinDirectory = (getenv("OGL_SHADER_DIR") != NULL) ? getenv("OGL_SHADER_DIR") : "";
+
   //****************************************************************************/
   // glShader
   //****************************************************************************/
-  // Manages a GLSL program (vertex + optional geometry + fragment).
-  // The source is loaded from disk at init() time; compilation and linking are
-  // deferred to the first use() call (when a GL context is guaranteed active).
-  // Each shader instance tracks the window it was compiled for; if the context
-  // changes, it recompiles automatically on the next use().
+  // Handle to a GLSL program (vertex + optional geometry + fragment) owned by
+  // the glPrograms registry. The presets (initSolid, initLine, ...) use the
+  // built-in shaders embedded in the library, init() loads arbitrary files.
+  // Both only resolve the (shared) sources;
+  // the program is acquired on the first use() call (when a GL context is
+  // guaranteed active). Each shader instance tracks the share group it was
+  // acquired for; if a context of another group becomes current, it acquires
+  // that group's program on the next use().
   //****************************************************************************/
   class glShader {
     
   private:
     
-    uint32_t windowID = 0;
+    uint32_t shareGroup = 0;
 
-    GLuint program = 0; // 0 is the OpenGL null handle (no program compiled yet)
+    GLuint program = 0; // 0 is the OpenGL null handle (no program acquired yet)
     
-    std::string vertexCode;
-    std::string fragmentCode;
-    std::string geometryCode;
+    // Registry key and shared sources of this shader
+    std::string sourceKey;
+    std::shared_ptr<const glPrograms::Source_t> source;
+    
+    // Registry entry of the acquired program. It also holds the uniform
+    // name -> location cache, shared by every shader using the same program:
+    // inactive uniforms are cached as -1 too, so they are skipped cheaply.
+    glPrograms::Program_t * shared = nullptr;
     
     bool isInited;
     bool isInitedInGpu;
 
     std::string name = "";
 
-    // Cache of uniform name -> location for the current program. Avoids a
-    // glGetUniformLocation (string hash + driver lookup) on every setUniform call.
-    // Inactive uniforms are cached as -1 too, so they are skipped cheaply.
-    // Invalidated whenever the program is (re)created.
-    mutable std::unordered_map<std::string, GLint> uniformLocationCache;
-
   public:
     
-    enum STYLE { SOLID, WIREFRAME, LINE, POINTS, TEXT, MODEL, PLAIN2D };
+    enum STYLE { SOLID, WIREFRAME, LINE, POINTS, TEXT, MODEL, PLAIN2D, DEPTH };
 
     int style;
     
@@ -81,44 +491,43 @@ namespace ogl {
     // glShader
     //****************************************************************************/
     glShader() : isInited(false), isInitedInGpu(false) { }
-    glShader(std::string vertexPath, std::string fragmentPath, std::string geometryPath = "") : isInitedInGpu(false) { init(vertexPath,fragmentPath, geometryPath); }
+    glShader(std::string vertexPath, std::string fragmentPath, std::string geometryPath = "", const std::string & defines = "") : isInited(false), isInitedInGpu(false) { init(vertexPath, fragmentPath, geometryPath, defines); }
     
     //****************************************************************************/
     // ~glShader
     //****************************************************************************/
-    ~glShader() { if(program != 0) glDeleteProgram(program); }
+    ~glShader() { release(); }
 
     //****************************************************************************/
-    // A shader owns a GL program handle, so it is non-copyable: copying would
-    // duplicate the handle and double-delete it. (glShader instances live as
-    // members of the non-copyable glObject, never in containers by value.)
+    // A shader holds a reference on a registry program, so it is non-copyable:
+    // copying would release the same reference twice. (glShader instances live
+    // as members of the non-copyable glObject, never in containers by value.)
     //****************************************************************************/
     glShader(const glShader &) = delete;
     glShader & operator = (const glShader &) = delete;
 
     glShader(glShader && o) noexcept
-      : windowID(o.windowID), program(o.program),
-        vertexCode(std::move(o.vertexCode)), fragmentCode(std::move(o.fragmentCode)),
-        geometryCode(std::move(o.geometryCode)),
+      : shareGroup(o.shareGroup), program(o.program),
+        sourceKey(std::move(o.sourceKey)), source(std::move(o.source)), shared(o.shared),
         isInited(o.isInited), isInitedInGpu(o.isInitedInGpu),
-        name(std::move(o.name)),
-        uniformLocationCache(std::move(o.uniformLocationCache)), style(o.style) {
+        name(std::move(o.name)), style(o.style) {
       o.program = 0;
+      o.shared  = nullptr;
+      o.isInitedInGpu = false;
     }
 
     glShader & operator = (glShader && o) noexcept {
       if(this != &o) {
-        if(program != 0) glDeleteProgram(program);
-        windowID     = o.windowID;
-        program      = o.program;      o.program = 0;
-        vertexCode   = std::move(o.vertexCode);
-        fragmentCode = std::move(o.fragmentCode);
-        geometryCode = std::move(o.geometryCode);
-        isInited     = o.isInited;
-        isInitedInGpu = o.isInitedInGpu;
-        name         = std::move(o.name);
-        uniformLocationCache = std::move(o.uniformLocationCache);
-        style        = o.style;
+        release();
+        shareGroup    = o.shareGroup;
+        program       = o.program;      o.program = 0;
+        sourceKey     = std::move(o.sourceKey);
+        source        = std::move(o.source);
+        shared        = o.shared;       o.shared  = nullptr;
+        isInited      = o.isInited;
+        isInitedInGpu = o.isInitedInGpu; o.isInitedInGpu = false;
+        name          = std::move(o.name);
+        style         = o.style;
       }
       return *this;
     }
@@ -126,16 +535,16 @@ namespace ogl {
     //****************************************************************************/
     // initModel
     //****************************************************************************/
-    void initModel() {
-      init("/usr/local/include/ogl/shader/model.vs", "/usr/local/include/ogl/shader/model.fs");
+    void initModel(const std::string & defines = "") {
+      initBuiltin("model.vs", "model.fs", "", defines);
       style = STYLE::MODEL;
     }
     
     //****************************************************************************/
     // initSolid
     //****************************************************************************/
-    void initSolid() {
-      init("/usr/local/include/ogl/shader/solid.vs", "/usr/local/include/ogl/shader/solid.fs");
+    void initSolid(const std::string & defines = "") {
+      initBuiltin("solid.vs", "solid.fs", "", defines);
       style = STYLE::SOLID;
     }
 
@@ -143,15 +552,15 @@ namespace ogl {
     // initPlain2D
     //****************************************************************************/
     void initPlain2D() {
-      init("/usr/local/include/ogl/shader/plain2D.vs", "/usr/local/include/ogl/shader/plain2D.fs");
+      initBuiltin("plain2D.vs", "plain2D.fs");
       style = STYLE::PLAIN2D;
     }
 
     //****************************************************************************/
     // initWireframe
     //****************************************************************************/
-    void initWireframe() {
-      init("/usr/local/include/ogl/shader/wireframe.vs", "/usr/local/include/ogl/shader/wireframe.fs", "/usr/local/include/ogl/shader/wireframe.gs");
+    void initWireframe(const std::string & defines = "") {
+      initBuiltin("wireframe.vs", "wireframe.fs", "wireframe.gs", defines);
       style = STYLE::WIREFRAME;
     }
 
@@ -159,7 +568,7 @@ namespace ogl {
     // initLine
     //****************************************************************************/
     void initLine() {
-      init("/usr/local/include/ogl/shader/line.vs", "/usr/local/include/ogl/shader/line.fs", "/usr/local/include/ogl/shader/line.gs");
+      initBuiltin("line.vs", "line.fs", "line.gs");
       style = STYLE::LINE;
     }
     
@@ -167,86 +576,72 @@ namespace ogl {
     // initPoints
     //****************************************************************************/
     void initPoints() {
-      init("/usr/local/include/ogl/shader/points.vs", "/usr/local/include/ogl/shader/points.fs");
+      initBuiltin("points.vs", "points.fs");
       style = STYLE::POINTS;
     }
     
     //****************************************************************************/
     // initText
     //****************************************************************************/
-    void initText() {
-      init("/usr/local/include/ogl/shader/text.vs", "/usr/local/include/ogl/shader/text.fs");
+    void initText(const std::string & defines = "") {
+      initBuiltin("text.vs", "text.fs", "", defines);
       style = STYLE::TEXT;
     }
+
+    //****************************************************************************/
+    // initDepth
+    //****************************************************************************/
+    void initDepth(const std::string & defines = "") {
+      initBuiltin("depth.vs", "depth.fs", "", defines);
+      style = STYLE::DEPTH;
+    }
     
     //****************************************************************************/
-    // init - Constructor generates the shader on the fly
+    // init - resolve the (shared) sources of the shader. The optional defines
+    // (e.g. "#define FOO 1") are injected right after the #version line and
+    // are part of the registry key, so every variant gets its own program.
     //****************************************************************************/
-    void init(std::string vertexPath, std::string fragmentPath, std::string geometryPath = "") {
+    void init(std::string vertexPath, std::string fragmentPath, std::string geometryPath = "", const std::string & defines = "") {
 
-      if(program != 0) {
-        glDeleteProgram(program);
-        program = 0;
-      }
-      uniformLocationCache.clear();
-      isInitedInGpu = false;
-
-      // 1. Retrieve the vertex/fragment source code from filePath
-      std::ifstream vShaderFile;
-      std::ifstream fShaderFile;
-      std::ifstream gShaderFile;
-      
-      // ensures ifstream objects can throw exceptions:
-      vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-      fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-      gShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+      release();
 
       // expand path file
       ogl::io::expandPath(vertexPath);
       ogl::io::expandPath(fragmentPath);
+      if(!geometryPath.empty()) ogl::io::expandPath(geometryPath);
 
-      try {
-        
-        // Open files
-        vShaderFile.open(vertexPath.c_str());
-        fShaderFile.open(fragmentPath.c_str());
-        
-        std::stringstream vShaderStream, fShaderStream;
+      sourceKey = glPrograms::key(vertexPath, fragmentPath, geometryPath, defines);
         
-        // Read file's buffer contents into streams
-        vShaderStream << vShaderFile.rdbuf();
-        fShaderStream << fShaderFile.rdbuf();
-        
-        // close file handlers
-        vShaderFile.close();
-        fShaderFile.close();
-        
-        // Convert stream into string
-        vertexCode   = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
-        
-        // if geometry shader path is present, also load a geometry shader
-        if(!geometryPath.empty()) {
-          
-          ogl::io::expandPath(geometryPath);
-
-          gShaderFile.open(geometryPath.c_str());
-          std::stringstream gShaderStream;
-          gShaderStream << gShaderFile.rdbuf();
-          gShaderFile.close();
-          geometryCode = gShaderStream.str();
-          
-        }
-        
-      } catch (std::system_error & e) {
-        fprintf(stderr, "ERROR [glShader]: file not successfully read: %s\n", strerror(errno));
-        abort();
-      }
+      source = glPrograms::load(sourceKey, vertexPath, fragmentPath, geometryPath, defines);
       
       isInited = true;
             
     }
     
+    //****************************************************************************/
+    // initBuiltin - like init() for the shaders shipped with the library: the
+    // sources come from the embedded table, or from the directory set with
+    // glPrograms::setBuiltinDirectory() when overridden.
+    //****************************************************************************/
+    void initBuiltin(const std::string & vertexName, const std::string & fragmentName, const std::string & geometryName = "", const std::string & defines = "") {
+
+      const std::string & dir = glPrograms::getBuiltinDirectory();
+
+      if(!dir.empty()) {
+        init(dir + '/' + vertexName, dir + '/' + fragmentName, geometryName.empty() ? "" : dir + '/' + geometryName, defines);
+        return;
+      }
+
+      release();
+
+      sourceKey = glPrograms::key("builtin:" + vertexName, fragmentName, geometryName, defines);
+
+      source = glPrograms::load(sourceKey, vertexName, fragmentName, geometryName, defines, true);
+
+      isInited = true;
+
+    }
+
     //****************************************************************************/
     // use() - use the current shader
     //****************************************************************************/
@@ -256,7 +651,7 @@ namespace ogl {
 
       if(isToInitInGpu()) initInGpu();
                  
-      glUseProgram(program);
+      glState().useProgram(program);
             
     }
     
@@ -288,103 +683,25 @@ namespace ogl {
     }
     
     //****************************************************************************/
-    // initInGpu
+    // initInGpu - acquire the program of the current context from the registry
     //****************************************************************************/
     void initInGpu() {
-    
-      windowID = ((glWindow*)glfwGetWindowUserPointer(glfwGetCurrentContext()))->id;
-
-      DEBUG_LOG("glShader::initInGpu(" + name + ") on windowID " + std::to_string(windowID));
 
       if(!isInited){
         fprintf(stderr, "ERROR [glShader]: must be initialized before uploading to GPU\n");
         abort();
       }
 
-      // Recompiling (e.g. after a context change): drop the previous program so
-      // its handle is not leaked, and invalidate the stale uniform locations.
-      if(program != 0) { glDeleteProgram(program); program = 0; }
-      uniformLocationCache.clear();
+      // Share group change: give back the reference held on the previous group
+      release();
 
-      const GLchar * vShaderCode = vertexCode.c_str();
-      const GLchar * fShaderCode = fragmentCode.c_str();
+      shareGroup = glWindow::current()->getShareGroup();
       
-      // 2. Compile shaders
-      GLuint vertex, fragment;
-      GLint success;
-      GLchar infoLog[512];
+      DEBUG_LOG("glShader::initInGpu(" + name + ") on share group " + std::to_string(shareGroup));
       
-      // Vertex Shader
-      vertex = glCreateShader(GL_VERTEX_SHADER);
-      glShaderSource(vertex, 1, &vShaderCode, NULL);
-      glCompileShader(vertex);
+      shared = glPrograms::acquire(sourceKey, *source, shareGroup);
       
-      // Print compile errors if any
-      glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
-      
-      if(!success) {
-        glGetShaderInfoLog( vertex, 512, NULL, infoLog );
-        fprintf(stderr, "ERROR [glShader]: vertex shader compilation failed\n%s\n", infoLog);
-        abort();
-      }
-            
-      // Fragment Shader
-      fragment = glCreateShader(GL_FRAGMENT_SHADER);
-      glShaderSource(fragment, 1, &fShaderCode, NULL);
-      glCompileShader(fragment);
-      
-      // Print compile errors if any
-      glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
-      
-      if(!success){
-        glGetShaderInfoLog(fragment, 512, NULL, infoLog);
-        fprintf(stderr, "ERROR [glShader]: fragment shader compilation failed\n%s\n", infoLog);
-        abort();
-      }
-            
-      // if geometry shader is given, compile geometry shader
-      GLuint geometry = 0;
-      if(!geometryCode.empty()) {
-
-        const GLchar * gShaderCode = geometryCode.c_str();
-
-        geometry = glCreateShader(GL_GEOMETRY_SHADER);
-        glShaderSource(geometry, 1, &gShaderCode, NULL);
-        glCompileShader(geometry);
-        glGetShaderiv(geometry, GL_COMPILE_STATUS, &success);
-         
-        if(!success) {
-          glGetShaderInfoLog(geometry, 512, NULL, infoLog);
-          fprintf(stderr, "ERROR [glShader]: geometry shader compilation failed\n%s\n", infoLog);
-          abort();
-        }
-                  
-      }
-       
-      // Shader Program
-      program = glCreateProgram();
-             
-      glAttachShader(program, vertex);
-      glAttachShader(program, fragment);
-       
-      if(!geometryCode.empty()) glAttachShader(program, geometry);
-       
-      glLinkProgram(program);
-             
-      // Print linking errors if any
-      glGetProgramiv(program, GL_LINK_STATUS, &success);
-       
-      if(!success) {
-        glGetProgramInfoLog(program, 512, NULL, infoLog);
-        fprintf(stderr, "ERROR [glShader]: program linking failed\n%s\n", infoLog);
-        abort();
-      }
-       
-      // Delete the shaders as they're linked into our program now and no longer necessery
-      glDeleteShader(vertex);
-      glDeleteShader(fragment);
-              
-      if(!geometryCode.empty()) glDeleteShader(geometry);
+      program = shared->id;
       
       isInitedInGpu = true;
             
@@ -397,6 +714,20 @@ namespace ogl {
     
   private:
 
+    //****************************************************************************/
+    // release() - give back the reference on the registry program, if any
+    //****************************************************************************/
+    inline void release() {
+
+      if(shared != nullptr) glPrograms::release(sourceKey, shareGroup);
+
+      shared  = nullptr;
+      program = 0;
+
+      isInitedInGpu = false;
+
+    }
+
     //****************************************************************************/
     // getUniformLocation - cached glGetUniformLocation. Misses (including
     // inactive uniforms, location == -1) are cached too, so a name is queried
@@ -404,11 +735,11 @@ namespace ogl {
     //****************************************************************************/
     inline GLint getUniformLocation(const std::string & uniformName) const {
 
-      auto it = uniformLocationCache.find(uniformName);
-      if(it != uniformLocationCache.end()) return it->second;
+      auto it = shared->uniformLocations.find(uniformName);
+      if(it != shared->uniformLocations.end()) return it->second;
 
       GLint location = glGetUniformLocation(program, uniformName.c_str());
-      uniformLocationCache[uniformName] = location;
+      shared->uniformLocations[uniformName] = location;
       return location;
 
     }
@@ -420,7 +751,7 @@ namespace ogl {
       
       DEBUG_LOG("glShader::isToInitInGpu(" + name + ")");
             
-      if(windowID != ((glWindow*)glfwGetWindowUserPointer(glfwGetCurrentContext()))->id || !isInitedInGpu) { return true; }
+      if(shareGroup != glWindow::current()->getShareGroup() || !isInitedInGpu) { return true; }
       
       return false;
       
@@ -434,6 +765,7 @@ namespace ogl {
     inline void setUniform(GLint location, const glm::vec4 & value) const { glUniform4fv(location, 1, &value[0]); }
 
     inline void setUniform(GLint location, const glm::vec2 & value) const { glUniform2fv(location, 1, &value[0]); }
+    inline void setUniform(GLint location, const glm::mat3 & value) const { glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(value)); }
     inline void setUniform(GLint location, const glm::mat4 & value) const { glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value)); }
     
   };
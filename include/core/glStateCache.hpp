@@ -0,0 +1,335 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _H_OGL_GLSTATECACHE_H_
+#define _H_OGL_GLSTATECACHE_H_
+
+
+#ifndef _H_OGL_H_
+  #error "Do not include this header directly; include <ogl/ogl.hpp> instead."
+#endif
+
+#include <cstdlib>
+#include <cstdio>
+#include <cstdint>
+
+//****************************************************************************/
+// namespace ogl
+//****************************************************************************/
+namespace ogl {
+
+  //****************************************************************************/
+  // glStateCache
+  //****************************************************************************/
+  // Shadow copy of the GL state the objects touch while drawing: capabilities,
+  // blend function, depth function/mask, color mask, polygon mode, cull face, program,
+  // vertex array and 2D texture bindings. Every setter compares the request
+  // with the value the context already has and issues the GL call only when it
+  // differs, so objects can state what they need on every draw without paying
+  // for redundant driver calls.
+  //
+  // Each glWindow owns one (the state belongs to its context). A value the
+  // cache has not seen yet is unknown and always issued. Code that changes the
+  // state behind the cache's back (raw GL calls in user code, third party
+  // renderers) must call invalidate(); glWindow::renderBegin() does it at the
+  // start of every frame.
+  //****************************************************************************/
+  class glStateCache {
+
+  public:
+
+    static constexpr GLuint UNKNOWN = 0xFFFFFFFF;
+
+  private:
+
+    // Capabilities tracked by enable()/disable(); any other is passed through.
+    static constexpr GLenum capabilities[] = {
+      GL_DEPTH_TEST, GL_CULL_FACE, GL_BLEND, GL_PROGRAM_POINT_SIZE, GL_MULTISAMPLE, GL_POLYGON_OFFSET_FILL,
+      GL_PRIMITIVE_RESTART
+    };
+
+    static constexpr int CAPABILITIES   = sizeof(capabilities) / sizeof(GLenum);
+    static constexpr int TEXTURE_UNITS  = 16;
+
+    // -1 unknown, 0 disabled, 1 enabled
+    int8_t enabled[CAPABILITIES];
+
+    GLenum blendSrc;
+    GLenum blendDst;
+    GLenum depthFunction;
+    GLuint depthWrite;
+    GLuint colorWrite;
+    GLenum polygon;
+    GLenum cull;
+
+    GLuint program;
+    GLuint vertexArray;
+
+    GLuint textureUnit;
+    GLuint textures[TEXTURE_UNITS];
+
+    uint64_t issuedCounter  = 0;
+    uint64_t skippedCounter = 0;
+
+  public:
+
+    //****************************************************************************/
+    // glStateCache
+    //****************************************************************************/
+    glStateCache() { invalidate(); }
+
+    //****************************************************************************/
+    // The cache mirrors the context of the window that owns it
+    //****************************************************************************/
+    glStateCache(const glStateCache &) = delete;
+    glStateCache & operator = (const glStateCache &) = delete;
+
+    //****************************************************************************/
+    // invalidate() - forget everything, the next request of each state is issued
+    //****************************************************************************/
+    void invalidate() {
+
+      for(int i=0; i<CAPABILITIES; ++i) enabled[i] = -1;
+
+      blendSrc      = UNKNOWN;
+      blendDst      = UNKNOWN;
+      depthFunction = UNKNOWN;
+      depthWrite    = UNKNOWN;
+      colorWrite    = UNKNOWN;
+      polygon       = UNKNOWN;
+      cull          = UNKNOWN;
+      program       = UNKNOWN;
+      vertexArray   = UNKNOWN;
+      textureUnit   = UNKNOWN;
+
+      for(int i=0; i<TEXTURE_UNITS; ++i) textures[i] = UNKNOWN;
+
+    }
+
+    //****************************************************************************/
+    // enable() / disable() - glEnable / glDisable
+    //****************************************************************************/
+    inline void enable (GLenum capability) { setEnabled(capability, true);  }
+    inline void disable(GLenum capability) { setEnabled(capability, false); }
+
+    inline void setEnabled(GLenum capability, bool value) {
+
+      int index = 0;
+
+      while(index < CAPABILITIES && capabilities[index] != capability) ++index;
+
+      if(index < CAPABILITIES) {
+        if(enabled[index] == (int8_t)value) { ++skippedCounter; return; }
+        enabled[index] = (int8_t)value;
+      }
+
+      if(value) glEnable(capability); else glDisable(capability);
+
+      ++issuedCounter;
+
+    }
+
+    //****************************************************************************/
+    // blendFunc() - glBlendFunc
+    //****************************************************************************/
+    inline void blendFunc(GLenum src, GLenum dst) {
+
+      if(blendSrc == src && blendDst == dst) { ++skippedCounter; return; }
+
+      glBlendFunc(src, dst);
+
+      blendSrc = src;
+      blendDst = dst;
+
+      ++issuedCounter;
+
+    }
+
+    //****************************************************************************/
+    // depthFunc() - glDepthFunc
+    //****************************************************************************/
+    inline void depthFunc(GLenum func) {
+
+      if(depthFunction == func) { ++skippedCounter; return; }
+
+      glDepthFunc(func);
+
+      depthFunction = func;
+
+      ++issuedCounter;
+
+    }
+
+    //****************************************************************************/
+    // depthMask() - glDepthMask
+    //****************************************************************************/
+    inline void depthMask(GLboolean flag) {
+
+      if(depthWrite == (GLuint)flag) { ++skippedCounter; return; }
+
+      glDepthMask(flag);
+
+      depthWrite = flag;
+
+      ++issuedCounter;
+
+    }
+
+    //****************************************************************************/
+    // colorMask() - glColorMask, the same flag for the four channels
+    //****************************************************************************/
+    inline void colorMask(GLboolean flag) {
+
+      if(colorWrite == (GLuint)flag) { ++skippedCounter; return; }
+
+      glColorMask(flag, flag, flag, flag);
+
+      colorWrite = flag;
+
+      ++issuedCounter;
+
+    }
+
+    //****************************************************************************/
+    // polygonMode() - glPolygonMode(GL_FRONT_AND_BACK, mode), the only face
+    //                 the core profile accepts
+    //****************************************************************************/
+    inline void polygonMode(GLenum mode) {
+
+      if(polygon == mode) { ++skippedCounter; return; }
+
+      glPolygonMode(GL_FRONT_AND_BACK, mode);
+
+      polygon = mode;
+
+      ++issuedCounter;
+
+    }
+
+    //****************************************************************************/
+    // cullFace() - glCullFace
+    //****************************************************************************/
+    inline void cullFace(GLenum mode) {
+
+      if(cull == mode) { ++skippedCounter; return; }
+
+      glCullFace(mode);
+
+      cull = mode;
+
+      ++issuedCounter;
+
+    }
+
+    //****************************************************************************/
+    // useProgram() - glUseProgram
+    //****************************************************************************/
+    inline void useProgram(GLuint id) {
+
+      if(program == id) { ++skippedCounter; return; }
+
+      glUseProgram(id);
+
+      program = id;
+
+      ++issuedCounter;
+
+    }
+
+    //****************************************************************************/
+    // bindVertexArray() - glBindVertexArray
+    //****************************************************************************/
+    inline void bindVertexArray(GLuint id) {
+
+      if(vertexArray == id) { ++skippedCounter; return; }
+
+      glBindVertexArray(id);
+
+      vertexArray = id;
+
+      ++issuedCounter;
+
+    }
+
+    //****************************************************************************/
+    // activeTexture() - glActiveTexture(GL_TEXTURE0 + unit)
+    //****************************************************************************/
+    inline void activeTexture(GLuint unit) {
+
+      if(textureUnit == unit) { ++skippedCounter; return; }
+
+      glActiveTexture(GL_TEXTURE0 + unit);
+
+      textureUnit = unit;
+
+      ++issuedCounter;
+
+    }
+
+    //****************************************************************************/
+    // bindTexture() - glBindTexture(GL_TEXTURE_2D, id) on a texture unit
+    //****************************************************************************/
+    inline void bindTexture(GLuint unit, GLuint id) {
+
+      if(unit < TEXTURE_UNITS && textures[unit] == id) { ++skippedCounter; return; }
+
+      activeTexture(unit);
+
+      glBindTexture(GL_TEXTURE_2D, id);
+
+      if(unit < TEXTURE_UNITS) textures[unit] = id;
+
+      ++issuedCounter;
+
+    }
+
+    //****************************************************************************/
+    // forgetTexture() - call before glDeleteTextures: the name may come back
+    //                   from the next glGenTextures, so the units holding it
+    //                   must not skip that bind
+    //****************************************************************************/
+    inline void forgetTexture(GLuint id) {
+      for(int i=0; i<TEXTURE_UNITS; ++i) if(textures[i] == id) textures[i] = UNKNOWN;
+    }
+
+    //****************************************************************************/
+    // get() - what the cache believes is bound (0xFFFFFFFF when unknown)
+    //****************************************************************************/
+    inline GLuint getProgram()     const { return program;     }
+    inline GLuint getVertexArray() const { return vertexArray; }
+    inline GLuint getTexture(GLuint unit) const { return (unit < TEXTURE_UNITS) ? textures[unit] : UNKNOWN; }
+    inline GLuint getDepthMask()   const { return depthWrite;  }
+    inline GLuint getColorMask()   const { return colorWrite;  }
+
+    //****************************************************************************/
+    // getIssuedCount() / getSkippedCount() - calls sent to / saved from the driver
+    //****************************************************************************/
+    inline uint64_t getIssuedCount()  const { return issuedCounter;  }
+    inline uint64_t getSkippedCount() const { return skippedCounter; }
+
+    //****************************************************************************/
+    // resetCounters()
+    //****************************************************************************/
+    inline void resetCounters() { issuedCounter = 0; skippedCounter = 0; }
+
+  };
+
+} /* namespace ogl */
+
+#endif /* _H_OGL_GLSTATECACHE_H_ */
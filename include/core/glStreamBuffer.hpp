@@ -0,0 +1,371 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _H_OGL_GLSTREAMBUFFER_H_
+#define _H_OGL_GLSTREAMBUFFER_H_
+
+
+#ifndef _H_OGL_H_
+  #error "Do not include this header directly; include <ogl/ogl.hpp> instead."
+#endif
+
+#include <cstdlib>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+
+#include <string>
+
+#ifndef GL_MAP_PERSISTENT_BIT
+  #define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+
+#ifndef GL_MAP_COHERENT_BIT
+  #define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+//****************************************************************************/
+// namespace ogl
+//****************************************************************************/
+namespace ogl {
+
+  //****************************************************************************/
+  // glStreamBuffer
+  //****************************************************************************/
+  // One vertex buffer, shared by every window of the share group, from which
+  // the objects whose vertices change every frame (text, updated lines and
+  // points) suballocate what they draw instead of owning a small buffer each
+  // and updating it with glBufferSubData() or glBufferData().
+  //
+  // The buffer is split in three regions used in turn, one per frame:
+  // glWindow::renderEnd() calls endFrame(), which puts a fence after the draws
+  // of the region just filled and moves to the next one. The CPU writes a
+  // region again only once its fence says the GPU is done with it (a frame
+  // needing more than a region moves to the next one early).
+  //
+  // When the driver has ARB_buffer_storage (GL 4.4; glad only loads 4.1, so
+  // glBufferStorage is looked up at runtime) the buffer is mapped once,
+  // persistent and coherent, and upload() is a memcpy. Otherwise every upload
+  // maps its range UNSYNCHRONIZED, safe because the buffer is orphaned before
+  // a region is reused: no fence is needed.
+  //
+  // upload() aligns the data on its vertex size and returns the index of its
+  // first vertex, so an object keeps the buffer at offset 0 in its vertex
+  // array (described once) and passes that index to the draw call.
+  //****************************************************************************/
+  class glStreamBuffer {
+
+  public:
+
+    static constexpr int REGIONS = 3;
+
+    // initial size of a region, doubled when an upload does not fit
+    static constexpr GLsizeiptr REGION_SIZE = 1 << 20;
+
+  private:
+
+    typedef void (GLAD_API_PTR * PFNGLBUFFERSTORAGEPROC_t)(GLenum target, GLsizeiptr size, const void * data, GLbitfield flags);
+
+    PFNGLBUFFERSTORAGEPROC_t bufferStorage = nullptr;
+
+    GLuint buffer = 0;
+
+    GLsizeiptr regionSize = REGION_SIZE;
+
+    bool isPersistent = false;
+
+    uint8_t * mapped = nullptr;
+
+    GLsync fences[REGIONS] = { };
+
+    int region = 0;
+
+    // first free byte of the current region
+    GLsizeiptr head = 0;
+
+    GLsizeiptr frameBytes = 0;
+    GLsizeiptr lastFrameBytes = 0;
+
+    uint32_t stallsCounter = 0;
+
+    glStreamBuffer() { }
+
+  public:
+
+    //****************************************************************************/
+    // instance() - the stream buffer of the share group
+    //****************************************************************************/
+    static glStreamBuffer & instance() {
+      static glStreamBuffer instance;
+      return instance;
+    }
+
+    glStreamBuffer(const glStreamBuffer &) = delete;
+    glStreamBuffer & operator = (const glStreamBuffer &) = delete;
+
+    //****************************************************************************/
+    // getBuffer() - the buffer to describe in the vertex arrays, created on the
+    // first request. It changes when the buffer grows.
+    //****************************************************************************/
+    GLuint getBuffer() {
+
+      if(buffer == 0) initInGpu();
+
+      return buffer;
+
+    }
+
+    //****************************************************************************/
+    // upload() - copy 'size' bytes of vertices 'stride' bytes each in the
+    // current region and return the index of the first one. The data is valid
+    // for the draws of the current frame only.
+    //****************************************************************************/
+    GLint upload(const void * data, GLsizeiptr size, GLsizei stride) {
+
+      if(buffer == 0) initInGpu();
+
+      // a vertex size larger than the regions, or data that would not fit even
+      // in an empty one
+      if(size + stride > regionSize) {
+        GLsizeiptr newSize = regionSize;
+        while(size + stride > newSize) newSize *= 2;
+        grow(newSize);
+      }
+
+      GLsizeiptr offset = align(region * regionSize + head, stride);
+
+      if(offset + size > (region + 1) * regionSize) {
+        next();
+        offset = align(region * regionSize, stride);
+      }
+
+      if(isPersistent) {
+
+        memcpy(mapped + offset, data, size);
+
+      } else {
+
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+        void * range = glMapBufferRange(GL_ARRAY_BUFFER, offset, size, GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+
+        if(range == NULL) {
+          fprintf(stderr, "ERROR [glStreamBuffer]: glMapBufferRange failed\n");
+          abort();
+        }
+
+        memcpy(range, data, size);
+
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+      }
+
+      head = offset + size - region * regionSize;
+
+      frameBytes += size;
+
+      return (GLint)(offset / stride);
+
+    }
+
+    //****************************************************************************/
+    // endFrame() - fence the draws of the current region and move to the next
+    //****************************************************************************/
+    void endFrame() {
+
+      lastFrameBytes = frameBytes;
+      frameBytes = 0;
+
+      if(buffer == 0 || head == 0) return;
+
+      next();
+
+    }
+
+    //****************************************************************************/
+    // cleanInGpu() - a context of the share group must be current
+    //****************************************************************************/
+    void cleanInGpu() {
+
+      if(buffer == 0) return;
+
+      DEBUG_LOG("glStreamBuffer::cleanInGpu()");
+
+      for(GLsync & fence : fences) {
+        if(fence != 0) glDeleteSync(fence);
+        fence = 0;
+      }
+
+      if(mapped != nullptr) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        mapped = nullptr;
+      }
+
+      glDeleteBuffers(1, &buffer);
+
+      buffer = 0;
+
+      region = 0;
+      head   = 0;
+
+    }
+
+    //****************************************************************************/
+    // isPersistentMapped() - whether the buffer uses ARB_buffer_storage
+    //****************************************************************************/
+    inline bool isPersistentMapped() const { return isPersistent; }
+
+    //****************************************************************************/
+    // getFrameBytes() - bytes uploaded in the last complete frame
+    //****************************************************************************/
+    inline GLsizeiptr getFrameBytes() const { return lastFrameBytes; }
+
+    //****************************************************************************/
+    // getSize() - size of the buffer, all regions
+    //****************************************************************************/
+    inline GLsizeiptr getSize() const { return REGIONS * regionSize; }
+
+    //****************************************************************************/
+    // getStallsCount() - times the CPU waited for the GPU to free a region
+    //****************************************************************************/
+    inline uint32_t getStallsCount() const { return stallsCounter; }
+
+  private:
+
+    //****************************************************************************/
+    // initInGpu() - create the buffer, persistent mapped if the driver can
+    //****************************************************************************/
+    void initInGpu() {
+
+      DEBUG_LOG("glStreamBuffer::initInGpu()");
+
+      if(bufferStorage == nullptr && glfwExtensionSupported("GL_ARB_buffer_storage"))
+        bufferStorage = (PFNGLBUFFERSTORAGEPROC_t) glfwGetProcAddress("glBufferStorage");
+
+      isPersistent = (bufferStorage != nullptr);
+
+      glGenBuffers(1, &buffer);
+      glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+      if(isPersistent) {
+
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+        bufferStorage(GL_ARRAY_BUFFER, REGIONS * regionSize, NULL, flags);
+
+        mapped = (uint8_t *) glMapBufferRange(GL_ARRAY_BUFFER, 0, REGIONS * regionSize, flags);
+
+        if(mapped == nullptr) {
+          fprintf(stderr, "ERROR [glStreamBuffer]: persistent mapping failed\n");
+          abort();
+        }
+
+      } else {
+
+        glBufferData(GL_ARRAY_BUFFER, REGIONS * regionSize, NULL, GL_STREAM_DRAW);
+
+      }
+
+      glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+      region = 0;
+      head   = 0;
+
+      glCheckError();
+
+    }
+
+    //****************************************************************************/
+    // grow() - replace the buffer with a larger one. The draws already issued
+    // keep the old one alive until they are done.
+    //****************************************************************************/
+    void grow(GLsizeiptr size) {
+
+      DEBUG_LOG("glStreamBuffer::grow() " + std::to_string(size));
+
+      cleanInGpu();
+
+      regionSize = size;
+
+      initInGpu();
+
+    }
+
+    //****************************************************************************/
+    // next() - fence the current region and wait until the next one is free
+    //****************************************************************************/
+    void next() {
+
+      if(isPersistent) {
+
+        if(fences[region] != 0) glDeleteSync(fences[region]);
+
+        fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+      }
+
+      region = (region + 1) % REGIONS;
+
+      head = 0;
+
+      if(isPersistent) {
+
+        if(fences[region] != 0) {
+
+          GLenum status = glClientWaitSync(fences[region], GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+
+          if(status == GL_TIMEOUT_EXPIRED) {
+            ++stallsCounter;
+            do { status = glClientWaitSync(fences[region], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); } while(status == GL_TIMEOUT_EXPIRED);
+          }
+
+          glDeleteSync(fences[region]);
+
+          fences[region] = 0;
+
+        }
+
+      } else if(region == 0) {
+
+        // the draws in flight keep the old storage
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER, REGIONS * regionSize, NULL, GL_STREAM_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+      }
+
+    }
+
+    //****************************************************************************/
+    // align() - round offset up to a multiple of stride
+    //****************************************************************************/
+    static inline GLsizeiptr align(GLsizeiptr offset, GLsizei stride) {
+      return ((offset + stride - 1) / stride) * stride;
+    }
+
+  };
+
+} /* namespace ogl */
+
+#endif /* _H_OGL_GLSTREAMBUFFER_H_ */
@@ -0,0 +1,224 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _H_OGL_GLTEXTBATCH_H_
+#define _H_OGL_GLTEXTBATCH_H_
+
+
+#ifndef _H_OGL_H_
+  #error "Do not include this header directly; include <ogl/ogl.hpp> instead."
+#endif
+
+#include <cstdlib>
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+
+#include <string>
+#include <vector>
+
+//****************************************************************************/
+// namespace ogl
+//****************************************************************************/
+namespace ogl {
+
+  //****************************************************************************/
+  // glTextBatch
+  //****************************************************************************/
+  // The glyphs of every text object drawn in a frame, in one vertex stream.
+  // With glWindow::setTextBatching(true), the default, glPrint2D and
+  // glPrint3D (and through them the labels of glPlot) do not draw: render()
+  // lays out the string with glFont and appends its quads here, each vertex
+  // carrying its screen position, atlas coordinates and color. The queue of
+  // a window is drawn with a single call, in the OGL_TEXT_BATCH variant of
+  // the text shader, at the end of the OVERLAY pass of a glRenderQueue and in
+  // any case by glWindow::renderEnd().
+  //
+  // The text is an overlay: it is drawn after the scene, blended and without
+  // depth test, in the order it was rendered.
+  //****************************************************************************/
+  class glTextBatch {
+
+  public:
+
+    struct Vertex_t {
+      glm::vec4 vertex;   // x, y, u, v
+      uint32_t  color;    // RGBA, 8 bits each
+    };
+
+  private:
+
+    // queued glyphs of a window
+    struct Queue_t {
+      uint32_t windowID;
+      std::vector<Vertex_t> vertices;
+    };
+
+    std::vector<Queue_t> queues;
+
+    glShader shader;
+
+    // glFont mode the shader was built for
+    int atlasMode = -1;
+
+    glVertexArray vao;
+
+    uint32_t drawCallsCounter = 0;
+    uint32_t glyphsCounter    = 0;
+
+    glTextBatch() {
+
+      shader.setName("glTextBatch");
+
+      glWindow::renderDeferred = [](glWindow & window) { instance().flush(window.getCamera()); };
+
+    }
+
+  public:
+
+    //****************************************************************************/
+    // instance() - the text batch of the process (one queue per window)
+    //****************************************************************************/
+    static glTextBatch & instance() {
+      static glTextBatch instance;
+      return instance;
+    }
+
+    glTextBatch(const glTextBatch &) = delete;
+    glTextBatch & operator = (const glTextBatch &) = delete;
+
+    //****************************************************************************/
+    // add() - queue quads built by glFont::layout() in the current window
+    //****************************************************************************/
+    void add(const std::vector<glm::vec4> & quads, const glm::vec4 & color) {
+
+      std::vector<Vertex_t> & vertices = getQueue().vertices;
+
+      uint32_t packed = pack(color);
+
+      // no reserve() here: it would grow the queue to the exact size at every
+      // string; push_back() grows it geometrically and clear() in flush()
+      // keeps the capacity for the next frames
+      for(const glm::vec4 & quad : quads) vertices.push_back({ quad, packed });
+
+    }
+
+    //****************************************************************************/
+    // flush() - draw the glyphs queued in the current window
+    //****************************************************************************/
+    void flush(const glCamera & camera) {
+
+      std::vector<Vertex_t> & vertices = getQueue().vertices;
+
+      if(vertices.empty()) return;
+
+      DEBUG_LOG("glTextBatch::flush() " + std::to_string(vertices.size() / 6) + " glyphs");
+
+      glStreamBuffer & stream = glStreamBuffer::instance();
+
+      GLint first = stream.upload(vertices.data(), vertices.size() * sizeof(Vertex_t), sizeof(Vertex_t));
+
+      vao.attribute(0, stream.getBuffer(), 4, GL_FLOAT,         GL_FALSE, sizeof(Vertex_t), offsetof(Vertex_t, vertex));
+      vao.attribute(1, stream.getBuffer(), 4, GL_UNSIGNED_BYTE, GL_TRUE,  sizeof(Vertex_t), offsetof(Vertex_t, color));
+
+      if(atlasMode != glFont::instance().getMode()) {
+        atlasMode = glFont::instance().getMode();
+        shader.initText(std::string("#define OGL_TEXT_BATCH\n") + glFont::instance().getDefines());
+      }
+
+      shader.use();
+
+      glWindow::current()->getFrame().setCamera(camera);
+
+      glStateCache & state = glState();
+
+      state.disable(GL_CULL_FACE);
+      state.disable(GL_DEPTH_TEST);
+      state.depthMask(GL_FALSE);
+
+      state.enable(GL_BLEND);
+      state.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+      state.polygonMode(GL_FILL);
+
+      state.activeTexture(0);
+      state.bindTexture(0, glFont::instance().getTexture());
+
+      vao.bind();
+
+      glDrawArrays(GL_TRIANGLES, first, (GLsizei)vertices.size());
+
+      state.depthMask(GL_TRUE);
+      state.enable(GL_DEPTH_TEST);
+
+      ++drawCallsCounter;
+      glyphsCounter += (uint32_t)(vertices.size() / 6);
+
+      glFont::instance().countDraw(vertices.size());
+
+      vertices.clear();
+
+      glCheckError();
+
+    }
+
+    //****************************************************************************/
+    // getDrawCallsCount() - draws issued by flush() since startup
+    //****************************************************************************/
+    inline uint32_t getDrawCallsCount() const { return drawCallsCounter; }
+
+    //****************************************************************************/
+    // getGlyphsCount() - glyphs drawn by flush() since startup
+    //****************************************************************************/
+    inline uint32_t getGlyphsCount() const { return glyphsCounter; }
+
+  private:
+
+    //****************************************************************************/
+    // getQueue() - queue of the current window
+    //****************************************************************************/
+    Queue_t & getQueue() {
+
+      uint32_t windowID = glWindow::current()->id;
+
+      for(Queue_t & queue : queues) if(queue.windowID == windowID) return queue;
+
+      queues.push_back({ windowID, { } });
+
+      return queues.back();
+
+    }
+
+    //****************************************************************************/
+    // pack() - RGBA 8 bits each, red in the lowest byte
+    //****************************************************************************/
+    static inline uint32_t pack(const glm::vec4 & color) {
+
+      glm::vec4 c = glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f;
+
+      return (uint32_t)c.r | ((uint32_t)c.g << 8) | ((uint32_t)c.b << 16) | ((uint32_t)c.a << 24);
+
+    }
+
+  };
+
+} /* namespace ogl */
+
+#endif /* _H_OGL_GLTEXTBATCH_H_ */
@@ -123,9 +123,9 @@ namespace ogl {
 
       SOIL_free_image_data(tmpImage);
       
-      // Prepend "material." so the type becomes the exact sampler uniform name
-      // used by the model shader (e.g. "material.diffuseTexture").
-      type = "material." + _type;
+      // The type is the sampler uniform name used by the model shader
+      // (e.g. "diffuseTexture").
+      type = _type;
 
       isInited = true;
       
@@ -140,11 +140,14 @@ namespace ogl {
          fprintf(stderr, "ERROR [glTexture]: must be initialized before uploading to GPU\n");
          abort();
        }
-      
+
+      // a texture shared by several materials is uploaded only once
+      if(isInitedInGpu) return;
+
       glGenTextures(1, &id);
                 
       // Assign texture to ID
-      glBindTexture(GL_TEXTURE_2D, id);
+      glState().bindTexture(0, id);
             
       glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, &image[0]);
       
@@ -156,7 +159,7 @@ namespace ogl {
       glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
       glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_R, GL_REPEAT);
       
-      glBindTexture(GL_TEXTURE_2D, 0);
+      glState().bindTexture(0, 0);
      
       isInitedInGpu = true;
       
@@ -169,22 +172,28 @@ namespace ogl {
     //****************************************************************************/
     inline void setInShader(const ogl::glShader & shader, GLenum unit) {
 
+      bind(unit);
+
+      // Tell the matching sampler (e.g. "diffuseTexture") to read from this
+      // texture unit. Without this every sampler would default to unit 0.
+      shader.setUniform(type, (int)unit);
+
+      glCheckError();
+
+    }
+
+    //****************************************************************************/
+    // bind - bind the texture to a unit whose sampler is already assigned
+    //****************************************************************************/
+    inline void bind(GLenum unit) const {
+
       if(!isInitedInGpu) {
         fprintf(stderr, "ERROR [glTexture]: must be initialized in GPU before use\n");
         abort();
       }
 
-      // Active proper texture unit before binding
-      glActiveTexture(GL_TEXTURE0 + unit);
-
-      // And finally bind the texture
-      glBindTexture(GL_TEXTURE_2D, id);
-
-      // Tell the matching sampler (e.g. "material.diffuseTexture") to read from
-      // this texture unit. Without this every sampler would default to unit 0.
-      shader.setUniform(type, (int)unit);
-
-      glCheckError();
+      // Select the unit and bind the texture (skipped when already bound)
+      glState().bindTexture(unit, id);
 
     }
     
@@ -197,6 +206,7 @@ namespace ogl {
         
         DEBUG_LOG("glTexture::cleanInGpu(" + name + ")");
 
+        glWindow::forgetTexture(id);
         glDeleteTextures(1, &id);
         
         isInitedInGpu = false;
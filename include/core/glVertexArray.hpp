@@ -0,0 +1,256 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _H_OGL_GLVERTEXARRAY_H_
+#define _H_OGL_GLVERTEXARRAY_H_
+
+
+#ifndef _H_OGL_H_
+  #error "Do not include this header directly; include <ogl/ogl.hpp> instead."
+#endif
+
+#include <cstdlib>
+#include <cstdio>
+#include <cstdint>
+
+#include <vector>
+
+//****************************************************************************/
+// namespace ogl
+//****************************************************************************/
+namespace ogl {
+
+  //****************************************************************************/
+  // glVertexArray
+  //****************************************************************************/
+  // Buffers are shared by the contexts of a share group, vertex arrays are
+  // not. glVertexArray records the layout of an object's attributes (which
+  // buffer feeds which attribute, plus the element buffer) and builds the
+  // vertex array of a context the first time the object is drawn there, so an
+  // object rendered in several windows uploads its buffers once and only pays
+  // for one vertex array per window.
+  //
+  // Describing the same layout again is free; a change (e.g. a buffer that was
+  // recreated) is applied to the vertex array of each context when it is
+  // next bound there.
+  //****************************************************************************/
+  class glVertexArray {
+
+  private:
+
+    struct Attribute_t {
+      GLuint index;
+      GLuint buffer;
+      GLint size;
+      GLenum type;
+      GLboolean normalized;
+      GLsizei stride;
+      uintptr_t offset;
+      GLuint divisor;
+    };
+
+    // Vertex array of a window and the layout version it was built with
+    struct Context_t {
+      uint32_t windowID;
+      GLuint vao;
+      uint32_t version;
+    };
+
+    std::vector<Attribute_t> attributes;
+
+    GLuint elementBuffer = 0;
+
+    uint32_t version = 1;
+
+    std::vector<Context_t> contexts;
+
+    static uint32_t createdCounter;
+
+  public:
+
+    //****************************************************************************/
+    // glVertexArray
+    //****************************************************************************/
+    glVertexArray() { }
+
+    //****************************************************************************/
+    // ~glVertexArray
+    //****************************************************************************/
+    ~glVertexArray() { clear(); }
+
+    //****************************************************************************/
+    // The vertex arrays are owned by one object: moving transfers them
+    //****************************************************************************/
+    glVertexArray(const glVertexArray &) = delete;
+    glVertexArray & operator = (const glVertexArray &) = delete;
+
+    glVertexArray(glVertexArray && o) noexcept
+      : attributes(std::move(o.attributes)), elementBuffer(o.elementBuffer), version(o.version), contexts(std::move(o.contexts)) {
+      o.contexts.clear();
+    }
+
+    glVertexArray & operator = (glVertexArray && o) noexcept {
+      if(this != &o) {
+        clear();
+        attributes    = std::move(o.attributes);
+        elementBuffer = o.elementBuffer;
+        version       = o.version;
+        contexts      = std::move(o.contexts);
+        o.contexts.clear();
+      }
+      return *this;
+    }
+
+    //****************************************************************************/
+    // attribute() - feed a vertex attribute from a buffer
+    // (glVertexAttribPointer + glEnableVertexAttribArray + glVertexAttribDivisor)
+    //****************************************************************************/
+    void attribute(GLuint index, GLuint buffer, GLint size, GLenum type, GLboolean normalized = GL_FALSE, GLsizei stride = 0, uintptr_t offset = 0, GLuint divisor = 0) {
+
+      Attribute_t attribute = { index, buffer, size, type, normalized, stride, offset, divisor };
+
+      for(Attribute_t & current : attributes) {
+
+        if(current.index != index) continue;
+
+        if(!isSame(current, attribute)) { current = attribute; ++version; }
+
+        return;
+
+      }
+
+      attributes.push_back(attribute);
+
+      ++version;
+
+    }
+
+    //****************************************************************************/
+    // elements() - the element (index) buffer
+    //****************************************************************************/
+    void elements(GLuint buffer) {
+
+      if(elementBuffer == buffer) return;
+
+      elementBuffer = buffer;
+
+      ++version;
+
+    }
+
+    //****************************************************************************/
+    // bind() - bind the vertex array of the current context
+    //****************************************************************************/
+    inline void bind() { get(); }
+
+    //****************************************************************************/
+    // get() - vertex array of the current context, built on the first request
+    // and rebuilt after a layout change. It is left bound.
+    //****************************************************************************/
+    GLuint get() {
+
+      uint32_t windowID = glWindow::current()->id;
+
+      Context_t * context = nullptr;
+
+      for(Context_t & current : contexts) if(current.windowID == windowID) { context = &current; break; }
+
+      if(context == nullptr) {
+
+        DEBUG_LOG("glVertexArray::get() create on windowID " + std::to_string(windowID));
+
+        Context_t created = { windowID, 0, 0 };
+
+        glGenVertexArrays(1, &created.vao);
+
+        ++createdCounter;
+
+        contexts.push_back(created);
+
+        context = &contexts.back();
+
+      }
+
+      glState().bindVertexArray(context->vao);
+
+      if(context->version != version) {
+
+        for(const Attribute_t & attribute : attributes) {
+          glBindBuffer(GL_ARRAY_BUFFER, attribute.buffer);
+          glVertexAttribPointer(attribute.index, attribute.size, attribute.type, attribute.normalized, attribute.stride, reinterpret_cast<void *>(attribute.offset));
+          glEnableVertexAttribArray(attribute.index);
+          glVertexAttribDivisor(attribute.index, attribute.divisor);
+        }
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementBuffer);
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        context->version = version;
+
+      }
+
+      return context->vao;
+
+    }
+
+    //****************************************************************************/
+    // clear() - delete the vertex arrays of every context and forget the layout.
+    // Those of a context that is not current are deleted by its window the
+    // next time it is current; those of destroyed windows died with them.
+    //****************************************************************************/
+    void clear() {
+
+      for(const Context_t & context : contexts) {
+        glWindow * window = glWindow::find(context.windowID);
+        if(window != NULL) window->releaseVertexArray(context.vao);
+      }
+
+      contexts.clear();
+      attributes.clear();
+
+      elementBuffer = 0;
+
+      ++version;
+
+    }
+
+    //****************************************************************************/
+    // getCreatedCount() - vertex arrays created since startup (all contexts)
+    //****************************************************************************/
+    static uint32_t getCreatedCount() { return createdCounter; }
+
+  private:
+
+    //****************************************************************************/
+    // isSame() - field by field, the padding of Attribute_t is not initialized
+    //****************************************************************************/
+    static inline bool isSame(const Attribute_t & a, const Attribute_t & b) {
+      return a.index == b.index && a.buffer == b.buffer && a.size == b.size && a.type == b.type &&
+             a.normalized == b.normalized && a.stride == b.stride && a.offset == b.offset && a.divisor == b.divisor;
+    }
+
+  };
+
+  inline uint32_t glVertexArray::createdCounter = 0;
+
+} /* namespace ogl */
+
+#endif /* _H_OGL_GLVERTEXARRAY_H_ */
@@ -29,6 +29,8 @@
 #include <cstdio>
 
 #include <deque>
+#include <vector>
+#include <algorithm>
 #include <string>
 
 //*****************************************************************************/
@@ -77,6 +79,12 @@ namespace ogl {
 
     glm::vec3 background;
 
+    // Depth only pass before the opaque objects of a glRenderQueue
+    bool isDepthPrePass = false;
+
+    // Text objects queue their glyphs in the glTextBatch instead of drawing
+    bool isTextBatching = true;
+
     bool isProcessMouseMovement = true;
 
     bool isFullscreen;
@@ -112,9 +120,28 @@ namespace ogl {
 
     static uint32_t windowsCounter;
     static uint32_t windowsAlive;
+    static uint64_t framesCounter;
+
+    // Live windows, in creation order. A new context shares its objects with
+    // the first one, so every window ends up in the same share group.
+    static std::vector<glWindow*> windows;
+
+    // Id of the window that started the share group of this context
+    uint32_t shareGroup = 0;
+
+    // Vertex arrays and queries released while another context was current:
+    // they are not shared, so they are deleted the next time this context is current
+    std::vector<GLuint> releasedVertexArrays;
+    std::vector<GLuint> releasedQueries;
 
     glCamera camera;
 
+    // Per-frame uniform buffers (camera + light) of this window's context
+    glFrame frame;
+
+    // Shadow of the GL state of this window's context
+    glStateCache state;
+
     bool keys[1024] = {false, };
 
     // Tempo passato dall'ultima volta che e' stato effettuato il rendering
@@ -139,7 +166,7 @@ namespace ogl {
     ~glWindow() {
       DEBUG_LOG("glWindow::destroy() windowID " + std::to_string(id));
       shutdownImGui();
-      if(window != NULL) { glfwDestroyWindow(window); window = NULL; }
+      destroyContext();
       if(created) {
         created = false;
         if(windowsAlive > 0 && --windowsAlive == 0) { glfw::terminate(); }
@@ -165,7 +192,10 @@ namespace ogl {
       glfwWindowHint(GLFW_RESIZABLE, resizable);
 
       // Create a GLFWwindow object that we can use for GLFW's functions
-      window = glfwCreateWindow(width, height, title, NULL, NULL);
+      // Share buffers, textures and programs with the other windows
+      glWindow * share = (windows.empty()) ? NULL : windows.front();
+
+      window = glfwCreateWindow(width, height, title, NULL, (share != NULL) ? share->window : NULL);
 
       if(window == NULL) {
         fprintf(stderr, "ERROR [glWindow]: failed to create GLFW window\n");
@@ -180,6 +210,8 @@ namespace ogl {
         abort();
       }
 
+      frame.initInGpu();
+
       glEnable(GL_MULTISAMPLE);
 
       glfwGetFramebufferSize(window, &width, &height);
@@ -204,6 +236,10 @@ namespace ogl {
 
       id = windowsCounter++;
 
+      shareGroup = (share != NULL) ? share->shareGroup : id;
+
+      windows.push_back(this);
+
       ++windowsAlive;
       created = true;
 
@@ -248,7 +284,10 @@ namespace ogl {
       glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
 
       // Create a GLFWwindow object that we can use for GLFW's functions
-      window = glfwCreateWindow(width, height, "notitle", NULL, NULL);
+      // Share buffers, textures and programs with the other windows
+      glWindow * share = (windows.empty()) ? NULL : windows.front();
+
+      window = glfwCreateWindow(width, height, "notitle", NULL, (share != NULL) ? share->window : NULL);
 
       if(window == NULL) {
         fprintf(stderr, "ERROR [glWindow]: failed to create GLFW window\n");
@@ -263,6 +302,8 @@ namespace ogl {
         abort();
       }
 
+      frame.initInGpu();
+
       glEnable(GL_MULTISAMPLE);
 
       glfwGetFramebufferSize(window, &width, &height);
@@ -287,6 +328,10 @@ namespace ogl {
 
       id = windowsCounter++;
 
+      shareGroup = (share != NULL) ? share->shareGroup : id;
+
+      windows.push_back(this);
+
       ++windowsAlive;
       created = true;
 
@@ -307,10 +352,7 @@ namespace ogl {
 
       shutdownImGui();
 
-      if(window != NULL) {
-        glfwDestroyWindow(window);
-        window = NULL;
-      }
+      destroyContext();
 
       if(created) {
         created = false;
@@ -321,6 +363,51 @@ namespace ogl {
 
   private:
 
+    //****************************************************************************//
+    // destroyContext() - free the context resources owned by the window, then
+    // the GLFW window itself
+    //****************************************************************************//
+    inline void destroyContext() {
+
+      if(window == NULL) return;
+
+      glfwMakeContextCurrent(window);
+
+      frame.cleanInGpu();
+
+      // the last context of the share group takes the shared stream buffer along
+      if(windows.size() == 1 && windows.front() == this) {
+        glStreamBuffer::instance().cleanInGpu();
+        if(cleanShared != NULL) cleanShared();
+      }
+
+      deleteReleased();
+
+      windows.erase(std::remove(windows.begin(), windows.end(), this), windows.end());
+
+      glfwDestroyWindow(window);
+
+      window = NULL;
+
+    }
+
+    //****************************************************************************//
+    // deleteReleased() - the context of the window must be current
+    //****************************************************************************//
+    inline void deleteReleased() {
+
+      if(!releasedVertexArrays.empty()) {
+        glDeleteVertexArrays((GLsizei)releasedVertexArrays.size(), releasedVertexArrays.data());
+        releasedVertexArrays.clear();
+      }
+
+      if(!releasedQueries.empty()) {
+        glDeleteQueries((GLsizei)releasedQueries.size(), releasedQueries.data());
+        releasedQueries.clear();
+      }
+
+    }
+
     //****************************************************************************//
     // shutdownImGui() - tear down ImGui, but only from the window that created it
     //****************************************************************************//
@@ -338,6 +425,92 @@ namespace ogl {
 
   public:
 
+    // Draws deferred to the end of the frame (the glTextBatch), run by
+    // renderEnd(): set by the header that implements them, which is included
+    // after this one
+    static void (*renderDeferred)(glWindow & window);
+
+    // Frees the shared objects of the headers included after this one (the
+    // glFont atlas), run with the last context like the glStreamBuffer
+    static void (*cleanShared)();
+
+    //****************************************************************************//
+    // current() - the window whose context is current on this thread
+    //****************************************************************************//
+    static inline glWindow * current() { return (glWindow*)glfwGetWindowUserPointer(glfwGetCurrentContext()); }
+
+    //****************************************************************************//
+    // find() - the live window with the given id, NULL if it was destroyed
+    //****************************************************************************//
+    static glWindow * find(uint32_t windowID) {
+
+      for(glWindow * window : windows) if(window->id == windowID) return window;
+
+      return NULL;
+
+    }
+
+    //****************************************************************************//
+    // forgetTexture() - a texture is about to be deleted: texture names are
+    // shared by the contexts, so it leaves the state cache of every window
+    //****************************************************************************//
+    static void forgetTexture(GLuint id) {
+
+      for(glWindow * window : windows) window->state.forgetTexture(id);
+
+    }
+
+    //****************************************************************************//
+    // getFramesCount() - frames ended by renderEnd(), all windows together
+    //****************************************************************************//
+    static inline uint64_t getFramesCount() { return framesCounter; }
+
+    //****************************************************************************//
+    // getShareGroup() - id of the group of contexts sharing buffers, textures
+    // and programs with this one (the id of the first window of the group)
+    //****************************************************************************//
+    inline uint32_t getShareGroup() const { return shareGroup; }
+
+    //****************************************************************************//
+    // releaseVertexArray() - delete a vertex array of this context now if it is
+    // current, otherwise the next time it is
+    //****************************************************************************//
+    void releaseVertexArray(GLuint vao) {
+
+      if(glfwGetCurrentContext() != window) { releasedVertexArrays.push_back(vao); return; }
+
+      // the name may be reused by the next glGenVertexArrays: the cache must not
+      // believe it is still bound
+      if(state.getVertexArray() == vao) state.bindVertexArray(0);
+
+      glDeleteVertexArrays(1, &vao);
+
+    }
+
+    //****************************************************************************//
+    // releaseQueries() - delete query objects of this context now if it is
+    // current, otherwise the next time it is
+    //****************************************************************************//
+    void releaseQueries(const std::vector<GLuint> & queries) {
+
+      if(queries.empty()) return;
+
+      if(glfwGetCurrentContext() != window) { releasedQueries.insert(releasedQueries.end(), queries.begin(), queries.end()); return; }
+
+      glDeleteQueries((GLsizei)queries.size(), queries.data());
+
+    }
+
+    //****************************************************************************//
+    // getFrame() - per-frame uniform buffers of the window
+    //****************************************************************************//
+    glFrame & getFrame() { return frame; }
+
+    //****************************************************************************//
+    // getState() - GL state cache of the window context
+    //****************************************************************************//
+    glStateCache & getState() { return state; }
+
     //****************************************************************************//
     // getCamera() - returns a reference to the window's camera
     //****************************************************************************//
@@ -517,6 +690,22 @@ namespace ogl {
       background = _background;
     }
 
+    //*****************************************************************************/
+    // setDepthPrePass() - draw the depth of the opaque objects of the render
+    //                     queues first, then their color without depth writes
+    //*****************************************************************************/
+    inline void setDepthPrePass(bool value) { isDepthPrePass = value; }
+
+    inline bool getDepthPrePass() const { return isDepthPrePass; }
+
+    //*****************************************************************************/
+    // setTextBatching() - queue the glyphs of the text objects and draw them
+    //                     all at once at the end of the frame (default)
+    //*****************************************************************************/
+    inline void setTextBatching(bool value) { isTextBatching = value; }
+
+    inline bool getTextBatching() const { return isTextBatching; }
+
     //*****************************************************************************/
     // disable/enable Keybord
     //*****************************************************************************/
@@ -641,8 +830,15 @@ namespace ogl {
 
       glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-      glEnable(GL_DEPTH_TEST);
-      glDepthFunc(GL_LEQUAL);
+      deleteReleased();
+
+      // ImGui and user code may have touched the state since the last frame
+      state.invalidate();
+
+      state.enable(GL_DEPTH_TEST);
+      state.depthFunc(GL_LEQUAL);
+
+      frame.setCamera(camera);
 
       keybord = true;
 
@@ -666,6 +862,8 @@ namespace ogl {
     //*****************************************************************************/
     inline void renderEnd() {
 
+      if(renderDeferred != NULL) renderDeferred(*this);
+
       #ifndef OGL_WITHOUT_IMGUI
         if(imguiFrameActive) {
           ImGui::Render();
@@ -674,6 +872,10 @@ namespace ogl {
         }
       #endif
 
+      glStreamBuffer::instance().endFrame();
+
+      ++framesCounter;
+
       glfwSwapBuffers(window);
 
     }
@@ -737,8 +939,17 @@ namespace ogl {
 
   };
 
+  //****************************************************************************//
+  // glState() - GL state cache of the current context
+  //****************************************************************************//
+  inline glStateCache & glState() { return glWindow::current()->getState(); }
+
   inline uint32_t glWindow::windowsCounter = 0;
   inline uint32_t glWindow::windowsAlive   = 0;
+  inline uint64_t glWindow::framesCounter  = 0;
+  inline std::vector<glWindow*> glWindow::windows = std::vector<glWindow*>();
+  inline void (*glWindow::renderDeferred)(glWindow &) = NULL;
+  inline void (*glWindow::cleanShared)() = NULL;
   inline bool     glWindow::imguiInitialized = false;
 
 } /* namespace ogl */
@@ -0,0 +1,400 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _H_OGL_GLBVH_H_
+#define _H_OGL_GLBVH_H_
+
+
+#ifndef _H_OGL_H_
+  #error "Do not include this header directly; include <ogl/ogl.hpp> instead."
+#endif
+
+#include <cstdint>
+#include <cfloat>
+
+#include <vector>
+#include <utility>
+#include <numeric>
+#include <algorithm>
+
+
+//****************************************************************************/
+// namespace ogl
+//****************************************************************************/
+namespace ogl {
+
+  //****************************************************************************/
+  // glRayHit - closest hit of a glModel::raycast()
+  //****************************************************************************/
+  // mesh and triangle are indices into the model meshes and into the triangles
+  // of that mesh (-1 when nothing was hit); the hit point is
+  // barycentrics.x * v0 + barycentrics.y * v1 + barycentrics.z * v2.
+  //****************************************************************************/
+  struct glRayHit {
+
+    int mesh     = -1;
+    int triangle = -1;
+
+    glm::vec3 barycentrics = glm::vec3(0.0f);
+
+    // ray parameter and world position of the hit
+    float distance = FLT_MAX;
+    glm::vec3 position = glm::vec3(0.0f);
+
+    inline bool isHit() const { return mesh >= 0; }
+
+  };
+
+  //****************************************************************************/
+  // glBVH
+  //****************************************************************************/
+  // Bounding volume hierarchy over a set of primitive boxes, built with the
+  // binned surface area heuristic. The tree is a flat array of 32 byte nodes:
+  // an inner node stores the index of its left child (the right one follows
+  // it), a leaf the range of its primitives in indices. Primitives are never
+  // moved, indices maps the leaf ranges back to them, so the same class
+  // serves the meshes of a glModel and the triangles of a glMesh.
+  //****************************************************************************/
+  class glBVH {
+
+  public:
+
+    struct Node_t {
+      glm::vec3 min;
+      uint32_t  first;  // left child (inner node) or first index (leaf)
+      glm::vec3 max;
+      uint32_t  count;  // 0 for inner nodes
+    };
+
+    static_assert(sizeof(Node_t) == 32, "glBVH::Node_t must stay 32 bytes");
+
+  private:
+
+    static constexpr int BINS      = 16;
+    static constexpr int MAX_LEAF  = 8;
+    static constexpr int MAX_DEPTH = 64;
+
+    // cost of visiting a node, relative to testing a primitive
+    static constexpr float TRAVERSAL_COST = 1.0f;
+
+    std::vector<Node_t> nodes;
+    std::vector<uint32_t> indices;
+
+  public:
+
+    //****************************************************************************/
+    // build() - build the tree over the boxes of the primitives
+    //****************************************************************************/
+    void build(const std::vector<glAABB> & boxes) {
+
+      nodes.clear();
+      indices.resize(boxes.size());
+
+      std::iota(indices.begin(), indices.end(), 0);
+
+      if(boxes.empty()) return;
+
+      std::vector<glm::vec3> centroids(boxes.size());
+
+      for(std::size_t i=0; i<boxes.size(); ++i) centroids[i] = boxes[i].getCenter();
+
+      nodes.reserve(2 * boxes.size());
+
+      nodes.push_back(Node_t{ glm::vec3(0.0f), 0, glm::vec3(0.0f), (uint32_t) boxes.size() });
+
+      // node and its depth: the traversals keep a fixed stack of MAX_DEPTH entries
+      std::vector<std::pair<uint32_t,int>> stack(1, std::make_pair(0u, 1));
+
+      while(!stack.empty()) {
+
+        uint32_t index = stack.back().first;
+        int depth = stack.back().second;
+
+        stack.pop_back();
+
+        uint32_t first = nodes[index].first;
+        uint32_t count = nodes[index].count;
+
+        glAABB bounds, centers;
+
+        for(uint32_t i=first; i<first+count; ++i) { bounds.expand(boxes[indices[i]]); centers.expand(centroids[indices[i]]); }
+
+        nodes[index].min = bounds.min;
+        nodes[index].max = bounds.max;
+
+        uint32_t split = 0;
+
+        if(count > 1 && depth < MAX_DEPTH - 1) split = partition(boxes, centroids, bounds, centers, first, count);
+
+        if(split == 0) continue;
+
+        uint32_t left = (uint32_t) nodes.size();
+
+        nodes.push_back(Node_t{ glm::vec3(0.0f), first,         glm::vec3(0.0f), split });
+        nodes.push_back(Node_t{ glm::vec3(0.0f), first + split, glm::vec3(0.0f), count - split });
+
+        nodes[index].first = left;
+        nodes[index].count = 0;
+
+        stack.push_back(std::make_pair(left,     depth + 1));
+        stack.push_back(std::make_pair(left + 1, depth + 1));
+
+      }
+
+    }
+
+    //****************************************************************************/
+    // raycast() - walk the nodes hit by origin + t * dir, t in [0, tMax], near
+    //             child first. intersect(primitive, tMax) tests a primitive and
+    //             lowers tMax on a closer hit.
+    //****************************************************************************/
+    template <typename F>
+    void raycast(const glm::vec3 & origin, const glm::vec3 & dir, float & tMax, F && intersect) const {
+
+      if(nodes.empty()) return;
+
+      glm::vec3 invDir(1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z);
+
+      uint32_t stack[MAX_DEPTH];
+      int size = 0;
+
+      if(hit(nodes[0], origin, invDir, tMax) == FLT_MAX) return;
+
+      stack[size++] = 0;
+
+      while(size > 0) {
+
+        const Node_t & node = nodes[stack[--size]];
+
+        if(node.count > 0) {
+          for(uint32_t i=node.first; i<node.first+node.count; ++i) intersect(indices[i], tMax);
+          continue;
+        }
+
+        float tLeft  = hit(nodes[node.first],     origin, invDir, tMax);
+        float tRight = hit(nodes[node.first + 1], origin, invDir, tMax);
+
+        uint32_t nearChild = node.first, farChild = node.first + 1;
+
+        if(tRight < tLeft) { std::swap(tLeft, tRight); std::swap(nearChild, farChild); }
+
+        // the near child is popped first
+        if(tRight != FLT_MAX) stack[size++] = farChild;
+        if(tLeft  != FLT_MAX) stack[size++] = nearChild;
+
+      }
+
+    }
+
+    //****************************************************************************/
+    // cull() - report the primitives whose node is not outside the frustum.
+    //          visible(primitive, inside) is told when the node was entirely
+    //          inside, so the caller can skip its own test.
+    //****************************************************************************/
+    template <typename F>
+    void cull(const glFrustum & frustum, F && visible) const {
+
+      if(nodes.empty()) return;
+
+      uint32_t stack[MAX_DEPTH];
+      int size = 0;
+
+      stack[size++] = 0;
+
+      while(size > 0) {
+
+        uint32_t index = stack[--size];
+
+        glFrustum::CONTAINMENT containment = frustum.classify(box(index));
+
+        if(containment == glFrustum::OUTSIDE) continue;
+
+        if(containment == glFrustum::INSIDE) {
+          uint32_t first, count;
+          range(index, first, count);
+          for(uint32_t i=first; i<first+count; ++i) visible(indices[i], true);
+          continue;
+        }
+
+        const Node_t & node = nodes[index];
+
+        if(node.count > 0) {
+          for(uint32_t i=node.first; i<node.first+node.count; ++i) visible(indices[i], false);
+          continue;
+        }
+
+        stack[size++] = node.first + 1;
+        stack[size++] = node.first;
+
+      }
+
+    }
+
+    //****************************************************************************/
+    // clear()
+    //****************************************************************************/
+    void clear() { nodes.clear(); indices.clear(); }
+
+    //****************************************************************************/
+    // isEmpty() / getNodesCount() / getDepth()
+    //****************************************************************************/
+    inline bool isEmpty() const { return nodes.empty(); }
+
+    inline std::size_t getNodesCount() const { return nodes.size(); }
+
+    int getDepth() const {
+
+      if(nodes.empty()) return 0;
+
+      int depth = 0;
+
+      std::vector<std::pair<uint32_t,int>> stack(1, std::make_pair(0u, 1));
+
+      while(!stack.empty()) {
+        std::pair<uint32_t,int> item = stack.back(); stack.pop_back();
+        depth = std::max(depth, item.second);
+        if(nodes[item.first].count == 0) {
+          stack.push_back(std::make_pair(nodes[item.first].first,     item.second + 1));
+          stack.push_back(std::make_pair(nodes[item.first].first + 1, item.second + 1));
+        }
+      }
+
+      return depth;
+
+    }
+
+  private:
+
+    //****************************************************************************/
+    // partition() - split [first, first+count) of indices along the cheapest
+    //               SAH bin boundary; returns the size of the left part, 0 to
+    //               keep the node a leaf
+    //****************************************************************************/
+    uint32_t partition(const std::vector<glAABB> & boxes, const std::vector<glm::vec3> & centroids,
+                       const glAABB & bounds, const glAABB & centers, uint32_t first, uint32_t count) {
+
+      glm::vec3 extent = centers.max - centers.min;
+
+      float bestCost = FLT_MAX;
+      int bestAxis = -1, bestBin = 0;
+
+      for(int axis=0; axis<3; ++axis) {
+
+        if(extent[axis] <= 0.0f) continue;
+
+        glAABB bins[BINS];
+        uint32_t counts[BINS] = { 0 };
+
+        float scale = BINS / extent[axis];
+
+        for(uint32_t i=first; i<first+count; ++i) {
+          int bin = std::min(BINS - 1, (int) ((centroids[indices[i]][axis] - centers.min[axis]) * scale));
+          bins[bin].expand(boxes[indices[i]]);
+          ++counts[bin];
+        }
+
+        // sweep from the right, then from the left
+        float rightArea[BINS - 1];
+        uint32_t rightCount[BINS - 1];
+
+        glAABB box; uint32_t sum = 0;
+
+        for(int i=BINS-1; i>0; --i) {
+          box.expand(bins[i]); sum += counts[i];
+          rightArea[i - 1] = area(box); rightCount[i - 1] = sum;
+        }
+
+        box = glAABB(); sum = 0;
+
+        for(int i=0; i<BINS-1; ++i) {
+          box.expand(bins[i]); sum += counts[i];
+          float cost = sum * area(box) + rightCount[i] * rightArea[i];
+          if(sum > 0 && rightCount[i] > 0 && cost < bestCost) { bestCost = cost; bestAxis = axis; bestBin = i; }
+        }
+
+      }
+
+      // centroids all in one point: split in the middle only if the leaf is too big
+      if(bestAxis < 0) return (count > MAX_LEAF) ? count / 2 : 0;
+
+      if(count <= MAX_LEAF && bestCost + TRAVERSAL_COST * area(bounds) >= count * area(bounds)) return 0;
+
+      float scale = BINS / extent[bestAxis];
+
+      uint32_t * begin = indices.data() + first;
+
+      uint32_t * middle = std::partition(begin, begin + count, [&](uint32_t index) {
+        return std::min(BINS - 1, (int) ((centroids[index][bestAxis] - centers.min[bestAxis]) * scale)) <= bestBin;
+      });
+
+      return (uint32_t) (middle - begin);
+
+    }
+
+    //****************************************************************************/
+    // hit() - entry distance of the ray in the node, FLT_MAX when missed
+    //****************************************************************************/
+    static inline float hit(const Node_t & node, const glm::vec3 & origin, const glm::vec3 & invDir, float tMax) {
+
+      glm::vec3 t0 = (node.min - origin) * invDir;
+      glm::vec3 t1 = (node.max - origin) * invDir;
+
+      glm::vec3 tSmall = glm::min(t0, t1);
+      glm::vec3 tBig   = glm::max(t0, t1);
+
+      float tNear = std::max(std::max(tSmall.x, tSmall.y), std::max(tSmall.z, 0.0f));
+      float tFar  = std::min(std::min(tBig.x, tBig.y), std::min(tBig.z, tMax));
+
+      return (tNear <= tFar) ? tNear : FLT_MAX;
+
+    }
+
+    //****************************************************************************/
+    // box() / range() - bounds and primitive range of a node
+    //****************************************************************************/
+    inline glAABB box(uint32_t index) const { glAABB box; box.min = nodes[index].min; box.max = nodes[index].max; return box; }
+
+    void range(uint32_t index, uint32_t & first, uint32_t & count) const {
+
+      // the primitives of a subtree are contiguous in indices: leftmost and rightmost leaves
+      uint32_t left = index, right = index;
+
+      while(nodes[left].count == 0)  left  = nodes[left].first;
+      while(nodes[right].count == 0) right = nodes[right].first + 1;
+
+      first = nodes[left].first;
+      count = nodes[right].first + nodes[right].count - first;
+
+    }
+
+    //****************************************************************************/
+    // area() - half surface area of a box
+    //****************************************************************************/
+    static inline float area(const glAABB & box) {
+      glm::vec3 size = box.getSize();
+      return size.x * size.y + size.y * size.z + size.z * size.x;
+    }
+
+  };
+
+} /* namespace ogl */
+
+#endif /* _H_OGL_GLBVH_H_ */
+
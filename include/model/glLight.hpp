@@ -87,30 +87,66 @@ namespace ogl {
     void setSpecular(const glm::vec3& _specular)   { specular  = _specular; }
 
     //****************************************************************************//
-    // setInShader - upload the light to the given shader
+    // setInFrame - put the light in the "Lighting" uniform block of the current
+    // window, used by the built-in shaders. Uploads only if it changed.
+    //****************************************************************************//
+    void setInFrame(const glm::mat4 & view) const {
+
+      glm::vec3 viewPos, viewDir;
+
+      toViewSpace(view, viewPos, viewDir);
+
+      glFrame::Light_t value;
+
+      value.position  = glm::vec4(viewPos,  0.0f);
+      value.direction = glm::vec4(viewDir,  0.0f);
+      value.ambient   = glm::vec4(ambient,  0.0f);
+      value.diffuse   = glm::vec4(diffuse,  0.0f);
+      value.specular  = glm::vec4(specular, 0.0f);
+
+      glWindow::current()->getFrame().setLight(value);
+
+    }
+
+    //****************************************************************************//
+    // setInShader - upload the light to the plain "light" uniform of a custom
+    // shader that does not use the Lighting block
     //****************************************************************************//
     void setInShader(const ogl::glShader & shader, const glm::mat4 & view) const {
 
+      glm::vec3 viewPos, viewDir;
+
+      toViewSpace(view, viewPos, viewDir);
+
+      shader.setUniform("light.position",  viewPos);
+      shader.setUniform("light.direction", viewDir);
+      shader.setUniform("light.ambient",   ambient);
+      shader.setUniform("light.diffuse",   diffuse);
+      shader.setUniform("light.specular",  specular);
+
+    }
+
+  private:
+
+    //****************************************************************************//
+    // toViewSpace - light position/direction in view space
+    //****************************************************************************//
+    void toViewSpace(const glm::mat4 & view, glm::vec3 & viewPos, glm::vec3 & viewDir) const {
+
       // The shaders work in view space (the camera is at the origin there), so
       // the light position/direction are transformed by the view matrix to match
       // fragPos and fragNormal. Send a real position/direction only if one was
       // explicitly set; otherwise send zeros so the shaders fall back to a head
       // light coming from the camera (a light that follows the viewpoint).
-      glm::vec3 viewPos(0.0f);
+      viewPos = glm::vec3(0.0f);
       if(hasPosition) viewPos = glm::vec3(view * glm::vec4(position, 1.0f));
 
-      glm::vec3 viewDir(0.0f);
+      viewDir = glm::vec3(0.0f);
       if(hasDirection) {
         viewDir = glm::mat3(view) * direction;
         if(glm::length(viewDir) > 0.0f) viewDir = glm::normalize(viewDir);
       }
 
-      shader.setUniform("light.position",  viewPos);
-      shader.setUniform("light.direction", viewDir);
-      shader.setUniform("light.ambient",   ambient);
-      shader.setUniform("light.diffuse",   diffuse);
-      shader.setUniform("light.specular",  specular);
-
     }
 
   };
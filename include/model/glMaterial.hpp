@@ -27,6 +27,7 @@
 
 #include <cstdlib>
 #include <cstdio>
+#include <cstring>
 
 #include <vector>
 #include <string>
@@ -46,11 +47,42 @@ namespace ogl {
   //
   // Supported textures: diffuse, specular, ambient, emissive, normals, opacity.
   // Each texture, when present, overrides the matching color in the shader.
+  //
+  // The parameters reach the shader as a std140 Record_t: glModel packs the
+  // records of all its materials in one uniform buffer and selects the one
+  // of each draw with glBindBufferRange(). Every texture map has a fixed
+  // unit (its TEXTURE value), so the samplers are assigned once per program
+  // with setSamplers() and switching material only binds textures.
   //****************************************************************************//
   class glMaterial {
 
+  public:
+
+    // Texture maps, also their texture unit and their bit in Record_t::textures.
+    enum TEXTURE { DIFFUSE, SPECULAR, AMBIENT, EMISSIVE, NORMALS, OPACITY, TEXTURES };
+
+    // Binding point of the "MaterialBlock" uniform block.
+    static constexpr GLuint BINDING = glFrame::MATERIAL_BINDING;
+
+    // std140 layout of the "MaterialBlock" uniform block
+    struct Record_t {
+      glm::vec4 emissiveColor;
+      glm::vec4 ambientColor;
+      glm::vec4 diffuseColor;
+      glm::vec4 specularColor;
+      float shininess;
+      float opacity;
+      GLint textures;  // bit mask of the available TEXTURE maps
+      GLint padding;
+    };
+
   private:
 
+    // Sampler uniform of each TEXTURE.
+    static constexpr const char * samplerNames[TEXTURES] = {
+      "diffuseTexture", "specularTexture", "ambientTexture", "emissiveTexture", "normalsTexture", "opacityTexture"
+    };
+
     // Material name (as reported by Assimp).
     std::string name;
 
@@ -63,16 +95,8 @@ namespace ogl {
     float ns = 32.0f; // specular exponent (shininess)
     float d  = 1.0f;  // opacity (1 = fully opaque)
 
-    // Texture handles (indices into the global glTextures store).
-    std::vector<int> textures;
-
-    // Which texture maps this material actually provides.
-    bool haveDiffuseTexture  = false;
-    bool haveSpecularTexture = false;
-    bool haveAmbientTexture  = false;
-    bool haveEmissiveTexture = false;
-    bool haveNormalsTexture  = false;
-    bool haveOpacityTexture  = false;
+    // Texture handle of each map (index into the global glTextures store, -1 when missing).
+    int textures[TEXTURES] = { -1, -1, -1, -1, -1, -1 };
 
     bool isInited      = false;
     bool isInitedInGpu = false;
@@ -105,12 +129,12 @@ namespace ogl {
       material->Get(AI_MATKEY_OPACITY,   d);
 
       // Texture maps (only the first map of each type is used).
-      loadTexture(material, aiTextureType_DIFFUSE,  "diffuseTexture",  path, haveDiffuseTexture);
-      loadTexture(material, aiTextureType_SPECULAR, "specularTexture", path, haveSpecularTexture);
-      loadTexture(material, aiTextureType_AMBIENT,  "ambientTexture",  path, haveAmbientTexture);
-      loadTexture(material, aiTextureType_EMISSIVE, "emissiveTexture", path, haveEmissiveTexture);
-      loadTexture(material, aiTextureType_NORMALS,  "normalsTexture",  path, haveNormalsTexture);
-      loadTexture(material, aiTextureType_OPACITY,  "opacityTexture",  path, haveOpacityTexture);
+      loadTexture(material, aiTextureType_DIFFUSE,  DIFFUSE,  path);
+      loadTexture(material, aiTextureType_SPECULAR, SPECULAR, path);
+      loadTexture(material, aiTextureType_AMBIENT,  AMBIENT,  path);
+      loadTexture(material, aiTextureType_EMISSIVE, EMISSIVE, path);
+      loadTexture(material, aiTextureType_NORMALS,  NORMALS,  path);
+      loadTexture(material, aiTextureType_OPACITY,  OPACITY,  path);
 
       isInited = true;
 
@@ -123,7 +147,7 @@ namespace ogl {
 
     //****************************************************************************//
     // A material releases its textures in the destructor, so it must be movable
-    // and not copyable: when glMesh is moved the source material has to be
+    // and not copyable: when a material is moved the source has to be
     // neutralized, otherwise it would free textures the destination still uses.
     //****************************************************************************//
     glMaterial(const glMaterial &) = delete;
@@ -137,39 +161,65 @@ namespace ogl {
     }
 
     //****************************************************************************//
-    // setInShader - upload colors, flags and bind textures
+    // getRecord - the material as stored in the uniform buffer
+    //****************************************************************************//
+    Record_t getRecord() const {
+
+      Record_t record;
+
+      record.emissiveColor = glm::vec4(ke, 0.0f);
+      record.ambientColor  = glm::vec4(ka, 0.0f);
+      record.diffuseColor  = glm::vec4(kd, 0.0f);
+      record.specularColor = glm::vec4(ks, 0.0f);
+      record.shininess     = ns;
+      record.opacity       = d;
+      record.textures      = 0;
+      record.padding       = 0;
+
+      for(int i=0; i<TEXTURES; ++i)
+        if(textures[i] >= 0) record.textures |= (1 << i);
+
+      return record;
+
+    }
+
+    //****************************************************************************//
+    // isSame - true when the two materials render identically
+    //****************************************************************************//
+    bool isSame(const glMaterial & other) const {
+
+      Record_t a = getRecord();
+      Record_t b = other.getRecord();
+
+      return memcmp(&a, &b, sizeof(Record_t)) == 0 && memcmp(textures, other.textures, sizeof(textures)) == 0;
+
+    }
+
+    //****************************************************************************//
+    // bindTextures - bind the texture maps to their fixed units
     //****************************************************************************//
-    void setInShader(const ogl::glShader & shader) {
+    void bindTextures() const {
 
       if(!isInitedInGpu) {
-        fprintf(stderr, "ERROR [glMaterial]: must be initialized in GPU before setting in shader\n");
+        fprintf(stderr, "ERROR [glMaterial]: must be initialized in GPU before binding\n");
         abort();
       }
 
-      // Tell the shader which texture maps are available.
-      shader.setUniform("material.haveDiffuseTexture",  haveDiffuseTexture);
-      shader.setUniform("material.haveSpecularTexture", haveSpecularTexture);
-      shader.setUniform("material.haveAmbientTexture",  haveAmbientTexture);
-      shader.setUniform("material.haveEmissiveTexture", haveEmissiveTexture);
-      shader.setUniform("material.haveNormalsTexture",  haveNormalsTexture);
-      shader.setUniform("material.haveOpacityTexture",  haveOpacityTexture);
+      for(GLuint i=0; i<TEXTURES; ++i)
+        if(textures[i] >= 0) glTextures::get(textures[i]).bind(i);
 
-      // Colors.
-      shader.setUniform("material.emissiveColor", ke);
-      shader.setUniform("material.ambientColor",  ka);
-      shader.setUniform("material.diffuseColor",  kd);
-      shader.setUniform("material.specularColor", ks);
+      glCheckError();
 
-      // Scalars.
-      shader.setUniform("material.shininess", ns);
-      shader.setUniform("material.opacity",   d);
+    }
 
-      // Bind every texture to its own unit (the unit is also assigned to the
-      // matching sampler uniform inside glTexture::setInShader).
-      for(GLuint i=0; i<textures.size(); ++i)
-        glTextures::get(textures[i]).setInShader(shader, i);
+    //****************************************************************************//
+    // setSamplers - point the sampler uniforms of a program to the fixed units
+    //               (the program must be in use)
+    //****************************************************************************//
+    static void setSamplers(const ogl::glShader & shader) {
 
-      glCheckError();
+      for(int i=0; i<TEXTURES; ++i)
+        shader.setUniform(samplerNames[i], i);
 
     }
 
@@ -183,8 +233,8 @@ namespace ogl {
         abort();
       }
 
-      for(size_t i=0; i<textures.size(); ++i)
-        glTextures::get(textures[i]).setInGpu();
+      for(int i=0; i<TEXTURES; ++i)
+        if(textures[i] >= 0) glTextures::get(textures[i]).setInGpu();
 
       glCheckError();
 
@@ -218,8 +268,8 @@ namespace ogl {
 
       if(isInitedInGpu) {
 
-        for(size_t i=0; i<textures.size(); ++i)
-          glTextures::get(textures[i]).cleanInGpu();
+        for(int i=0; i<TEXTURES; ++i)
+          if(textures[i] >= 0) glTextures::get(textures[i]).cleanInGpu();
 
         isInitedInGpu = false;
 
@@ -234,22 +284,17 @@ namespace ogl {
     //****************************************************************************//
     void moveFrom(glMaterial && other) {
 
-      name                = std::move(other.name);
-      ke                  = other.ke;
-      ka                  = other.ka;
-      kd                  = other.kd;
-      ks                  = other.ks;
-      ns                  = other.ns;
-      d                   = other.d;
-      textures            = std::move(other.textures);
-      haveDiffuseTexture  = other.haveDiffuseTexture;
-      haveSpecularTexture = other.haveSpecularTexture;
-      haveAmbientTexture  = other.haveAmbientTexture;
-      haveEmissiveTexture = other.haveEmissiveTexture;
-      haveNormalsTexture  = other.haveNormalsTexture;
-      haveOpacityTexture  = other.haveOpacityTexture;
-      isInited            = other.isInited;
-      isInitedInGpu       = other.isInitedInGpu;
+      name          = std::move(other.name);
+      ke            = other.ke;
+      ka            = other.ka;
+      kd            = other.kd;
+      ks            = other.ks;
+      ns            = other.ns;
+      d             = other.d;
+      isInited      = other.isInited;
+      isInitedInGpu = other.isInitedInGpu;
+
+      memcpy(textures, other.textures, sizeof(textures));
 
       // the moved-from material must not release the textures we just took over
       other.isInitedInGpu = false;
@@ -259,7 +304,7 @@ namespace ogl {
     //****************************************************************************//
     // loadTexture - load the first texture of a given type, if any
     //****************************************************************************//
-    void loadTexture(const aiMaterial * material, aiTextureType type, const std::string & typeName, const std::string & path, bool & haveFlag) {
+    void loadTexture(const aiMaterial * material, aiTextureType type, TEXTURE slot, const std::string & path) {
 
       if(material->GetTextureCount(type) == 0) return;
 
@@ -268,9 +313,7 @@ namespace ogl {
       // Only the first map of this type is taken into account.
       material->GetTexture(type, 0, &filename);
 
-      textures.push_back(ogl::glTextures::load(typeName, filename.C_Str(), path));
-
-      haveFlag = true;
+      textures[slot] = ogl::glTextures::load(samplerNames[slot], filename.C_Str(), path);
 
     }
 
@@ -27,11 +27,16 @@
 
 #include <cstdlib>
 #include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <cmath>
 
 #include <string>
 #include <sstream>
 #include <vector>
 #include <utility>
+#include <algorithm>
 
 
 //****************************************************************************//
@@ -52,14 +57,61 @@ namespace ogl {
 
   };
 
+  //****************************************************************************//
+  // glPackedVertex - the same vertex in 16 bytes (decoded by OGL_PACKED_VERTEX
+  //                  in model.vs): int16 position in the mesh box plus the
+  //                  bitangent sign, octahedral int8 normal and tangent, half
+  //                  float texture coordinates
+  //****************************************************************************//
+  struct glPackedVertex {
+
+    int16_t  Position[4];
+    int8_t   Frame[4];
+    uint16_t TexCoords[2];
+
+  };
+
+  static_assert(sizeof(glPackedVertex) == 16, "glPackedVertex must stay 16 bytes");
+
   //****************************************************************************//
   // glMesh
   //****************************************************************************//
-  // A single mesh of a model: a vertex/index buffer plus its material. It owns
-  // its GPU buffers (vao/vbo/ebo), so it is movable but not copyable. The mesh
-  // is uploaded to the GPU lazily on the first render() call.
+  // A single mesh of a model: a vertex/index buffer plus the index of its
+  // material in the owning glModel. It owns its GPU buffers (vao/vbo/ebo), so
+  // it is movable but not copyable. The mesh is uploaded to the GPU lazily on
+  // the first render() call. raycast() walks a glBVH over its triangles, built
+  // by the owning glModel.
+  //
+  // generateLods() adds simplified index lists of the same vertices; all the
+  // levels live in one element buffer and render(level) draws one of them.
+  // optimize() reorders triangles and vertices of every level for the GPU.
+  // setInGpu(true) uploads glPackedVertex instead of glVertex when the mesh
+  // allows it; the CPU copy stays in full precision. Indices are uploaded as
+  // 16 bit, split when needed into clusters drawn with a base vertex.
+  // A glModel does not upload its meshes one by one: it merges their
+  // buildDraws() and vertices in its own buffers, the mesh buffers are only
+  // created when the mesh itself is rendered.
   //****************************************************************************//
   class glMesh {
+
+  public:
+
+    // largest arena / mesh size ratio a packed mesh is quantized in, see canPack()
+    static constexpr float MAX_PACK_RATIO = 64.0f;
+
+    // a level of detail: a range of the element buffer and its geometric error
+    struct Lod_t {
+      GLuint offset;
+      GLuint count;
+      float  error;
+    };
+
+    // a draw of the element buffer (buildDraws)
+    struct Draw_t {
+      GLsizei count;
+      GLuint  offset;     // bytes
+      GLint   baseVertex;
+    };
     
   private:
     
@@ -68,14 +120,38 @@ namespace ogl {
     GLuint id;
     
     /* Render data */
-    GLuint vao, vbo, ebo;
+    glVertexArray vao;
+    GLuint vbo, ebo;
     
     /* Mesh Data */
     std::vector<glVertex> vertices;
     std::vector<GLuint> indices;
+
+    /* Bounds of the vertices, refreshed whenever they move */
+    glAABB box;
+
+    /* Hierarchy over the triangles, built by buildBVH() */
+    glBVH bvh;
+
+    /* Levels of detail: lods[0] is indices, the others are stored in lodIndices */
+    std::vector<Lod_t> lods;
+    std::vector<GLuint> lodIndices;
+
+    /* Vertex cache miss ratio before and after optimize() */
+    float acmr[2] = { 0.0f, 0.0f };
+
+    /* Draw calls of the element buffer, levelDraws[level] is the first one of a level */
+    std::vector<Draw_t> draws;
+    std::vector<GLuint> levelDraws;
+    GLenum indicesType = GL_UNSIGNED_INT;
+
+    /* Uploaded as glPackedVertex, quantized in the box center +- extent */
+    bool isPackedInGpu = false;
+    glm::vec3 packCenter = glm::vec3(0.0f);
+    glm::vec3 packExtent = glm::vec3(1.0f);
     
-    /* Material Data */
-    glMaterial material;
+    /* Material Data (index into the glModel materials) */
+    GLuint materialIndex;
     
     bool isInited;
     bool isInitedInGpu;
@@ -88,7 +164,7 @@ namespace ogl {
     //****************************************************************************//
     // glMesh - Constructor
     //****************************************************************************//
-    glMesh(const aiMesh * mesh, const aiScene * scene, const std::string & path) : isInitedInGpu(false) {
+    glMesh(const aiMesh * mesh, GLuint _materialIndex) : materialIndex(_materialIndex), isInitedInGpu(false) {
       
       name = mesh->mName.C_Str();
 
@@ -98,7 +174,7 @@ namespace ogl {
       for(GLuint i=0; i<mesh->mNumVertices; i++) {
         
         glVertex vertex;
-        
+
         // Placeholder vector to convert to assimp vector to glm
         glm::vec3 vector;
         
@@ -138,6 +214,8 @@ namespace ogl {
         vertices.push_back(vertex);
         
       }
+
+      updateBounds();
       
       // Walk through each face and collect the vertex indices.
       for(GLuint i=0; i<mesh->mNumFaces; i++) {
@@ -150,8 +228,8 @@ namespace ogl {
         }
         
       }
-      
-      material = ogl::glMaterial(scene->mMaterials[mesh->mMaterialIndex], path);
+
+      lods.assign(1, Lod_t{ 0, (GLuint) indices.size(), 0.0f });
       
       isInited = true;
       
@@ -182,7 +260,7 @@ namespace ogl {
     //****************************************************************************//
     // render
     //****************************************************************************//
-    void render(const glShader & shader) {
+    void render(std::size_t level = 0) {
                  
       if(!isInited){
         fprintf(stderr, "ERROR [glMesh]: must be initialized before rendering\n");
@@ -190,47 +268,34 @@ namespace ogl {
       }
       
       if(!isInitedInGpu) { setInGpu(); }
-
-      setInShader(shader);
               
-      glBindVertexArray(vao);
+      vao.bind();
       
-      glDrawElements(GL_TRIANGLES, (int)indices.size(), GL_UNSIGNED_INT, 0);
-      
-      glBindVertexArray(0);
+      level = std::min(level, lods.size() - 1);
+
+      for(GLuint i=levelDraws[level]; i<levelDraws[level + 1]; ++i)
+        glDrawElementsBaseVertex(GL_TRIANGLES, draws[i].count, indicesType, (void*)(uintptr_t) draws[i].offset, draws[i].baseVertex);
       
       glCheckError();
             
     }
     
     //****************************************************************************//
-    // bounds
+    // bounds - center, size and bounding sphere radius (cached)
     //****************************************************************************//
     void bounds(glm::vec3 & center, glm::vec3 & size, float & radius) const {
 
-      float xMin =  FLT_MAX, xMax = -FLT_MAX;
-      float yMin =  FLT_MAX, yMax = -FLT_MAX;
-      float zMin =  FLT_MAX, zMax = -FLT_MAX;
-
-      for(std::size_t i=0; i<vertices.size(); ++i) {
-        const glm::vec3 & pos = vertices[i].Position;
-        if(pos.x < xMin) xMin = pos.x;  if(pos.x > xMax) xMax = pos.x;
-        if(pos.y < yMin) yMin = pos.y;  if(pos.y > yMax) yMax = pos.y;
-        if(pos.z < zMin) zMin = pos.z;  if(pos.z > zMax) zMax = pos.z;
-      }
-
-      center.x = (xMin + xMax) * 0.5f;
-      center.y = (yMin + yMax) * 0.5f;
-      center.z = (zMin + zMax) * 0.5f;
-
-      size.x = xMax - xMin;
-      size.y = yMax - yMin;
-      size.z = zMax - zMin;
-        
-      radius = 0.5f * glm::length(size);
+      center = box.getCenter();
+      size   = box.getSize();
+      radius = box.getRadius();
       
     }
 
+    //****************************************************************************//
+    // getAABB - bounding box of the vertices (cached)
+    //****************************************************************************//
+    inline const glAABB & getAABB() const { return box; }
+
     
     //****************************************************************************//
     // scale
@@ -241,77 +306,349 @@ namespace ogl {
         vertices[i].Position += offset;
         vertices[i].Position *= scaleFactor;
       }
+
+      updateBounds();
+
+      for(std::size_t i=0; i<lods.size(); ++i) lods[i].error *= (float) std::fabs(scaleFactor);
+
+      if(!bvh.isEmpty()) buildBVH();
       
     }
-    
+
     //****************************************************************************//
-    // setInShader
+    // buildBVH - build the hierarchy over the triangles (thread safe across meshes)
     //****************************************************************************//
-    void setInShader(const ogl::glShader & program) { material.setInShader(program); }
+    void buildBVH() {
+
+      std::vector<glAABB> boxes(getTrianglesCount());
+
+      for(std::size_t i=0; i<boxes.size(); ++i) {
+        boxes[i].expand(vertices[indices[3*i+0]].Position);
+        boxes[i].expand(vertices[indices[3*i+1]].Position);
+        boxes[i].expand(vertices[indices[3*i+2]].Position);
+      }
+
+      bvh.build(boxes);
+
+    }
+
+    //****************************************************************************//
+    // raycast - closest triangle hit by origin + t * dir with t < tMax (mesh
+    //           space). On a hit lowers tMax and sets triangle and barycentrics.
+    //****************************************************************************//
+    bool raycast(const glm::vec3 & origin, const glm::vec3 & dir, float & tMax, int & triangle, glm::vec3 & barycentrics) const {
+
+      bool isHit = false;
+
+      bvh.raycast(origin, dir, tMax, [&](uint32_t index, float & t) {
+        if(intersect(index, origin, dir, t, barycentrics)) { triangle = (int) index; isHit = true; }
+      });
+
+      return isHit;
+
+    }
+
+    //****************************************************************************//
+    // generateLods - simplify the mesh into up to 'levels' more levels, each
+    //                with about half the triangles of the previous one
+    //****************************************************************************//
+    void generateLods(int levels = 4) {
+
+      lods.resize(1);
+      lodIndices.clear();
+
+      std::vector<glm::vec3> positions(vertices.size());
+
+      for(std::size_t i=0; i<vertices.size(); ++i) positions[i] = vertices[i].Position;
+
+      std::vector<GLuint> source = indices;
+
+      float error = 0.0f;
+
+      for(int i=0; i<levels; ++i) {
+
+        std::size_t trianglesCount = source.size() / 3;
+
+        if(trianglesCount < 32) break;
+
+        float levelError = 0.0f;
+
+        std::vector<GLuint> level = glSimplify::simplify(positions, source, trianglesCount / 2, levelError);
+
+        // locked borders and seams: stop when a level saves less than 10%
+        if(level.size() / 3 > trianglesCount * 9 / 10) break;
+
+        // each level is simplified from the previous one: its errors add up
+        error += levelError;
+
+        lods.push_back(Lod_t{ (GLuint) (indices.size() + lodIndices.size()), (GLuint) level.size(), error });
+
+        lodIndices.insert(lodIndices.end(), level.begin(), level.end());
+
+        source.swap(level);
+
+      }
+
+    }
+
+    //****************************************************************************//
+    // optimize - reorder the triangles of every level for the vertex cache (and
+    //            for overdraw the full mesh), then the vertices for fetching
+    //****************************************************************************//
+    void optimize(bool isOverdraw = false) {
+
+      acmr[0] = glOptimize::getACMR(indices.data(), indices.size(), vertices.size());
+
+      for(std::size_t i=0; i<lods.size(); ++i) {
+
+        GLuint * levelIndices = (i == 0) ? indices.data() : &lodIndices[lods[i].offset - indices.size()];
+
+        glOptimize::vertexCache(levelIndices, lods[i].count, vertices.size());
+
+      }
+
+      if(isOverdraw) {
+
+        std::vector<glm::vec3> positions(vertices.size());
+
+        for(std::size_t i=0; i<vertices.size(); ++i) positions[i] = vertices[i].Position;
+
+        glOptimize::overdraw(indices.data(), indices.size(), positions);
+
+      }
+
+      std::vector<GLuint> remap = glOptimize::fetchRemap({ &indices, &lodIndices }, vertices.size());
+
+      std::vector<glVertex> remapped(vertices.size());
+
+      for(std::size_t i=0; i<vertices.size(); ++i) remapped[remap[i]] = vertices[i];
+
+      vertices.swap(remapped);
+
+      for(std::size_t i=0; i<indices.size(); ++i)    indices[i]    = remap[indices[i]];
+      for(std::size_t i=0; i<lodIndices.size(); ++i) lodIndices[i] = remap[lodIndices[i]];
+
+      acmr[1] = glOptimize::getACMR(indices.data(), indices.size(), vertices.size());
+
+    }
+
+    //****************************************************************************//
+    // getACMR - vertex cache miss ratio of the full mesh before/after optimize()
+    //****************************************************************************//
+    inline float getACMR(bool isOptimized = true) const { return acmr[isOptimized ? 1 : 0]; }
+
+    //****************************************************************************//
+    // save / load - the processed geometry, to skip optimize() and generateLods()
+    //               on the next import. load() returns false on a malformed blob.
+    //****************************************************************************//
+    void save(std::vector<char> & data) const {
+
+      write(data, vertices);
+      write(data, indices);
+      write(data, lodIndices);
+      write(data, lods);
+
+      data.insert(data.end(), (const char *) acmr, (const char *) acmr + sizeof(acmr));
+
+    }
+
+    bool load(const char * & data, const char * end) {
+
+      if(!read(data, end, vertices) || !read(data, end, indices) || !read(data, end, lodIndices) || !read(data, end, lods)) return false;
+
+      if(end - data < (std::ptrdiff_t) sizeof(acmr)) return false;
+
+      memcpy(acmr, data, sizeof(acmr)); data += sizeof(acmr);
+
+      if(lods.empty()) lods.assign(1, Lod_t{ 0, (GLuint) indices.size(), 0.0f });
+
+      updateBounds();
+
+      return true;
+
+    }
+
+    //****************************************************************************//
+    // getLodsCount / getLod - levels of detail, 0 is the full mesh
+    //****************************************************************************//
+    inline std::size_t getLodsCount() const { return lods.size(); }
+
+    inline const Lod_t & getLod(std::size_t level) const { return lods[std::min(level, lods.size() - 1)]; }
+
+    //****************************************************************************//
+    // getLodIndices - the getLod(level).count indices of a level
+    //****************************************************************************//
+    const GLuint * getLodIndices(std::size_t level) const {
+
+      level = std::min(level, lods.size() - 1);
+
+      return (level == 0) ? indices.data() : &lodIndices[lods[level].offset - indices.size()];
+
+    }
+
+    //****************************************************************************//
+    // selectLod - coarsest level whose error, times errorScale (pixels per
+    //             model unit at the mesh distance), stays within threshold
+    //****************************************************************************//
+    std::size_t selectLod(float errorScale, float threshold) const {
+
+      std::size_t level = 0;
+
+      while(level + 1 < lods.size() && lods[level + 1].error * errorScale <= threshold) ++level;
+
+      return level;
+
+    }
+
+    //****************************************************************************//
+    // getTrianglesCount
+    //****************************************************************************//
+    inline std::size_t getTrianglesCount() const { return indices.size() / 3; }
     
     //****************************************************************************//
-    // setInGpu - Initializes all the buffer objects/arrays
+    // getMaterialIndex
+    //****************************************************************************//
+    inline GLuint getMaterialIndex() const { return materialIndex; }
+
+    //****************************************************************************//
+    // isPacked - uploaded as glPackedVertex
+    //****************************************************************************//
+    inline bool isPacked() const { return isPackedInGpu; }
+
+    //****************************************************************************//
+    // getPackingBox - center and half size the packed positions are relative to
+    //****************************************************************************//
+    inline void getPackingBox(glm::vec3 & center, glm::vec3 & extent) const { center = packCenter; extent = packExtent; }
+
+    //****************************************************************************//
+    // canPack - half floats keep texture coordinates to 1/512 only up to 4
+    //           (tiled textures beyond that stay in full precision)
+    //****************************************************************************//
+    bool canPack() const {
+
+      for(std::size_t i=0; i<vertices.size(); ++i)
+        if(std::fabs(vertices[i].TexCoords.x) > 4.0f || std::fabs(vertices[i].TexCoords.y) > 4.0f) return false;
+
+      return !vertices.empty();
+
+    }
+
+    //****************************************************************************//
+    // canPack - as above, in an arena quantized in the box 'arena': a mesh
+    //           whose largest side is over MAX_PACK_RATIO times smaller than
+    //           the largest side of the arena would keep less than
+    //           65536 / 64 = 1024 steps across itself, so it stays in full
+    //           precision
     //****************************************************************************//
-    void setInGpu() {
+    bool canPack(const glAABB & arena) const {
+
+      if(!canPack()) return false;
+
+      glm::vec3 size = box.getSize();
+      glm::vec3 arenaSize = arena.getSize();
+
+      float side = std::max(size.x, std::max(size.y, size.z));
+      float arenaSide = std::max(arenaSize.x, std::max(arenaSize.y, arenaSize.z));
+
+      return side * MAX_PACK_RATIO >= arenaSide;
+
+    }
+
+    //****************************************************************************//
+    // setInGpu - Initializes all the buffer objects/arrays, packing the
+    //            vertices when asked and possible
+    //****************************************************************************//
+    void setInGpu(bool isPacking = false) {
       
       if(!isInited){
         fprintf(stderr, "ERROR [glMesh]: must be initialized before uploading to GPU\n");
         abort();
       }
       
-      // Create buffers/arrays
-      glGenVertexArrays(1, &vao);
-      
+      // Create buffers
       glGenBuffers(1, &vbo);
       glGenBuffers(1, &ebo);
       
-      glBindVertexArray(vao);
+      // the element binding belongs to the bound vertex array
+      glState().bindVertexArray(0);
       
       // Load data into vertex buffers
       glBindBuffer(GL_ARRAY_BUFFER, vbo);
-      
-      // glVertex is a plain struct: sequential layout, safe to pass directly to the GPU.
-      glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(ogl::glVertex), vertices.data(), GL_STATIC_DRAW);
 
+      isPackedInGpu = isPacking && canPack();
+
+      if(isPackedInGpu) {
+
+        packingBox(box, packCenter, packExtent);
+
+        std::vector<glPackedVertex> packed = pack(packCenter, packExtent);
+
+        glBufferData(GL_ARRAY_BUFFER, packed.size() * sizeof(glPackedVertex), packed.data(), GL_STATIC_DRAW);
+
+      } else {
+
+        // glVertex is a plain struct: sequential layout, safe to pass directly to the GPU.
+        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(ogl::glVertex), vertices.data(), GL_STATIC_DRAW);
+
+      }
+
+      // the levels of detail follow the full mesh in the same element buffer
       glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-      glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+
+      std::vector<GLuint> elements = buildDraws(draws, levelDraws, indicesType);
+
+      glBufferData(GL_ELEMENT_ARRAY_BUFFER, elements.size() * glIndices::getSize(indicesType), nullptr, GL_STATIC_DRAW);
+
+      glIndices::upload(indicesType, elements.data(), elements.size(), 0);
       
+      glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+      setAttributes(vao, vbo, isPackedInGpu);
+
+      vao.elements(ebo);
+      
+      isInitedInGpu = true;
+      
+      glCheckError();
+
+    }
+
+    //****************************************************************************//
+    // setAttributes - Describe a buffer of glVertex or glPackedVertex
+    //****************************************************************************//
+    static void setAttributes(glVertexArray & vao, GLuint buffer, bool isPacked) {
+
+      if(isPacked) {
+
+        // integers converted to float, not normalized: the shader scales them
+        vao.attribute(0, buffer, 4, GL_SHORT,      GL_FALSE, sizeof(glPackedVertex), offsetof(glPackedVertex, Position));
+        vao.attribute(1, buffer, 4, GL_BYTE,       GL_FALSE, sizeof(glPackedVertex), offsetof(glPackedVertex, Frame));
+        vao.attribute(2, buffer, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(glPackedVertex), offsetof(glPackedVertex, TexCoords));
+
+        return;
+
+      }
+
       std::size_t offset = 0;
       
       // Position
-      glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(ogl::glVertex), reinterpret_cast<void *>(offset));
-      glEnableVertexAttribArray(0);
+      vao.attribute(0, buffer, 3, GL_FLOAT, GL_FALSE, sizeof(ogl::glVertex), offset);
       offset += sizeof(float) * 3;
 
       // Normal
-      glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(ogl::glVertex), reinterpret_cast<void *>(offset));
-      glEnableVertexAttribArray(1);
+      vao.attribute(1, buffer, 3, GL_FLOAT, GL_FALSE, sizeof(ogl::glVertex), offset);
       offset += sizeof(float) * 3;
       
       // Vertex Texture Coords
-      glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(ogl::glVertex), reinterpret_cast<void *>(offset));
-      glEnableVertexAttribArray(2);
+      vao.attribute(2, buffer, 2, GL_FLOAT, GL_FALSE, sizeof(ogl::glVertex), offset);
       offset += sizeof(float) * 2;
 
       // Tangent
-      glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(ogl::glVertex), reinterpret_cast<void *>(offset));
-      glEnableVertexAttribArray(3);
+      vao.attribute(3, buffer, 3, GL_FLOAT, GL_FALSE, sizeof(ogl::glVertex), offset);
       offset += sizeof(float) * 3;
 
       // Bitangent
-      glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(ogl::glVertex), reinterpret_cast<void *>(offset));
-      glEnableVertexAttribArray(4);
-
-      glBindBuffer(GL_ARRAY_BUFFER, 0);
-      glBindVertexArray(0);
-      
-      glCheckError();
-
-      material.setInGpu();
-      
-      isInitedInGpu = true;
-      
-      glCheckError();
+      vao.attribute(4, buffer, 3, GL_FLOAT, GL_FALSE, sizeof(ogl::glVertex), offset);
 
     }
     
@@ -330,9 +667,7 @@ namespace ogl {
         glDeleteBuffers(1, &vbo);
         glDeleteBuffers(1, &ebo);
 
-        glDeleteVertexArrays(1, &vao);
-
-        material.cleanInGpu();
+        vao.clear();
 
         isInitedInGpu = false;
 
@@ -340,20 +675,306 @@ namespace ogl {
 
     }
 
+    //****************************************************************************//
+    // buildDraws() - split every level into runs of whole triangles spanning
+    //                less than 65535 vertices, drawn as 16 bit indices from a
+    //                base vertex. Returns the indices to upload, with their
+    //                draws (levelDraws[level] is the first one of a level,
+    //                offsets from the start of the returned indices) and type.
+    //                Meshes needing too many runs (vertices not in order of
+    //                use, see glOptimize) keep 32 bit indices, one draw per level.
+    //****************************************************************************//
+    std::vector<GLuint> buildDraws(std::vector<Draw_t> & draws, std::vector<GLuint> & levelDraws, GLenum & type) const {
+
+      std::vector<GLuint> elements;
+      elements.reserve(indices.size() + lodIndices.size());
+
+      draws.clear();
+      levelDraws.clear();
+
+      bool isSplit = true;
+
+      for(std::size_t level=0; level<lods.size() && isSplit; ++level) {
+
+        const GLuint * list = (level == 0) ? indices.data() : &lodIndices[lods[level].offset - indices.size()];
+
+        std::size_t count = lods[level].count - lods[level].count % 3;
+
+        levelDraws.push_back((GLuint) draws.size());
+
+        for(std::size_t first=0; first<count; ) {
+
+          GLuint min = list[first], max = list[first];
+
+          std::size_t last = first;
+
+          for(; last<count; last+=3) {
+
+            GLuint newMin = std::min(min, std::min(list[last], std::min(list[last+1], list[last+2])));
+            GLuint newMax = std::max(max, std::max(list[last], std::max(list[last+1], list[last+2])));
+
+            if(newMax - newMin >= glIndices::RESTART16) break;
+
+            min = newMin; max = newMax;
+
+          }
+
+          // a single triangle wider than 16 bits
+          if(last == first) { isSplit = false; break; }
+
+          draws.push_back(Draw_t{ (GLsizei) (last - first), (GLuint) (elements.size() * sizeof(uint16_t)), (GLint) min });
+
+          for(std::size_t i=first; i<last; ++i) elements.push_back(list[i] - min);
+
+          first = last;
+
+        }
+
+      }
+
+      // more than a draw every 256 triangles on average costs more than it saves
+      if(isSplit && draws.size() <= lods.size() + (indices.size() + lodIndices.size()) / (3 * 256)) {
+        levelDraws.push_back((GLuint) draws.size());
+        type = GL_UNSIGNED_SHORT;
+        return elements;
+      }
+
+      draws.clear();
+      levelDraws.clear();
+      elements.clear();
+
+      for(std::size_t level=0; level<lods.size(); ++level) {
+        levelDraws.push_back((GLuint) draws.size());
+        draws.push_back(Draw_t{ (GLsizei) lods[level].count, (GLuint) (lods[level].offset * sizeof(GLuint)), 0 });
+      }
+
+      levelDraws.push_back((GLuint) draws.size());
+
+      elements.insert(elements.end(), indices.begin(), indices.end());
+      elements.insert(elements.end(), lodIndices.begin(), lodIndices.end());
+
+      type = GL_UNSIGNED_INT;
+
+      return elements;
+
+    }
+
+    //****************************************************************************//
+    // packingBox() - center and half size to quantize a box in; a flat box
+    //                still needs a non zero scale
+    //****************************************************************************//
+    static void packingBox(const glAABB & bounds, glm::vec3 & center, glm::vec3 & extent) {
+
+      center = bounds.getCenter();
+      extent = bounds.getSize() * 0.5f;
+
+      for(int k=0; k<3; ++k) if(extent[k] <= 0.0f) extent[k] = 1.0f;
+
+    }
+
+    //****************************************************************************//
+    // pack() - the vertices as glPackedVertex, quantized in center +- extent
+    //          (a box containing the mesh, see packingBox())
+    //****************************************************************************//
+    std::vector<glPackedVertex> pack(const glm::vec3 & center, const glm::vec3 & extent) const {
+
+      std::vector<glPackedVertex> packed(vertices.size());
+
+      for(std::size_t i=0; i<vertices.size(); ++i) {
+
+        const glVertex & vertex = vertices[i];
+
+        glm::vec3 position = glm::clamp((vertex.Position - center) / extent, -1.0f, 1.0f);
+
+        for(int k=0; k<3; ++k) packed[i].Position[k] = (int16_t) std::lround(position[k] * 32767.0f);
+
+        // handedness of the tangent frame, the bitangent is rebuilt as sign * cross(N, T)
+        bool isMirrored = glm::dot(glm::cross(vertex.Normal, vertex.Tangent), vertex.Bitangent) < 0.0f;
+
+        packed[i].Position[3] = isMirrored ? -32767 : 32767;
+
+        glm::vec2 normal  = octEncode(vertex.Normal);
+        glm::vec2 tangent = octEncode(vertex.Tangent);
+
+        packed[i].Frame[0] = (int8_t) std::lround(normal.x  * 127.0f);
+        packed[i].Frame[1] = (int8_t) std::lround(normal.y  * 127.0f);
+        packed[i].Frame[2] = (int8_t) std::lround(tangent.x * 127.0f);
+        packed[i].Frame[3] = (int8_t) std::lround(tangent.y * 127.0f);
+
+        packed[i].TexCoords[0] = toHalf(vertex.TexCoords.x);
+        packed[i].TexCoords[1] = toHalf(vertex.TexCoords.y);
+
+      }
+
+      return packed;
+
+    }
+
   private:
 
+    //****************************************************************************//
+    // octEncode() - unit vector folded onto the [-1,1]^2 octahedron square
+    //****************************************************************************//
+    static glm::vec2 octEncode(const glm::vec3 & v) {
+
+      float length = std::fabs(v.x) + std::fabs(v.y) + std::fabs(v.z);
+
+      if(length == 0.0f) return glm::vec2(0.0f);
+
+      glm::vec2 e(v.x / length, v.y / length);
+
+      if(v.z < 0.0f) {
+        glm::vec2 folded((1.0f - std::fabs(e.y)) * (e.x >= 0.0f ? 1.0f : -1.0f),
+                         (1.0f - std::fabs(e.x)) * (e.y >= 0.0f ? 1.0f : -1.0f));
+        e = folded;
+      }
+
+      return e;
+
+    }
+
+    //****************************************************************************//
+    // toHalf() - IEEE 754 half float, rounded to nearest
+    //****************************************************************************//
+    static uint16_t toHalf(float value) {
+
+      uint32_t bits; memcpy(&bits, &value, sizeof(bits));
+
+      uint16_t sign = (bits >> 16) & 0x8000;
+
+      int32_t exponent = (int32_t) ((bits >> 23) & 0xFF) - 127 + 15;
+
+      uint32_t mantissa = bits & 0x7FFFFF;
+
+      if(((bits >> 23) & 0xFF) == 0xFF) return sign | 0x7C00 | (mantissa ? 0x200 : 0); // inf / nan
+
+      if(exponent >= 31) return sign | 0x7C00;                                             // overflow
+
+      if(exponent <= 0) {                                                                  // subnormal or zero
+        if(exponent < -10) return sign;
+        mantissa |= 0x800000;
+        uint32_t shift = 14 - exponent;
+        uint32_t half = mantissa >> shift;
+        if((mantissa >> (shift - 1)) & 1) ++half;
+        return sign | (uint16_t) half;
+      }
+
+      uint32_t half = ((uint32_t) exponent << 10) | (mantissa >> 13);
+
+      // round to nearest, a carry into the exponent is still correct
+      if(mantissa & 0x1000) ++half;
+
+      return sign | (uint16_t) half;
+
+    }
+
+    //****************************************************************************//
+    // write() / read() - a vector of plain structs, prefixed by its size
+    //****************************************************************************//
+    template <typename T>
+    static void write(std::vector<char> & data, const std::vector<T> & values) {
+
+      uint64_t size = values.size();
+
+      data.insert(data.end(), (const char *) &size, (const char *) &size + sizeof(size));
+      data.insert(data.end(), (const char *) values.data(), (const char *) (values.data() + values.size()));
+
+    }
+
+    template <typename T>
+    static bool read(const char * & data, const char * end, std::vector<T> & values) {
+
+      uint64_t size;
+
+      if(end - data < (std::ptrdiff_t) sizeof(size)) return false;
+
+      memcpy(&size, data, sizeof(size)); data += sizeof(size);
+
+      if((uint64_t) (end - data) / sizeof(T) < size) return false;
+
+      values.resize(size);
+
+      memcpy(values.data(), data, size * sizeof(T)); data += size * sizeof(T);
+
+      return true;
+
+    }
+
+    //****************************************************************************//
+    // intersect() - Moller-Trumbore ray/triangle test, both faces
+    //****************************************************************************//
+    bool intersect(uint32_t triangle, const glm::vec3 & origin, const glm::vec3 & dir, float & tMax, glm::vec3 & barycentrics) const {
+
+      const glm::vec3 & v0 = vertices[indices[3*triangle+0]].Position;
+      const glm::vec3 & v1 = vertices[indices[3*triangle+1]].Position;
+      const glm::vec3 & v2 = vertices[indices[3*triangle+2]].Position;
+
+      glm::vec3 edge1 = v1 - v0;
+      glm::vec3 edge2 = v2 - v0;
+
+      glm::vec3 p = glm::cross(dir, edge2);
+
+      float det = glm::dot(edge1, p);
+
+      if(std::fabs(det) < 1e-12f) return false; // ray parallel to the triangle
+
+      float invDet = 1.0f / det;
+
+      glm::vec3 s = origin - v0;
+
+      float u = glm::dot(s, p) * invDet;
+      if(u < 0.0f || u > 1.0f) return false;
+
+      glm::vec3 q = glm::cross(s, edge1);
+
+      float v = glm::dot(dir, q) * invDet;
+      if(v < 0.0f || u + v > 1.0f) return false;
+
+      float t = glm::dot(edge2, q) * invDet;
+      if(t < 0.0f || t >= tMax) return false;
+
+      tMax = t;
+      barycentrics = glm::vec3(1.0f - u - v, u, v);
+
+      return true;
+
+    }
+
+    //****************************************************************************//
+    // updateBounds() - recompute the cached bounds from the vertices
+    //****************************************************************************//
+    void updateBounds() {
+
+      box = glAABB();
+
+      for(std::size_t i=0; i<vertices.size(); ++i) box.expand(vertices[i].Position);
+
+    }
+
     //****************************************************************************//
     // moveFrom() - transfer ownership and neutralize the source object
     //****************************************************************************//
     void moveFrom(glMesh && other) {
 
       id            = other.id;
-      vao           = other.vao;
+      vao           = std::move(other.vao);
       vbo           = other.vbo;
       ebo           = other.ebo;
       vertices      = std::move(other.vertices);
       indices       = std::move(other.indices);
-      material      = std::move(other.material);
+      box           = other.box;
+      bvh           = std::move(other.bvh);
+      lods          = std::move(other.lods);
+      lodIndices    = std::move(other.lodIndices);
+      acmr[0]       = other.acmr[0];
+      acmr[1]       = other.acmr[1];
+      draws         = std::move(other.draws);
+      levelDraws    = std::move(other.levelDraws);
+      indicesType   = other.indicesType;
+      isPackedInGpu = other.isPackedInGpu;
+      packCenter    = other.packCenter;
+      packExtent    = other.packExtent;
+      materialIndex = other.materialIndex;
       isInited      = other.isInited;
       isInitedInGpu = other.isInitedInGpu;
       name          = std::move(other.name);
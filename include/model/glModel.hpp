@@ -27,9 +27,16 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <cstdint>
 
 #include <vector>
 #include <string>
+#include <algorithm>
+
+#include <sys/stat.h>
+#include <atomic>
+#include <thread>
 
 
 //****************************************************************************/
@@ -41,20 +48,171 @@ namespace ogl {
   // glModel
   //****************************************************************************/
   // A renderable 3D model loaded from disk through Assimp. A model is a list of
-  // meshes (each with its own material) sharing a single light and the "model"
-  // shader. On construction the file is imported, triangulated and (optionally)
-  // normalized so that its bounding radius equals 'normalizeTo'.
+  // meshes sharing a single light and the "model" shader, and the list of the
+  // scene materials they refer to by index. On construction the file is
+  // imported, triangulated and (optionally) normalized so that its bounding
+  // radius equals 'normalizeTo'.
+  //
+  // Identical scene materials are merged at import. The parameters of all the
+  // materials live in one uniform buffer, one aligned glMaterial::Record_t
+  // each: selecting the material of a mesh is a glBindBufferRange() plus its
+  // texture binds, skipped when consecutive meshes share the material.
+  //
+  // Meshes whose bounding box lies outside the camera frustum are skipped
+  // before any state, uniform or texture work; the bounds are computed once
+  // at import (and again after normalization) and kept in each glMesh.
+  //
+  // At import a two level glBVH is built: one over the triangles of every
+  // mesh (in parallel, one mesh per thread) and one over the meshes. The top
+  // level drives the frustum culling, both serve raycast().
+  //
+  // With the GENERATE_LOD import flag every mesh also gets a chain of
+  // simplified levels; render() draws the coarsest one whose error, projected
+  // at the mesh distance, stays under the pixel threshold. OPTIMIZE reorders
+  // triangles and vertices for the GPU caches, getACMR(false) / getACMR(true)
+  // tell the vertex cache miss ratio before and after. When ogl::cache is
+  // enabled the result of both is saved and reused by the next import of the
+  // same file.
+  // PACK_VERTICES uploads the meshes that allow it as 16 byte glPackedVertex,
+  // drawn with the OGL_PACKED_VERTEX variant of the model shader.
+  //
+  // The meshes are not uploaded one by one: their vertices and indices are
+  // merged in one vertex and one element buffer per vertex format (an arena),
+  // each mesh drawing its ranges with a base vertex. render() collects the
+  // draws of the visible meshes and submits those sharing a material with one
+  // glMultiDrawElementsBaseVertex(). The packed arena is quantized in the box
+  // of all its meshes, so one pair of bounds uniforms serves every draw; a
+  // mesh much smaller than that box (see glMesh::canPack()) goes to the float
+  // arena instead of losing its precision.
+  //
+  // With setOcclusionCulling(true) the meshes are also tested against what
+  // the previous frames drew: after the color pass the box of every mesh in
+  // the frustum is drawn, front to back and without writes, inside an occlusion
+  // query. The results are read when the GPU has them, never waited for: a
+  // mesh found occluded is skipped, one whose newer query is still in flight
+  // is drawn under conditional rendering of that query. Queries are not
+  // shared between contexts, every window gets its own set.
+  //
+  // Without the GPU latency, a glOcclusionBuffer filled on the CPU (for
+  // instance with addOccluders(), the coarsest level of the largest meshes)
+  // and given to setOcclusionBuffer() rejects the meshes it hides.
+  //
+  // renderDepth() draws the depth alone with the depth shader, for the
+  // pre-pass of a glRenderQueue; the render() that follows it reuses its
+  // culling and level choices instead of collecting them again.
   //****************************************************************************/
   class glModel : public glObject {
 
+  public:
+
+    // import options of init(), or-ed together
+    enum IMPORT { DEFAULT = 0, GENERATE_LOD = 1 << 0, OPTIMIZE = 1 << 1, OPTIMIZE_OVERDRAW = 1 << 2, PACK_VERTICES = 1 << 3 };
+
   private:
 
     // The meshes that make up the model.
     std::vector<glMesh> meshes;
 
+    // The materials the meshes refer to.
+    std::vector<glMaterial> materials;
+
+    // Uniform buffer with the material records, materialStride bytes apart.
+    GLuint materialUbo = 0;
+    GLsizeiptr materialStride = 0;
+
+    // Program whose samplers were last pointed to the material texture units.
+    GLuint samplersProgram = 0;
+
+    // Model shader for the meshes uploaded as glPackedVertex (PACK_VERTICES).
+    glShader packedShader;
+    glShader packedDepthShader;
+    GLuint packedSamplersProgram = 0;
+    bool isPackingVertices = false;
+
+    // The merged buffers of the meshes, arenas[1] holds the glPackedVertex ones.
+    struct Arena_t {
+      glVertexArray vao;
+      GLuint vbo = 0;
+      GLuint ebo = 0;
+      GLenum type = GL_UNSIGNED_INT;
+      bool isEmpty = true;
+    };
+
+    Arena_t arenas[2];
+
+    // Box the packed arena is quantized in.
+    glm::vec3 packCenter = glm::vec3(0.0f);
+    glm::vec3 packExtent = glm::vec3(1.0f);
+
+    // The draws of the meshes in their arena: the ones of level l of mesh i
+    // go from levelDraws[meshLevels[i] + l] to levelDraws[meshLevels[i] + l + 1].
+    std::vector<glMesh::Draw_t> draws;
+    std::vector<GLuint> levelDraws;
+    std::vector<GLuint> meshLevels;
+    std::vector<uint8_t> meshArena;
+
+    // Draws of the visible meshes, one batch per arena and material.
+    struct Batch_t {
+      std::vector<GLsizei> counts;
+      std::vector<const void *> offsets;
+      std::vector<GLint> baseVertices;
+    };
+
+    std::vector<Batch_t> batches;
+    std::size_t drawCallsCounter = 0;
+
+    // Occlusion culling: a query per mesh and window, and the last result read.
+    enum OCCLUSION : uint8_t { UNKNOWN, VISIBLE, OCCLUDED };
+
+    struct Occlusion_t {
+      uint32_t windowID;
+      std::vector<GLuint> queries;
+      std::vector<uint8_t> isPending;
+      std::vector<uint8_t> result;
+    };
+
+    bool isOcclusionCulling = false;
+    std::vector<Occlusion_t> occlusions;
+    std::size_t occludedCounter = 0;
+
+    // Software occlusion buffer of the frame, not owned (setOcclusionBuffer).
+    const glOcclusionBuffer * occlusionBuffer = nullptr;
+
+    // Meshes from the largest bounding sphere down (addOccluders).
+    std::vector<uint32_t> occluders;
+
+    // The boxes of the meshes (8 corners each), the proxies of the queries.
+    glShader depthShader;
+    glVertexArray boxesVao;
+    GLuint boxesVbo = 0;
+    GLuint boxesEbo = 0;
+
+    // Meshes in the frustum front to back, those drawn under conditional
+    // rendering (mesh, level) and those to query, in the last render().
+    std::vector<std::pair<float, uint32_t>> order;
+    std::vector<std::pair<uint32_t, uint32_t>> conditionals;
+    std::vector<uint32_t> queried;
+
     // The light used to shade every mesh of this model.
     ogl::glLight light;
 
+    // Union of the mesh bounds, in model space.
+    glAABB box;
+
+    // Hierarchy over the mesh bounds, and the meshes it found visible.
+    glBVH bvh;
+    std::vector<uint8_t> isMeshVisible;
+
+    // Frustum culling of the meshes and its counters for the last render().
+    bool isCulling = true;
+    bool isPrePassed = false;
+    std::size_t visibleCounter = 0;
+    std::size_t culledCounter  = 0;
+
+    // Largest projected error, in pixels, of the level of detail drawn.
+    float lodThreshold = 1.0f;
+    std::size_t trianglesCounter = 0;
+
   public:
     
     //****************************************************************************/
@@ -65,7 +223,7 @@ namespace ogl {
     //****************************************************************************/
     // glModel() - Constructor, expects a filepath to a 3D model
     //****************************************************************************/
-    glModel(const std::string & path, GLfloat sizeFactor = 1.0) : glObject() { init(path, sizeFactor); }
+    glModel(const std::string & path, GLfloat sizeFactor = 1.0, int flags = DEFAULT) : glObject() { init(path, sizeFactor, flags); }
     
     //****************************************************************************/
     // ~glModel() -
@@ -78,7 +236,7 @@ namespace ogl {
     //****************************************************************************/
     // init
     //****************************************************************************/
-    void init(std::string path, GLfloat normalizeTo = 1.0f) {
+    void init(std::string path, GLfloat normalizeTo = 1.0f, int flags = DEFAULT) {
                 
       name = ogl::io::name(path);
       
@@ -86,6 +244,18 @@ namespace ogl {
 
       shader.setName(name);
       shader.initModel();
+
+      isPackingVertices = (flags & PACK_VERTICES) != 0;
+
+      if(isPackingVertices) {
+        packedShader.setName(name);
+        packedShader.initModel("#define OGL_PACKED_VERTEX");
+        packedDepthShader.setName(name);
+        packedDepthShader.initDepth("#define OGL_PACKED_VERTEX");
+      }
+
+      depthShader.setName(name);
+      depthShader.initDepth();
       
       ogl::io::expandPath(path);
 
@@ -109,13 +279,42 @@ namespace ogl {
       // Retrieve the directory path of the filepath
       std::string directory = path.substr(0, path.find_last_of('/'));
       
+      // Load the materials, then the meshes referring to them
+      std::vector<GLuint> materialIndices = processMaterials(scene, directory);
+
       // Process ASSIMP's root node recursively
-      processNode(scene->mRootNode, scene, directory);
+      processNode(scene->mRootNode, scene, materialIndices);
       
       // isInited must be set before normalize() so getBounds() doesn't abort.
       isInited = true;
 
-      if(normalizeTo !=0) normalize(normalizeTo);
+      bool isProcessing = (flags & (GENERATE_LOD | OPTIMIZE | OPTIMIZE_OVERDRAW)) != 0;
+
+      uint64_t key = cacheKey(path, normalizeTo, flags);
+
+      // the cached meshes are already normalized and processed
+      bool isCached = isProcessing && loadCache(key);
+
+      if(meshes.empty()) processNode(scene->mRootNode, scene, materialIndices);
+
+      if(!isCached && normalizeTo !=0) normalize(normalizeTo);
+
+      updateBounds();
+
+      // the slow part of the import, one mesh per thread
+      forEachMesh([flags, isCached](glMesh & mesh) {
+        if(!isCached && (flags & GENERATE_LOD)) mesh.generateLods();
+        if(!isCached && (flags & (OPTIMIZE | OPTIMIZE_OVERDRAW))) mesh.optimize(flags & OPTIMIZE_OVERDRAW);
+        mesh.buildBVH();
+      });
+
+      if(isProcessing && !isCached) storeCache(key);
+
+      buildBVH();
+
+      if(flags & (OPTIMIZE | OPTIMIZE_OVERDRAW)) {
+        DEBUG_LOG("glModel::init(" + name + ") ACMR " + std::to_string(getACMR(false)) + " -> " + std::to_string(getACMR(true)));
+      }
       
     }
     
@@ -133,10 +332,29 @@ namespace ogl {
     // render() - Render the model, and thus all its meshes
     //****************************************************************************/
     void render(const glCamera & camera) {
-            
+
+      if(!isInited){
+        fprintf(stderr, "ERROR [glModel]: must be initialized before rendering\n");
+        abort();
+      }
+
+      // after renderDepth() the meshes and levels are those of the pre-pass,
+      // the depth of the two passes must match
+      bool isVisible = isPrePassed || collect(camera);
+
+      isPrePassed = false;
+
+      if(!isVisible) return;
+
       renderBegin(camera);
-      
-      for(std::size_t i=0; i<meshes.size(); ++i) meshes[i].render(shader);
+
+      renderBatches(false);
+
+      if(isOcclusionCulling) {
+        Occlusion_t & occlusion = getOcclusion();
+        renderConditionals(occlusion, false);
+        issueQueries(occlusion);
+      }
       
       renderEnd();
       
@@ -144,6 +362,155 @@ namespace ogl {
       
     }
 
+    //****************************************************************************/
+    // renderDepth() - Depth only pre-pass of the next render(), with the same
+    //                 meshes and levels (the color writes are masked by the
+    //                 caller, glRenderQueue does it, and render() is then
+    //                 drawn without depth writes)
+    //****************************************************************************/
+    void renderDepth(const glCamera & camera) {
+
+      if(!isInited){
+        fprintf(stderr, "ERROR [glModel]: must be initialized before rendering\n");
+        abort();
+      }
+
+      isPrePassed = collect(camera);
+
+      if(!isPrePassed) return;
+
+      setInFrame(camera);
+
+      glState().enable(GL_CULL_FACE);
+      glState().cullFace(GL_BACK);
+
+      glState().polygonMode(GL_FILL);
+
+      glState().enable(GL_DEPTH_TEST);
+      glState().depthFunc(GL_LEQUAL);
+
+      renderBatches(true);
+
+      if(isOcclusionCulling) renderConditionals(getOcclusion(), true);
+
+      renderEnd();
+
+      glCheckError();
+
+    }
+
+  private:
+
+    //****************************************************************************/
+    // collect() - Cull the meshes, choose their level and gather their draws
+    //             in the batches; false when the whole model is culled
+    //****************************************************************************/
+    bool collect(const glCamera & camera) {
+
+      if(isToInitInGpu()) initInGpu();
+
+      visibleCounter   = 0;
+      culledCounter    = 0;
+      trianglesCounter = 0;
+      drawCallsCounter = 0;
+      occludedCounter  = 0;
+
+      glm::mat4 clip = camera.getProjection() * camera.getView() * modelMatrix;
+
+      // the planes are extracted in model space, so the cached bounds are tested as they are
+      glFrustum frustum(clip);
+
+      if(isCulling && !frustum.isVisible(box)) { culledCounter = meshes.size(); return false; }
+
+      // walk the hierarchy, the meshes are then drawn in their order to keep the material runs
+      if(isCulling) {
+        std::fill(isMeshVisible.begin(), isMeshVisible.end(), 0);
+        bvh.cull(frustum, [&](uint32_t index, bool inside) {
+          isMeshVisible[index] = inside || frustum.isVisible(meshes[index].getAABB());
+        });
+      }
+
+      // pixels covered by a unit at unit distance; errors and distances are both
+      // measured in model space, so the scale of the model matrix cancels out
+      glm::mat4 projection = camera.getProjection();
+
+      float pixelsPerUnit = 0.5f * camera.getHeight() * projection[1][1];
+
+      bool isPerspective = (projection[2][3] != 0.0f);
+
+      glm::vec3 eye = glm::vec3(glm::inverse(modelMatrix) * glm::vec4(camera.getPosition(), 1.0f));
+
+      for(std::size_t i=0; i<batches.size(); ++i) {
+        batches[i].counts.clear();
+        batches[i].offsets.clear();
+        batches[i].baseVertices.clear();
+      }
+
+      // front to back: the occluders are drawn and queried first
+      order.clear();
+
+      for(std::size_t i=0; i<meshes.size(); ++i) {
+
+        if(isCulling && !isMeshVisible[i]) { ++culledCounter; continue; }
+
+        if(occlusionBuffer != nullptr && !occlusionBuffer->isVisible(meshes[i].getAABB(), clip)) { ++occludedCounter; continue; }
+
+        glm::vec3 offset = eye - meshes[i].getAABB().getCenter();
+
+        order.push_back(std::make_pair(glm::dot(offset, offset), (uint32_t) i));
+
+      }
+
+      std::sort(order.begin(), order.end());
+
+      Occlusion_t * occlusion = isOcclusionCulling ? &getOcclusion() : nullptr;
+
+      conditionals.clear();
+      queried.clear();
+
+      // boxes this close to the eye may be cut by the near plane: never tested
+      glm::vec3 margin = glm::vec3(camera.getzNear() / std::min(glm::length(glm::vec3(modelMatrix[0])),
+                                                      std::min(glm::length(glm::vec3(modelMatrix[1])), glm::length(glm::vec3(modelMatrix[2])))));
+
+      for(std::size_t k=0; k<order.size(); ++k) {
+
+        uint32_t i = order[k].second;
+
+        OCCLUSION test = (occlusion != nullptr) ? testOcclusion(*occlusion, i, eye, margin) : VISIBLE;
+
+        if(test == OCCLUDED && !occlusion->isPending[i]) continue;
+
+        ++visibleCounter;
+
+        std::size_t level = 0;
+
+        if(meshes[i].getLodsCount() > 1) {
+          const glAABB & bounds = meshes[i].getAABB();
+          float distance = isPerspective ? glm::length(eye - bounds.getCenter()) - bounds.getRadius() : 1.0f;
+          if(distance > 0.0f) level = meshes[i].selectLod(pixelsPerUnit / distance, lodThreshold);
+        }
+
+        trianglesCounter += meshes[i].getLod(level).count / 3;
+
+        // the newer query is in flight: the GPU decides with its result
+        if(test == OCCLUDED) { conditionals.push_back(std::make_pair(i, (uint32_t) level)); continue; }
+
+        Batch_t & batch = batches[meshArena[i] * materials.size() + meshes[i].getMaterialIndex()];
+
+        for(GLuint j=levelDraws[meshLevels[i] + level]; j<levelDraws[meshLevels[i] + level + 1]; ++j) {
+          batch.counts.push_back(draws[j].count);
+          batch.offsets.push_back((const void *)(uintptr_t) draws[j].offset);
+          batch.baseVertices.push_back(draws[j].baseVertex);
+        }
+
+      }
+
+      return true;
+
+    }
+
+  public:
+
     //****************************************************************************/
     // renderBegin()
     //****************************************************************************/
@@ -158,21 +525,19 @@ namespace ogl {
       
       if(isToInitInGpu()) initInGpu();
       
-      shader.use();
-      
-      shader.setUniform("projection", camera.getProjection());
-      shader.setUniform("view",       camera.getView());
-      shader.setUniform("model",      modelMatrix);
+      useShader(shader, samplersProgram);
+
+      setInFrame(camera);
 
-      light.setInShader(shader, camera.getView());
+      light.setInFrame(camera.getView());
 
-      glEnable(GL_CULL_FACE);
-      glCullFace(GL_BACK);
+      glState().enable(GL_CULL_FACE);
+      glState().cullFace(GL_BACK);
       
-      glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+      glState().polygonMode(GL_FILL);
       
-      glEnable(GL_DEPTH_TEST);
-      glDepthFunc(GL_LEQUAL);
+      glState().enable(GL_DEPTH_TEST);
+      glState().depthFunc(GL_LEQUAL);
       
     }
     
@@ -180,7 +545,141 @@ namespace ogl {
     //****************************************************************************/
     // renderEnd()
     //****************************************************************************/
-    void renderEnd() { glDisable(GL_CULL_FACE); }
+    void renderEnd() { glState().disable(GL_CULL_FACE); }
+
+    //****************************************************************************/
+    // setCulling() - Enable/disable the frustum culling of the meshes
+    //****************************************************************************/
+    inline void setCulling(bool value) { isCulling = value; }
+
+    //****************************************************************************/
+    // getVisibleCount() - Meshes drawn by the last render()
+    //****************************************************************************/
+    inline std::size_t getVisibleCount() const { return visibleCounter; }
+
+    //****************************************************************************/
+    // getCulledCount() - Meshes skipped by the last render()
+    //****************************************************************************/
+    inline std::size_t getCulledCount() const { return culledCounter; }
+
+    //****************************************************************************/
+    // getDrawCallsCount() - Multi draw calls issued by the last render() (and
+    //                       by its renderDepth())
+    //****************************************************************************/
+    inline std::size_t getDrawCallsCount() const { return drawCallsCounter; }
+
+    //****************************************************************************/
+    // setOcclusionCulling() - Enable/disable the occlusion queries of the meshes
+    //****************************************************************************/
+    inline void setOcclusionCulling(bool value) { isOcclusionCulling = value; }
+
+    //****************************************************************************/
+    // getOccludedCount() - Meshes found occluded in the last render(): by the
+    //                      occlusion buffer, by the queries (skipped, or left
+    //                      to conditional rendering)
+    //****************************************************************************/
+    inline std::size_t getOccludedCount() const { return occludedCounter; }
+
+    //****************************************************************************/
+    // setOcclusionBuffer() - Test the meshes against a rasterized buffer
+    //                        seen by the camera of render() (nullptr: none)
+    //****************************************************************************/
+    inline void setOcclusionBuffer(const glOcclusionBuffer * buffer) { occlusionBuffer = buffer; }
+
+    //****************************************************************************/
+    // addOccluders() - Add the coarsest level of detail of the count largest
+    //                  meshes to an occlusion buffer, placed by the model matrix
+    //****************************************************************************/
+    void addOccluders(glOcclusionBuffer & buffer, std::size_t count = SIZE_MAX) {
+
+      if(!isInited) {
+        fprintf(stderr, "ERROR [glModel]: must be initialized before calling addOccluders\n");
+        abort();
+      }
+
+      if(occluders.size() != meshes.size()) {
+
+        occluders.resize(meshes.size());
+
+        for(std::size_t i=0; i<meshes.size(); ++i) occluders[i] = (uint32_t) i;
+
+        std::stable_sort(occluders.begin(), occluders.end(), [this](uint32_t a, uint32_t b) {
+          return meshes[a].getAABB().getRadius() > meshes[b].getAABB().getRadius();
+        });
+
+      }
+
+      count = std::min(count, occluders.size());
+
+      for(std::size_t k=0; k<count; ++k) {
+
+        const glMesh & mesh = meshes[occluders[k]];
+
+        std::size_t level = mesh.getLodsCount() - 1;
+
+        if(mesh.getVertices().empty()) continue;
+
+        buffer.addOccluder(modelMatrix, &mesh.getVertices()[0].Position.x, sizeof(glVertex), mesh.getLodIndices(level), mesh.getLod(level).count);
+
+      }
+
+    }
+
+    //****************************************************************************/
+    // setLodThreshold() - Largest screen space error, in pixels, of the levels
+    //                     of detail (GENERATE_LOD)
+    //****************************************************************************/
+    inline void setLodThreshold(float pixels) { lodThreshold = pixels; }
+
+    //****************************************************************************/
+    // getTrianglesCount() - Triangles drawn by the last render()
+    //****************************************************************************/
+    inline std::size_t getTrianglesCount() const { return trianglesCounter; }
+
+    //****************************************************************************/
+    // getACMR() - Vertex cache miss ratio of the meshes, weighted by their
+    //             triangles, before or after the OPTIMIZE import flag
+    //****************************************************************************/
+    float getACMR(bool isOptimized = true) const {
+
+      double misses = 0.0;
+      std::size_t trianglesCount = 0;
+
+      for(std::size_t i=0; i<meshes.size(); ++i) {
+        misses += (double) meshes[i].getACMR(isOptimized) * meshes[i].getTrianglesCount();
+        trianglesCount += meshes[i].getTrianglesCount();
+      }
+
+      return (trianglesCount > 0) ? (float) (misses / trianglesCount) : 0.0f;
+
+    }
+
+    //****************************************************************************/
+    // getLodsCount() - Levels of detail of the most detailed chain (1 without LOD)
+    //****************************************************************************/
+    std::size_t getLodsCount() const {
+
+      std::size_t count = 0;
+
+      for(std::size_t i=0; i<meshes.size(); ++i) count = std::max(count, meshes[i].getLodsCount());
+
+      return count;
+
+    }
+
+    //****************************************************************************/
+    // getLodTrianglesCount() - Triangles of the model at a level of detail (the
+    //                          meshes with a shorter chain use their last level)
+    //****************************************************************************/
+    std::size_t getLodTrianglesCount(std::size_t level) const {
+
+      std::size_t count = 0;
+
+      for(std::size_t i=0; i<meshes.size(); ++i) count += meshes[i].getLod(level).count / 3;
+
+      return count;
+
+    }
     
     //****************************************************************************/
     // getBounds() - Compute the bounds of the model (center, size, radius)
@@ -192,38 +691,56 @@ namespace ogl {
         abort();
       }
 
-      if(meshes.empty()) {
+      glAABB bounds;
+
+      for(std::size_t i=0; i<meshes.size(); ++i) bounds.expand(meshes[i].getAABB());
+
+      if(bounds.isEmpty()) {
         center = glm::vec3(0.0f);
         size = glm::vec3(0.0f);
         radius = 0.0f;
         return;
       }
 
-      glm::vec3 min_bound(+FLT_MAX);
-      glm::vec3 max_bound(-FLT_MAX);
+      center = bounds.getCenter();
+      size   = bounds.getSize();
+      radius = bounds.getRadius();
+      
+    }
+
+    
+    //****************************************************************************/
+    // raycast() - Closest triangle hit by origin + t * dir (world space), t >= 0
+    //****************************************************************************/
+    glRayHit raycast(const glm::vec3 & origin, const glm::vec3 & dir) const {
+
+      if(!isInited) {
+        fprintf(stderr, "ERROR [glModel]: must be initialized before calling raycast\n");
+        abort();
+      }
+
+      glRayHit hit;
 
-      for(std::size_t i=0; i<meshes.size(); ++i) {
+      // an affine transform keeps the ray parameter: t is the same in both spaces
+      glm::mat4 inverse = glm::inverse(modelMatrix);
 
-        glm::vec3 tmp_center, tmp_size;
-        float tmp_radius;
+      glm::vec3 localOrigin = glm::vec3(inverse * glm::vec4(origin, 1.0f));
+      glm::vec3 localDir    = glm::vec3(inverse * glm::vec4(dir,    0.0f));
 
-        meshes[i].bounds(tmp_center, tmp_size, tmp_radius);
+      float tMax = FLT_MAX;
 
-        glm::vec3 half_size = tmp_size * 0.5f;
-        glm::vec3 local_min = tmp_center - half_size;
-        glm::vec3 local_max = tmp_center + half_size;
+      bvh.raycast(localOrigin, localDir, tMax, [&](uint32_t index, float & t) {
+        if(meshes[index].raycast(localOrigin, localDir, t, hit.triangle, hit.barycentrics)) hit.mesh = (int) index;
+      });
 
-        min_bound = glm::min(min_bound, local_min);
-        max_bound = glm::max(max_bound, local_max);
-        
+      if(hit.isHit()) {
+        hit.distance = tMax;
+        hit.position = origin + tMax * dir;
       }
 
-      center = (min_bound + max_bound) * 0.5f;
-      size   = (max_bound - min_bound);
-      radius = glm::length(size) * 0.5f;
-      
-    }
+      return hit;
 
+    }
     
     //****************************************************************************/
     // getRadius() - Compute the radius of the model
@@ -247,7 +764,34 @@ namespace ogl {
       
       _setInGpu();
 
-      for(std::size_t i=0; i<meshes.size(); ++i) meshes[i].setInGpu();
+      for(std::size_t i=0; i<materials.size(); ++i) materials[i].setInGpu();
+
+      setArenas();
+
+      // Records are bound with glBindBufferRange, whose offset must be a
+      // multiple of the uniform buffer offset alignment.
+      GLint alignment = 0;
+      glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+      if(alignment <= 0) alignment = 256;
+
+      materialStride = ((sizeof(glMaterial::Record_t) + alignment - 1) / alignment) * alignment;
+
+      std::vector<char> records(materialStride * materials.size(), 0);
+
+      for(std::size_t i=0; i<materials.size(); ++i) {
+        glMaterial::Record_t record = materials[i].getRecord();
+        memcpy(&records[i * materialStride], &record, sizeof(glMaterial::Record_t));
+      }
+
+      glGenBuffers(1, &materialUbo);
+      glBindBuffer(GL_UNIFORM_BUFFER, materialUbo);
+      glBufferData(GL_UNIFORM_BUFFER, records.size(), records.data(), GL_STATIC_DRAW);
+      glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+      samplersProgram = 0;
+      packedSamplersProgram = 0;
+
+      glCheckError();
       
     }
     
@@ -263,44 +807,605 @@ namespace ogl {
     
     
   private:
-        
+
     //****************************************************************************/
-    // normalize() - Normalize and set the center of the model
+    // updateBounds() - Union of the cached mesh bounds
     //****************************************************************************/
-    void normalize(double normalizeTo) {
-            
-      glm::vec3 center; glm::vec3 size; float radius = 0.0f;
-      
-      getBounds(center, size, radius);
+    void updateBounds() {
 
-      if(radius <= 0.0f) return; // degenerate model (e.g. single point): nothing to normalize
+      box = glAABB();
 
-      double scalingFactor = normalizeTo / radius;
+      for(std::size_t i=0; i<meshes.size(); ++i) box.expand(meshes[i].getAABB());
 
-      for(std::size_t i=0; i<meshes.size(); ++i)
-        meshes[i].scale(scalingFactor, glm::vec3(0.0f));
-      
     }
-    
+        
     //****************************************************************************/
-    // processNode() - Processes a node in a recursive fashion. Processes each individual mesh
-    //                 located at the node and repeats this process on its children nodes (if any)
+    // forEachMesh() - Run work(mesh) on every mesh, spread over the hardware threads
     //****************************************************************************/
-    void processNode(const aiNode * node, const aiScene * scene, const std::string & path) {
-            
-      // Process each mesh attached to this node.
-      for(GLuint i=0; i<node->mNumMeshes; ++i) {
+    template <typename F>
+    void forEachMesh(F work) {
+
+      std::size_t workers = std::min<std::size_t>(meshes.size(), std::max(1u, std::thread::hardware_concurrency()));
+
+      std::atomic<std::size_t> next(0);
+
+      auto worker = [&]() {
+        for(std::size_t i = next++; i < meshes.size(); i = next++) work(meshes[i]);
+      };
+
+      std::vector<std::thread> threads;
+
+      for(std::size_t i=1; i<workers; ++i) threads.emplace_back(worker);
+
+      worker();
+
+      for(std::size_t i=0; i<threads.size(); ++i) threads[i].join();
+
+    }
+
+    //****************************************************************************/
+    // cacheKey() - Key of the processed meshes: the file, its size and time,
+    //              the import options and what Assimp made of it
+    //****************************************************************************/
+    uint64_t cacheKey(const std::string & path, GLfloat normalizeTo, int flags) const {
+
+      // bump when the processing or the layout of the data changes
+      const uint32_t version = 1;
+
+      struct stat info;
+
+      uint64_t stamp[2] = { 0, 0 };
+
+      if(stat(path.c_str(), &info) == 0) { stamp[0] = (uint64_t) info.st_size; stamp[1] = (uint64_t) info.st_mtime; }
+
+      uint64_t key = ogl::cache::hash(path);
+
+      key = ogl::cache::hash(stamp,        sizeof(stamp),       key);
+      key = ogl::cache::hash(&normalizeTo, sizeof(normalizeTo), key);
+      key = ogl::cache::hash(&flags,       sizeof(flags),       key);
+      key = ogl::cache::hash(&version,     sizeof(version),     key);
+
+      uint64_t layout = sizeof(glVertex);
+
+      key = ogl::cache::hash(&layout, sizeof(layout), key);
+
+      for(std::size_t i=0; i<meshes.size(); ++i) {
+        uint64_t counts[2] = { meshes[i].getVertices().size(), meshes[i].getTrianglesCount() };
+        key = ogl::cache::hash(counts, sizeof(counts), key);
+      }
+
+      return key;
+
+    }
+
+    //****************************************************************************/
+    // loadCache() - Restore the processed meshes, false on a miss. A corrupted
+    //               entry leaves no meshes, to be imported again.
+    //****************************************************************************/
+    bool loadCache(uint64_t key) {
+
+      std::vector<char> data;
+
+      if(!ogl::cache::load("model", key, data)) return false;
+
+      const char * begin = data.data();
+      const char * end   = data.data() + data.size();
+
+      for(std::size_t i=0; i<meshes.size(); ++i) {
+
+        if(!meshes[i].load(begin, end)) {
+          fprintf(stderr, "WARNING [glModel]: corrupted cache entry of '%s', importing again\n", name.c_str());
+          meshes.clear();
+          return false;
+        }
+
+      }
+
+      return true;
+
+    }
+
+    //****************************************************************************/
+    // storeCache() - Save the processed meshes
+    //****************************************************************************/
+    void storeCache(uint64_t key) const {
+
+      if(!ogl::cache::isEnabled()) return;
+
+      std::vector<char> data;
+
+      for(std::size_t i=0; i<meshes.size(); ++i) meshes[i].save(data);
+
+      if(!ogl::cache::store("model", key, data.data(), data.size()))
+        fprintf(stderr, "WARNING [glModel]: processed meshes not saved in the cache\n");
+
+    }
+
+    //****************************************************************************/
+    // buildBVH() - Build the hierarchy over the meshes (their triangle
+    //              hierarchies must be built)
+    //****************************************************************************/
+    void buildBVH() {
+
+      std::vector<glAABB> boxes(meshes.size());
+
+      for(std::size_t i=0; i<meshes.size(); ++i) boxes[i] = meshes[i].getAABB();
+
+      bvh.build(boxes);
+
+      isMeshVisible.assign(meshes.size(), 1);
+
+    }
+        
+    //****************************************************************************/
+    // normalize() - Normalize and set the center of the model
+    //****************************************************************************/
+    void normalize(double normalizeTo) {
+            
+      glm::vec3 center; glm::vec3 size; float radius = 0.0f;
+      
+      getBounds(center, size, radius);
+
+      if(radius <= 0.0f) return; // degenerate model (e.g. single point): nothing to normalize
+
+      double scalingFactor = normalizeTo / radius;
+
+      for(std::size_t i=0; i<meshes.size(); ++i)
+        meshes[i].scale(scalingFactor, glm::vec3(0.0f));
+      
+    }
+    
+    //****************************************************************************/
+    // processMaterials() - Load the scene materials, merging the identical ones.
+    //                      Returns the index in materials of each scene material.
+    //****************************************************************************/
+    std::vector<GLuint> processMaterials(const aiScene * scene, const std::string & path) {
+
+      std::vector<GLuint> materialIndices(scene->mNumMaterials);
+
+      for(GLuint i=0; i<scene->mNumMaterials; ++i) {
+
+        glMaterial material(scene->mMaterials[i], path);
+
+        std::size_t j = 0;
+
+        while(j < materials.size() && !materials[j].isSame(material)) ++j;
+
+        if(j == materials.size()) materials.push_back(std::move(material));
+
+        materialIndices[i] = (GLuint)j;
+
+      }
+
+      DEBUG_LOG("glModel::processMaterials(" + name + ") " + std::to_string(materials.size()) + "/" + std::to_string(scene->mNumMaterials) + " materials");
+
+      return materialIndices;
+
+    }
+
+    //****************************************************************************/
+    // useShader() - Use a model program, with its samplers and model matrix
+    //****************************************************************************/
+    void useShader(glShader & program, GLuint & samplers) {
+
+      program.use();
+
+      // the sampler units are fixed: assign them once per program
+      if(samplers != program.get()) {
+        glMaterial::setSamplers(program);
+        samplers = program.get();
+      }
+
+      program.setUniform("model", modelMatrix);
+
+    }
+
+    //****************************************************************************/
+    // setArenas() - Merge the vertices and the indices of the meshes in the
+    //               buffers of their vertex format. Indices stay 16 bit only if
+    //               every mesh of the arena allows it.
+    //****************************************************************************/
+    void setArenas() {
+
+      struct Elements_t {
+        std::vector<GLuint> indices;
+        std::vector<glMesh::Draw_t> draws;
+        std::vector<GLuint> levelDraws;
+        GLenum type;
+      };
+
+      std::vector<Elements_t> elements(meshes.size());
+
+      meshArena.assign(meshes.size(), 0);
+
+      // the box of the meshes that could be packed, then of the ones small
+      // enough in it not to lose their precision
+      glAABB packableBox;
+      glAABB packedBox;
+
+      if(isPackingVertices)
+        for(std::size_t i=0; i<meshes.size(); ++i) if(meshes[i].canPack()) packableBox.expand(meshes[i].getAABB());
+
+      bool isShort[2] = { true, true };
+
+      for(std::size_t i=0; i<meshes.size(); ++i) {
+
+        meshArena[i] = (isPackingVertices && meshes[i].canPack(packableBox)) ? 1 : 0;
+
+        if(meshArena[i]) packedBox.expand(meshes[i].getAABB());
+
+        elements[i].indices = meshes[i].buildDraws(elements[i].draws, elements[i].levelDraws, elements[i].type);
+
+        if(elements[i].type != GL_UNSIGNED_SHORT) isShort[meshArena[i]] = false;
+
+      }
+
+      glMesh::packingBox(packedBox, packCenter, packExtent);
+
+      for(int a=0; a<2; ++a) arenas[a].type = isShort[a] ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
+      // place the meshes in their arena: vertices, indices and draws rebased
+      std::vector<glVertex> vertices;
+      std::vector<glPackedVertex> packed;
+      std::vector<GLuint> indices[2];
+
+      draws.clear();
+      levelDraws.clear();
+      meshLevels.assign(meshes.size(), 0);
+
+      for(std::size_t i=0; i<meshes.size(); ++i) {
+
+        int a = meshArena[i];
+
+        std::size_t baseVertex = a ? packed.size() : vertices.size();
+        std::size_t baseIndex  = indices[a].size();
+
+        if(a) {
+          std::vector<glPackedVertex> meshPacked = meshes[i].pack(packCenter, packExtent);
+          packed.insert(packed.end(), meshPacked.begin(), meshPacked.end());
+        } else {
+          vertices.insert(vertices.end(), meshes[i].getVertices().begin(), meshes[i].getVertices().end());
+        }
+
+        const Elements_t & mesh = elements[i];
+
+        indices[a].insert(indices[a].end(), mesh.indices.begin(), mesh.indices.end());
+
+        meshLevels[i] = (GLuint) levelDraws.size();
+
+        for(std::size_t level=0; level+1<mesh.levelDraws.size(); ++level) {
+
+          levelDraws.push_back((GLuint) draws.size());
+
+          for(GLuint j=mesh.levelDraws[level]; j<mesh.levelDraws[level + 1]; ++j) {
+
+            std::size_t first = baseIndex + mesh.draws[j].offset / glIndices::getSize(mesh.type);
+
+            draws.push_back(glMesh::Draw_t{ mesh.draws[j].count,
+                                            (GLuint) (first * glIndices::getSize(arenas[a].type)),
+                                            (GLint) (mesh.draws[j].baseVertex + baseVertex) });
+
+          }
+
+        }
+
+      }
+
+      levelDraws.push_back((GLuint) draws.size());
+
+      // the element binding belongs to the bound vertex array
+      glState().bindVertexArray(0);
+
+      for(int a=0; a<2; ++a) {
+
+        std::size_t size = a ? packed.size() * sizeof(glPackedVertex) : vertices.size() * sizeof(glVertex);
+
+        if(size == 0 || indices[a].empty()) continue;
+
+        glGenBuffers(1, &arenas[a].vbo);
+        glGenBuffers(1, &arenas[a].ebo);
+
+        glBindBuffer(GL_ARRAY_BUFFER, arenas[a].vbo);
+        glBufferData(GL_ARRAY_BUFFER, size, a ? (const void *) packed.data() : (const void *) vertices.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, arenas[a].ebo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices[a].size() * glIndices::getSize(arenas[a].type), nullptr, GL_STATIC_DRAW);
+        glIndices::upload(arenas[a].type, indices[a].data(), indices[a].size(), 0);
+
+        glMesh::setAttributes(arenas[a].vao, arenas[a].vbo, a == 1);
+
+        arenas[a].vao.elements(arenas[a].ebo);
+
+        arenas[a].isEmpty = false;
+
+      }
+
+      batches.assign(2 * materials.size(), Batch_t());
+
+      DEBUG_LOG("glModel::setArenas(" + name + ") " + std::to_string(vertices.size()) + " + " + std::to_string(packed.size()) + " packed vertices");
+
+      glCheckError();
+
+    }
+
+    //****************************************************************************/
+    // useArena() - Use the program of an arena (color or depth only) and bind
+    //              its vertex array
+    //****************************************************************************/
+    void useArena(int a, bool isDepth) {
+
+      glShader & program = isDepth ? (a ? packedDepthShader : depthShader) : (a ? packedShader : shader);
+
+      // the material bindings do not depend on the program
+      if(isDepth) {
+        program.use();
+        program.setUniform("model", modelMatrix);
+      } else {
+        useShader(program, a ? packedSamplersProgram : samplersProgram);
+      }
+
+      if(a == 1) {
+        program.setUniform("boundsCenter", packCenter);
+        program.setUniform("boundsExtent", packExtent);
+      }
+
+      arenas[a].vao.bind();
+
+    }
+
+    //****************************************************************************/
+    // renderBatches() - One multi draw per arena and material collected by
+    //                   collect(), without the materials for the depth only pass
+    //****************************************************************************/
+    void renderBatches(bool isDepth) {
+
+      GLuint boundMaterial = GL_INVALID_INDEX;
+
+      for(int a=0; a<2; ++a) {
+
+        if(arenas[a].isEmpty) continue;
+
+        bool isBound = false;
+
+        for(std::size_t m=0; m<materials.size(); ++m) {
+
+          Batch_t & batch = batches[a * materials.size() + m];
+
+          if(batch.counts.empty()) continue;
+
+          if(!isBound) { useArena(a, isDepth); isBound = true; }
+
+          if(!isDepth && (GLuint) m != boundMaterial) { bindMaterial((GLuint) m); boundMaterial = (GLuint) m; }
+
+          glMultiDrawElementsBaseVertex(GL_TRIANGLES, batch.counts.data(), arenas[a].type, batch.offsets.data(), (GLsizei) batch.counts.size(), batch.baseVertices.data());
+
+          ++drawCallsCounter;
+
+        }
+
+      }
+
+    }
+
+    //****************************************************************************/
+    // getOcclusion() - Queries of the current window, created on first use
+    //****************************************************************************/
+    Occlusion_t & getOcclusion() {
+
+      uint32_t windowID = glWindow::current()->id;
+
+      for(Occlusion_t & occlusion : occlusions) if(occlusion.windowID == windowID) return occlusion;
+
+      if(boxesVbo == 0) setBoxes();
+
+      Occlusion_t occlusion;
+
+      occlusion.windowID = windowID;
+      occlusion.queries.resize(meshes.size());
+      occlusion.isPending.assign(meshes.size(), 0);
+      occlusion.result.assign(meshes.size(), UNKNOWN);
+
+      if(!meshes.empty()) glGenQueries((GLsizei) meshes.size(), occlusion.queries.data());
+
+      occlusions.push_back(std::move(occlusion));
+
+      return occlusions.back();
+
+    }
+
+    //****************************************************************************/
+    // testOcclusion() - Read the query of a mesh if the GPU has its result and
+    //                   schedule a new one. OCCLUDED is the last result read:
+    //                   while a newer query is pending the mesh is drawn under
+    //                   conditional rendering.
+    //****************************************************************************/
+    OCCLUSION testOcclusion(Occlusion_t & occlusion, uint32_t i, const glm::vec3 & eye, const glm::vec3 & margin) {
+
+      if(occlusion.isPending[i]) {
+
+        GLuint available = 0;
+
+        glGetQueryObjectuiv(occlusion.queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+
+        if(available) {
+
+          GLuint passed = 0;
+
+          glGetQueryObjectuiv(occlusion.queries[i], GL_QUERY_RESULT, &passed);
+
+          occlusion.result[i]    = passed ? VISIBLE : OCCLUDED;
+          occlusion.isPending[i] = 0;
+
+        }
 
-        // Nodes only hold indices; the actual mesh data lives in the scene.
-        aiMesh * mesh = scene->mMeshes[node->mMeshes[i]];
-        
-        meshes.push_back(glMesh(mesh, scene, path));
-        
+      }
+
+      const glAABB & box = meshes[i].getAABB();
+
+      glm::vec3 min = box.min - margin;
+      glm::vec3 max = box.max + margin;
+
+      if(eye.x >= min.x && eye.y >= min.y && eye.z >= min.z && eye.x <= max.x && eye.y <= max.y && eye.z <= max.z) {
+        occlusion.result[i] = VISIBLE;
+        return VISIBLE;
+      }
+
+      if(!occlusion.isPending[i]) queried.push_back(i);
+
+      if(occlusion.result[i] != OCCLUDED) return VISIBLE;
+
+      ++occludedCounter;
+
+      return OCCLUDED;
+
+    }
+
+    //****************************************************************************/
+    // renderConditionals() - Draw the meshes whose query is still in flight,
+    //                        discarded by the GPU if it finds them occluded
+    //****************************************************************************/
+    void renderConditionals(const Occlusion_t & occlusion, bool isDepth) {
+
+      int boundArena = -1;
+
+      for(std::size_t k=0; k<conditionals.size(); ++k) {
+
+        uint32_t i     = conditionals[k].first;
+        uint32_t level = conditionals[k].second;
+
+        int a = meshArena[i];
+
+        if(a != boundArena) { useArena(a, isDepth); boundArena = a; }
+
+        if(!isDepth) bindMaterial(meshes[i].getMaterialIndex());
+
+        glBeginConditionalRender(occlusion.queries[i], GL_QUERY_NO_WAIT);
+
+        for(GLuint j=levelDraws[meshLevels[i] + level]; j<levelDraws[meshLevels[i] + level + 1]; ++j)
+          glDrawElementsBaseVertex(GL_TRIANGLES, draws[j].count, arenas[a].type, (const void *)(uintptr_t) draws[j].offset, draws[j].baseVertex);
+
+        glEndConditionalRender();
+
+        ++drawCallsCounter;
+
+      }
+
+    }
+
+    //****************************************************************************/
+    // issueQueries() - Draw the boxes of the scheduled meshes, front to back,
+    //                  against the depth of the frame and without writing it.
+    //                  The masks are given back as found: in the color pass
+    //                  after a depth pre-pass the depth writes stay off.
+    //****************************************************************************/
+    void issueQueries(Occlusion_t & occlusion) {
+
+      if(queried.empty()) return;
+
+      depthShader.use();
+      depthShader.setUniform("model", modelMatrix);
+
+      boxesVao.bind();
+
+      // unknown counts as the GL default, writes on
+      GLboolean colorWrite = (glState().getColorMask() == GL_FALSE) ? GL_FALSE : GL_TRUE;
+      GLboolean depthWrite = (glState().getDepthMask() == GL_FALSE) ? GL_FALSE : GL_TRUE;
+
+      glState().colorMask(GL_FALSE);
+      glState().depthMask(GL_FALSE);
+
+      // the faces of a box seen from inside would be culled
+      glState().disable(GL_CULL_FACE);
+
+      for(std::size_t k=0; k<queried.size(); ++k) {
+
+        uint32_t i = queried[k];
+
+        glBeginQuery(GL_ANY_SAMPLES_PASSED, occlusion.queries[i]);
+
+        glDrawElementsBaseVertex(GL_TRIANGLES, 36, GL_UNSIGNED_SHORT, nullptr, (GLint) (8 * i));
+
+        glEndQuery(GL_ANY_SAMPLES_PASSED);
+
+        occlusion.isPending[i] = 1;
+
+      }
+
+      glState().colorMask(colorWrite);
+      glState().depthMask(depthWrite);
+
+    }
+
+    //****************************************************************************/
+    // setBoxes() - Upload the corners of the mesh boxes and the 36 indices of a box
+    //****************************************************************************/
+    void setBoxes() {
+
+      std::vector<glm::vec3> corners(8 * meshes.size());
+
+      for(std::size_t i=0; i<meshes.size(); ++i) {
+
+        const glAABB & box = meshes[i].getAABB();
+
+        for(int c=0; c<8; ++c)
+          corners[8 * i + c] = glm::vec3((c & 1) ? box.max.x : box.min.x, (c & 2) ? box.max.y : box.min.y, (c & 4) ? box.max.z : box.min.z);
+
+      }
+
+      static const uint16_t faces[36] = { 0, 2, 1, 1, 2, 3,   4, 5, 6, 5, 7, 6,
+                                          0, 1, 4, 1, 5, 4,   2, 6, 3, 3, 6, 7,
+                                          0, 4, 2, 2, 4, 6,   1, 3, 5, 3, 7, 5 };
+
+      glState().bindVertexArray(0);
+
+      glGenBuffers(1, &boxesVbo);
+      glGenBuffers(1, &boxesEbo);
+
+      glBindBuffer(GL_ARRAY_BUFFER, boxesVbo);
+      glBufferData(GL_ARRAY_BUFFER, corners.size() * sizeof(glm::vec3), corners.data(), GL_STATIC_DRAW);
+      glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, boxesEbo);
+      glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(faces), faces, GL_STATIC_DRAW);
+
+      boxesVao.attribute(0, boxesVbo, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), 0);
+      boxesVao.elements(boxesEbo);
+
+      glCheckError();
+
+    }
+
+    //****************************************************************************/
+    // bindMaterial() - Select the record and the textures of a material
+    //****************************************************************************/
+    void bindMaterial(GLuint index) {
+
+      glBindBufferRange(GL_UNIFORM_BUFFER, glMaterial::BINDING, materialUbo, index * materialStride, sizeof(glMaterial::Record_t));
+
+      materials[index].bindTextures();
+
+    }
+
+    //****************************************************************************/
+    // processNode() - Processes a node in a recursive fashion. Processes each individual mesh
+    //                 located at the node and repeats this process on its children nodes (if any)
+    //****************************************************************************/
+    void processNode(const aiNode * node, const aiScene * scene, const std::vector<GLuint> & materialIndices) {
+            
+      // Process each mesh attached to this node.
+      for(GLuint i=0; i<node->mNumMeshes; ++i) {
+
+        // Nodes only hold indices; the actual mesh data lives in the scene.
+        aiMesh * mesh = scene->mMeshes[node->mMeshes[i]];
+        
+        meshes.push_back(glMesh(mesh, materialIndices[mesh->mMaterialIndex]));
+        
       }
       
       // Recurse into children.
       for(GLuint i=0; i<node->mNumChildren; ++i) {
-        processNode(node->mChildren[i], scene, path);
+        processNode(node->mChildren[i], scene, materialIndices);
       }
       
     }
@@ -314,6 +1419,40 @@ namespace ogl {
 
         for(std::size_t i=0; i<meshes.size(); ++i) meshes[i].cleanInGpu();
 
+        for(std::size_t i=0; i<materials.size(); ++i) materials[i].cleanInGpu();
+
+        for(int i=0; i<2; ++i) {
+
+          if(!arenas[i].isEmpty) {
+            glDeleteBuffers(1, &arenas[i].vbo);
+            glDeleteBuffers(1, &arenas[i].ebo);
+            arenas[i].vao.clear();
+          }
+
+          arenas[i] = Arena_t();
+
+        }
+
+        for(std::size_t i=0; i<occlusions.size(); ++i) {
+          glWindow * window = glWindow::find(occlusions[i].windowID);
+          if(window != NULL) window->releaseQueries(occlusions[i].queries);
+        }
+
+        occlusions.clear();
+
+        if(boxesVbo != 0) {
+          glDeleteBuffers(1, &boxesVbo);
+          glDeleteBuffers(1, &boxesEbo);
+          boxesVao.clear();
+          boxesVbo = boxesEbo = 0;
+        }
+
+        glDeleteBuffers(1, &materialUbo);
+
+        materialUbo = 0;
+        samplersProgram = 0;
+        packedSamplersProgram = 0;
+
         isInitedInGpu = false;
         
       }
@@ -0,0 +1,356 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _H_OGL_GLOPTIMIZE_H_
+#define _H_OGL_GLOPTIMIZE_H_
+
+
+#ifndef _H_OGL_H_
+  #error "Do not include this header directly; include <ogl/ogl.hpp> instead."
+#endif
+
+#include <cstdint>
+#include <cmath>
+
+#include <vector>
+#include <algorithm>
+
+
+//****************************************************************************/
+// namespace ogl
+//****************************************************************************/
+namespace ogl {
+
+  //****************************************************************************/
+  // glOptimize
+  //****************************************************************************/
+  // Reordering of indexed triangle lists for the GPU:
+  //
+  //  - vertexCache() orders the triangles for the post-transform vertex cache
+  //    (Forsyth, "Linear-speed vertex cache optimisation");
+  //  - overdraw() then sorts clusters of that order so that the triangles
+  //    facing out of the mesh come first (Sander et al., "Fast triangle
+  //    reordering for vertex locality and reduced overdraw"), cutting only
+  //    where the cache was cold anyway;
+  //  - fetchRemap() numbers the vertices in order of first use, so the vertex
+  //    fetch walks the vertex buffer forward.
+  //
+  // Every pass is deterministic: the same input gives the same output.
+  //****************************************************************************/
+  class glOptimize {
+
+  private:
+
+    static constexpr int CACHE_SIZE = 32;
+
+  public:
+
+    //****************************************************************************/
+    // getACMR() - average cache miss ratio (transformed vertices per triangle)
+    //             of a FIFO cache of cacheSize entries
+    //****************************************************************************/
+    static float getACMR(const GLuint * indices, std::size_t indicesCount, std::size_t verticesCount, int cacheSize = 16) {
+
+      if(indicesCount < 3) return 0.0f;
+
+      std::vector<uint32_t> timestamps(verticesCount, 0);
+
+      uint32_t time = cacheSize + 1;
+      std::size_t misses = 0;
+
+      for(std::size_t i=0; i<indicesCount; ++i) {
+        if(time - timestamps[indices[i]] > (uint32_t) cacheSize) { timestamps[indices[i]] = time++; ++misses; }
+      }
+
+      return (float) misses / (indicesCount / 3);
+
+    }
+
+    //****************************************************************************/
+    // vertexCache() - reorder the triangles of [indices, indices + count)
+    //****************************************************************************/
+    static void vertexCache(GLuint * indices, std::size_t indicesCount, std::size_t verticesCount) {
+
+      std::size_t trianglesCount = indicesCount / 3;
+
+      if(trianglesCount < 2) return;
+
+      // triangles of each vertex, the live ones at the front of each range
+      std::vector<uint32_t> offsets(verticesCount + 1, 0);
+      std::vector<uint32_t> valences(verticesCount, 0);
+
+      for(std::size_t i=0; i<trianglesCount*3; ++i) ++offsets[indices[i] + 1];
+      for(std::size_t v=0; v<verticesCount; ++v) offsets[v + 1] += offsets[v];
+
+      std::vector<uint32_t> adjacency(trianglesCount * 3);
+
+      for(std::size_t i=0; i<trianglesCount*3; ++i) adjacency[offsets[indices[i]] + valences[indices[i]]++] = (uint32_t) (i / 3);
+
+      std::vector<int>   cachePositions(verticesCount, -1);
+      std::vector<float> vertexScores(verticesCount);
+      std::vector<float> triangleScores(trianglesCount, 0.0f);
+      std::vector<uint8_t> isEmitted(trianglesCount, 0);
+
+      for(std::size_t v=0; v<verticesCount; ++v) vertexScores[v] = score(-1, valences[v]);
+
+      for(std::size_t t=0; t<trianglesCount; ++t)
+        for(int k=0; k<3; ++k) triangleScores[t] += vertexScores[indices[3*t+k]];
+
+      std::vector<GLuint> output;
+      output.reserve(trianglesCount * 3);
+
+      std::vector<uint32_t> cache, nextCache;
+      cache.reserve(CACHE_SIZE + 3);
+      nextCache.reserve(CACHE_SIZE + 3);
+
+      std::size_t cursor = 0;
+
+      int64_t best = -1;
+
+      while(output.size() < trianglesCount * 3) {
+
+        // nothing left around the cache: continue with the next triangle in input order
+        if(best < 0) {
+          while(isEmitted[cursor]) ++cursor;
+          best = (int64_t) cursor;
+        }
+
+        const GLuint * triangle = &indices[3 * best];
+
+        output.insert(output.end(), triangle, triangle + 3);
+
+        isEmitted[best] = 1;
+
+        for(int k=0; k<3; ++k) {
+
+          uint32_t v = triangle[k];
+
+          // move the triangle past the live range of the vertex
+          uint32_t * begin = &adjacency[offsets[v]];
+          uint32_t * last  = begin + valences[v] - 1;
+
+          for(uint32_t * it=begin; it<=last; ++it) if(*it == (uint32_t) best) { std::swap(*it, *last); break; }
+
+          --valences[v];
+
+        }
+
+        // the triangle goes to the front of the LRU cache
+        nextCache.assign(triangle, triangle + 3);
+
+        for(std::size_t i=0; i<cache.size(); ++i)
+          if(cache[i] != triangle[0] && cache[i] != triangle[1] && cache[i] != triangle[2]) nextCache.push_back(cache[i]);
+
+        // evicted vertices lose their cache score
+        for(std::size_t i=CACHE_SIZE; i<nextCache.size(); ++i) {
+          cachePositions[nextCache[i]] = -1;
+          refresh(nextCache[i], offsets, valences, adjacency, cachePositions, vertexScores, triangleScores);
+        }
+
+        if(nextCache.size() > (std::size_t) CACHE_SIZE) nextCache.resize(CACHE_SIZE);
+
+        cache.swap(nextCache);
+
+        best = -1;
+
+        float bestScore = -1.0f;
+
+        for(std::size_t i=0; i<cache.size(); ++i) {
+
+          uint32_t v = cache[i];
+
+          cachePositions[v] = (int) i;
+
+          refresh(v, offsets, valences, adjacency, cachePositions, vertexScores, triangleScores);
+
+        }
+
+        // best live triangle around the cache
+        for(std::size_t i=0; i<cache.size(); ++i) {
+
+          uint32_t v = cache[i];
+
+          for(uint32_t j=offsets[v]; j<offsets[v]+valences[v]; ++j) {
+            uint32_t t = adjacency[j];
+            if(triangleScores[t] > bestScore) { bestScore = triangleScores[t]; best = t; }
+          }
+
+        }
+
+      }
+
+      std::copy(output.begin(), output.end(), indices);
+
+    }
+
+    //****************************************************************************/
+    // overdraw() - sort the clusters of a vertex cache ordered list, the ones
+    //              facing out of the mesh first
+    //****************************************************************************/
+    static void overdraw(GLuint * indices, std::size_t indicesCount, const std::vector<glm::vec3> & positions) {
+
+      std::size_t trianglesCount = indicesCount / 3;
+
+      if(trianglesCount < 2) return;
+
+      // a cluster starts at each triangle whose three vertices miss the cache
+      std::vector<std::size_t> starts;
+
+      std::vector<uint32_t> timestamps(positions.size(), 0);
+
+      uint32_t time = 16 + 1;
+
+      for(std::size_t t=0; t<trianglesCount; ++t) {
+
+        int misses = 0;
+
+        for(int k=0; k<3; ++k) {
+          GLuint v = indices[3*t+k];
+          if(time - timestamps[v] > 16) { timestamps[v] = time++; ++misses; }
+        }
+
+        if(t == 0 || misses == 3) starts.push_back(t);
+
+      }
+
+      starts.push_back(trianglesCount);
+
+      glm::dvec3 meshCentroid(0.0);
+      double meshArea = 0.0;
+
+      std::vector<glm::dvec3> centroids(starts.size() - 1), normals(starts.size() - 1);
+
+      for(std::size_t c=0; c+1<starts.size(); ++c) {
+
+        glm::dvec3 centroid(0.0), normal(0.0);
+        double area = 0.0;
+
+        for(std::size_t t=starts[c]; t<starts[c+1]; ++t) {
+
+          glm::dvec3 p0(positions[indices[3*t+0]]), p1(positions[indices[3*t+1]]), p2(positions[indices[3*t+2]]);
+
+          glm::dvec3 n = glm::cross(p1 - p0, p2 - p0);
+
+          double a = glm::length(n);
+
+          centroid += (p0 + p1 + p2) * (a / 3.0);
+          normal   += n;
+          area     += a;
+
+        }
+
+        meshCentroid += centroid;
+        meshArea     += area;
+
+        centroids[c] = (area > 0.0) ? centroid / area : glm::dvec3(0.0);
+        normals[c]   = normal;
+
+      }
+
+      if(meshArea > 0.0) meshCentroid /= meshArea;
+
+      std::vector<double> keys(centroids.size());
+      std::vector<std::size_t> order(centroids.size());
+
+      for(std::size_t c=0; c<centroids.size(); ++c) {
+        double length = glm::length(normals[c]);
+        keys[c] = (length > 0.0) ? glm::dot(centroids[c] - meshCentroid, normals[c] / length) : 0.0;
+        order[c] = c;
+      }
+
+      std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return keys[a] > keys[b]; });
+
+      std::vector<GLuint> output;
+      output.reserve(trianglesCount * 3);
+
+      for(std::size_t i=0; i<order.size(); ++i)
+        output.insert(output.end(), indices + 3 * starts[order[i]], indices + 3 * starts[order[i] + 1]);
+
+      std::copy(output.begin(), output.end(), indices);
+
+    }
+
+    //****************************************************************************/
+    // fetchRemap() - new index of every vertex, in order of first use in the
+    //                lists; unused vertices go last
+    //****************************************************************************/
+    static std::vector<GLuint> fetchRemap(const std::vector<const std::vector<GLuint> *> & lists, std::size_t verticesCount) {
+
+      std::vector<GLuint> remap(verticesCount, (GLuint) -1);
+
+      GLuint next = 0;
+
+      for(std::size_t l=0; l<lists.size(); ++l)
+        for(std::size_t i=0; i<lists[l]->size(); ++i)
+          if(remap[(*lists[l])[i]] == (GLuint) -1) remap[(*lists[l])[i]] = next++;
+
+      for(std::size_t v=0; v<verticesCount; ++v) if(remap[v] == (GLuint) -1) remap[v] = next++;
+
+      return remap;
+
+    }
+
+  private:
+
+    //****************************************************************************/
+    // score() - Forsyth vertex score: recently used vertices and vertices with
+    //           few triangles left are preferred
+    //****************************************************************************/
+    static float score(int cachePosition, uint32_t valence) {
+
+      if(valence == 0) return -1.0f;
+
+      float value = 0.0f;
+
+      if(cachePosition >= 0) {
+        // the three vertices of the last triangle score the same, whatever their order
+        if(cachePosition < 3) value = 0.75f;
+        else value = std::pow(1.0f - (float) (cachePosition - 3) / (CACHE_SIZE - 3), 1.5f);
+      }
+
+      return value + 2.0f / std::sqrt((float) valence);
+
+    }
+
+    //****************************************************************************/
+    // refresh() - new score of a vertex, propagated to its live triangles
+    //****************************************************************************/
+    static void refresh(uint32_t v, const std::vector<uint32_t> & offsets, const std::vector<uint32_t> & valences,
+                        const std::vector<uint32_t> & adjacency, const std::vector<int> & cachePositions,
+                        std::vector<float> & vertexScores, std::vector<float> & triangleScores) {
+
+      float value = score(cachePositions[v], valences[v]);
+
+      float delta = value - vertexScores[v];
+
+      vertexScores[v] = value;
+
+      if(delta == 0.0f) return;
+
+      for(uint32_t j=offsets[v]; j<offsets[v]+valences[v]; ++j) triangleScores[adjacency[j]] += delta;
+
+    }
+
+  };
+
+} /* namespace ogl */
+
+#endif /* _H_OGL_GLOPTIMIZE_H_ */
+
@@ -0,0 +1,342 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _H_OGL_GLSIMPLIFY_H_
+#define _H_OGL_GLSIMPLIFY_H_
+
+
+#ifndef _H_OGL_H_
+  #error "Do not include this header directly; include <ogl/ogl.hpp> instead."
+#endif
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+#include <vector>
+#include <queue>
+#include <functional>
+#include <unordered_map>
+
+
+//****************************************************************************/
+// namespace ogl
+//****************************************************************************/
+namespace ogl {
+
+  //****************************************************************************/
+  // glSimplify
+  //****************************************************************************/
+  // Quadric error edge collapse (Garland & Heckbert) of an indexed triangle
+  // list. Vertices are only moved onto one of their neighbours, never to a new
+  // position, so the simplified index list still refers to the original vertex
+  // buffer and the levels of a glMesh share it. Vertices on an open border or
+  // on an attribute seam (same position, different vertex) are never moved,
+  // which keeps the outline and the texture seams closed.
+  //****************************************************************************/
+  class glSimplify {
+
+  private:
+
+    // symmetric 4x4 matrix of the sum of the squared plane distances, and the
+    // total area of the planes
+    struct Quadric_t {
+
+      double a00 = 0, a01 = 0, a02 = 0, a03 = 0;
+      double a11 = 0, a12 = 0, a13 = 0;
+      double a22 = 0, a23 = 0;
+      double a33 = 0;
+      double weight = 0;
+
+      void add(const Quadric_t & q) {
+        a00 += q.a00; a01 += q.a01; a02 += q.a02; a03 += q.a03;
+        a11 += q.a11; a12 += q.a12; a13 += q.a13;
+        a22 += q.a22; a23 += q.a23;
+        a33 += q.a33;
+        weight += q.weight;
+      }
+
+      void addPlane(double nx, double ny, double nz, double d, double w) {
+        a00 += w*nx*nx; a01 += w*nx*ny; a02 += w*nx*nz; a03 += w*nx*d;
+        a11 += w*ny*ny; a12 += w*ny*nz; a13 += w*ny*d;
+        a22 += w*nz*nz; a23 += w*nz*d;
+        a33 += w*d*d;
+        weight += w;
+      }
+
+      // mean squared distance of p from the planes
+      double evaluate(const glm::vec3 & p) const {
+        double x = p.x, y = p.y, z = p.z;
+        double e = a00*x*x + 2*a01*x*y + 2*a02*x*z + 2*a03*x
+                 + a11*y*y + 2*a12*y*z + 2*a13*y
+                 + a22*z*z + 2*a23*z
+                 + a33;
+        return (weight > 0) ? std::fabs(e) / weight : 0.0;
+      }
+
+    };
+
+    struct Collapse_t {
+      float cost;
+      uint32_t from, to;
+      uint32_t fromVersion, toVersion;
+      bool operator > (const Collapse_t & other) const { return cost > other.cost; }
+    };
+
+  public:
+
+    //****************************************************************************/
+    // simplify() - collapse edges until at most targetTriangles triangles are
+    //              left. Returns the new index list; error is set to the
+    //              largest distance (in model units) introduced by a collapse.
+    //****************************************************************************/
+    static std::vector<GLuint> simplify(const std::vector<glm::vec3> & positions, const std::vector<GLuint> & indices,
+                                        std::size_t targetTriangles, float & error) {
+
+      error = 0.0f;
+
+      std::size_t trianglesCount = indices.size() / 3;
+
+      if(trianglesCount <= targetTriangles) return indices;
+
+      std::size_t verticesCount = positions.size();
+
+      std::vector<uint32_t> triangles(indices.begin(), indices.begin() + trianglesCount * 3);
+      std::vector<uint8_t> isRemoved(trianglesCount, 0);
+
+      std::vector<Quadric_t> quadrics(verticesCount);
+      std::vector<std::vector<uint32_t>> vertexTriangles(verticesCount);
+
+      for(uint32_t t=0; t<trianglesCount; ++t) {
+
+        const glm::vec3 & p0 = positions[triangles[3*t+0]];
+        const glm::vec3 & p1 = positions[triangles[3*t+1]];
+        const glm::vec3 & p2 = positions[triangles[3*t+2]];
+
+        glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+
+        double area = glm::length(normal);
+
+        if(area > 0.0) {
+          double nx = normal.x / area, ny = normal.y / area, nz = normal.z / area;
+          double d = -(nx * p0.x + ny * p0.y + nz * p0.z);
+          for(int k=0; k<3; ++k) quadrics[triangles[3*t+k]].addPlane(nx, ny, nz, d, area * 0.5);
+        }
+
+        for(int k=0; k<3; ++k) vertexTriangles[triangles[3*t+k]].push_back(t);
+
+      }
+
+      std::vector<uint8_t> isLocked = findLocked(positions, triangles);
+
+      std::vector<uint8_t>  isAlive(verticesCount, 1);
+      std::vector<uint32_t> versions(verticesCount, 0);
+
+      std::priority_queue<Collapse_t, std::vector<Collapse_t>, std::greater<Collapse_t>> queue;
+
+      for(uint32_t t=0; t<trianglesCount; ++t)
+        for(int k=0; k<3; ++k)
+          push(queue, positions, quadrics, isLocked, versions, triangles[3*t+k], triangles[3*t+(k+1)%3]);
+
+      double maxCost = 0.0;
+
+      while(trianglesCount > targetTriangles && !queue.empty()) {
+
+        Collapse_t collapse = queue.top(); queue.pop();
+
+        uint32_t u = collapse.from, v = collapse.to;
+
+        // stale: one of the ends was collapsed or its neighbourhood changed
+        if(!isAlive[u] || !isAlive[v]) continue;
+        if(versions[u] != collapse.fromVersion || versions[v] != collapse.toVersion) continue;
+
+        if(isFlipping(positions, triangles, isRemoved, vertexTriangles[u], u, v)) continue;
+
+        for(std::size_t i=0; i<vertexTriangles[u].size(); ++i) {
+
+          uint32_t t = vertexTriangles[u][i];
+
+          if(isRemoved[t]) continue;
+
+          uint32_t * corners = &triangles[3*t];
+
+          if(corners[0] == v || corners[1] == v || corners[2] == v) { isRemoved[t] = 1; --trianglesCount; continue; }
+
+          for(int k=0; k<3; ++k) if(corners[k] == u) corners[k] = v;
+
+          vertexTriangles[v].push_back(t);
+
+        }
+
+        quadrics[v].add(quadrics[u]);
+
+        isAlive[u] = 0;
+        vertexTriangles[u].clear();
+        vertexTriangles[u].shrink_to_fit();
+
+        if(collapse.cost > maxCost) maxCost = collapse.cost;
+
+        // the queued edges of v are stale: drop the removed triangles and requeue them
+        ++versions[v];
+
+        std::vector<uint32_t> & around = vertexTriangles[v];
+
+        std::size_t kept = 0;
+
+        for(std::size_t i=0; i<around.size(); ++i) {
+
+          uint32_t t = around[i];
+
+          if(isRemoved[t]) continue;
+
+          around[kept++] = t;
+
+          for(int k=0; k<3; ++k) {
+            uint32_t w = triangles[3*t+k];
+            if(w != v) push(queue, positions, quadrics, isLocked, versions, v, w);
+          }
+
+        }
+
+        around.resize(kept);
+
+      }
+
+      error = (float) std::sqrt(maxCost);
+
+      std::vector<GLuint> result;
+      result.reserve(trianglesCount * 3);
+
+      for(std::size_t t=0; t<isRemoved.size(); ++t)
+        if(!isRemoved[t]) result.insert(result.end(), &triangles[3*t], &triangles[3*t] + 3);
+
+      return result;
+
+    }
+
+  private:
+
+    //****************************************************************************/
+    // push() - queue the cheaper direction of the edge (a, b)
+    //****************************************************************************/
+    static void push(std::priority_queue<Collapse_t, std::vector<Collapse_t>, std::greater<Collapse_t>> & queue,
+                     const std::vector<glm::vec3> & positions, const std::vector<Quadric_t> & quadrics,
+                     const std::vector<uint8_t> & isLocked, const std::vector<uint32_t> & versions, uint32_t a, uint32_t b) {
+
+      if(a == b || (isLocked[a] && isLocked[b])) return;
+
+      Quadric_t q = quadrics[a];
+      q.add(quadrics[b]);
+
+      // move a onto b, unless a is locked or the other way costs less
+      bool isFromA = !isLocked[a] && (isLocked[b] || q.evaluate(positions[b]) <= q.evaluate(positions[a]));
+
+      uint32_t from = isFromA ? a : b;
+      uint32_t to   = isFromA ? b : a;
+
+      queue.push(Collapse_t{ (float) q.evaluate(positions[to]), from, to, versions[from], versions[to] });
+
+    }
+
+    //****************************************************************************/
+    // isFlipping() - true when moving u onto v turns over or degenerates one of
+    //                the triangles that survive the collapse
+    //****************************************************************************/
+    static bool isFlipping(const std::vector<glm::vec3> & positions, const std::vector<uint32_t> & triangles,
+                           const std::vector<uint8_t> & isRemoved, const std::vector<uint32_t> & around, uint32_t u, uint32_t v) {
+
+      for(std::size_t i=0; i<around.size(); ++i) {
+
+        uint32_t t = around[i];
+
+        if(isRemoved[t]) continue;
+
+        const uint32_t * corners = &triangles[3*t];
+
+        if(corners[0] == v || corners[1] == v || corners[2] == v) continue;
+
+        glm::vec3 p[3], q[3];
+
+        for(int k=0; k<3; ++k) {
+          p[k] = positions[corners[k]];
+          q[k] = (corners[k] == u) ? positions[v] : p[k];
+        }
+
+        glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+        glm::vec3 after  = glm::cross(q[1] - q[0], q[2] - q[0]);
+
+        if(glm::dot(before, after) <= 0.0f) return true;
+
+      }
+
+      return false;
+
+    }
+
+    //****************************************************************************/
+    // findLocked() - vertices on an open border or sharing their position with
+    //                another vertex
+    //****************************************************************************/
+    static std::vector<uint8_t> findLocked(const std::vector<glm::vec3> & positions, const std::vector<uint32_t> & triangles) {
+
+      std::vector<uint8_t> isLocked(positions.size(), 0);
+
+      // seams: the first vertex found at each position
+      struct Hash_t {
+        std::size_t operator () (const glm::vec3 & p) const {
+          uint32_t bits[3]; memcpy(bits, &p.x, sizeof(float)); memcpy(bits + 1, &p.y, sizeof(float)); memcpy(bits + 2, &p.z, sizeof(float));
+          return ((std::size_t) bits[0] * 73856093u) ^ ((std::size_t) bits[1] * 19349663u) ^ ((std::size_t) bits[2] * 83492791u);
+        }
+      };
+
+      std::unordered_map<glm::vec3, uint32_t, Hash_t> firstAt;
+      firstAt.reserve(positions.size());
+
+      for(uint32_t i=0; i<positions.size(); ++i) {
+        auto inserted = firstAt.emplace(positions[i], i);
+        if(!inserted.second) { isLocked[i] = 1; isLocked[inserted.first->second] = 1; }
+      }
+
+      // borders: edges used by a single triangle
+      std::unordered_map<uint64_t, uint32_t> edges;
+      edges.reserve(triangles.size());
+
+      for(std::size_t i=0; i<triangles.size(); i+=3) {
+        for(int k=0; k<3; ++k) {
+          uint64_t a = triangles[i+k], b = triangles[i+(k+1)%3];
+          if(a > b) std::swap(a, b);
+          ++edges[(a << 32) | b];
+        }
+      }
+
+      for(const auto & edge : edges) {
+        if(edge.second == 1) { isLocked[edge.first >> 32] = 1; isLocked[edge.first & 0xFFFFFFFFu] = 1; }
+      }
+
+      return isLocked;
+
+    }
+
+  };
+
+} /* namespace ogl */
+
+#endif /* _H_OGL_GLSIMPLIFY_H_ */
+
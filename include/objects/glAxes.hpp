@@ -40,7 +40,7 @@ namespace ogl {
     
     private:
       
-      GLuint vao;
+      glVertexArray vao;
       GLuint vbo;
       
       std::vector<glm::vec3> vertices;
@@ -125,15 +125,13 @@ namespace ogl {
 
         shader.use();
         
-        shader.setUniform("projection", camera.getProjection());
-        shader.setUniform("view",       camera.getView());
+        setInFrame(camera);
         shader.setUniform("model",      modelMatrix);
         shader.setUniform("lineWidth",  lineWidth);
-        shader.setUniform("viewport",   camera.getViewport());
                 
-        glBindVertexArray(vao);
+        vao.bind();
 
-        glDisable(GL_CULL_FACE);
+        glState().disable(GL_CULL_FACE);
         glDisableVertexAttribArray(1);
         glVertexAttrib4f(1, 1.0f, 1.0f, 1.0f, 1.0f);
 
@@ -144,8 +142,6 @@ namespace ogl {
           glDrawArrays(GL_LINES, i*2, 2);
 
         }
-        
-        glBindVertexArray(0);
 
         glCheckError();
 
@@ -180,19 +176,14 @@ namespace ogl {
    
         DEBUG_LOG("glAxes::setInGpu(" + name + ")");
                   
-        glGenVertexArrays(1, &vao);
-        glBindVertexArray(vao);
-
         glGenBuffers(1, &vbo);
         glBindBuffer(GL_ARRAY_BUFFER, vbo);
 
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), nullptr);
-        glEnableVertexAttribArray(0); 
-        
         glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec3), vertices.data(), GL_STATIC_DRAW);
        
         glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
+
+        vao.attribute(0, vbo, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3));
         
         glCheckError();
         
@@ -208,7 +199,7 @@ namespace ogl {
       if(isInitedInGpu) {
 
         glDeleteBuffers(1, &vbo);
-        glDeleteVertexArrays(1, &vao);
+        vao.clear();
         
         isInitedInGpu = false;
 
@@ -36,12 +36,14 @@ namespace ogl {
   //****************************************************************************/
   // Class glBox
   //****************************************************************************/
+  // The 12 edges of the unit cube, sized through scale(). The edge mesh is
+  // shared through glGeometries by every box.
+  //****************************************************************************/
   class glBox: public glObject {
     
   private:
     
-    GLuint vao;
-    GLuint vbo[2];
+    glSharedGeometry mesh;
 
     constexpr static const GLfloat vertices[] = {
       -0.5,  0.5,  0.5,
@@ -114,22 +116,18 @@ namespace ogl {
 
       shader.use();
       
-      shader.setUniform("projection",  camera.getProjection());
-      shader.setUniform("view",        camera.getView());
+      setInFrame(camera);
       shader.setUniform("model",       modelMatrix);
       shader.setUniform("lineWidth",   lineWidth);
-      shader.setUniform("viewport",    camera.getViewport());
       shader.setUniform("uniformColor", glm::vec4(color, 1.0f));
 
-      glBindVertexArray(vao);
+      mesh.bind();
         
-      glDisable(GL_CULL_FACE);
+      glState().disable(GL_CULL_FACE);
       glDisableVertexAttribArray(1);
       glVertexAttrib4f(1, 1.0f, 1.0f, 1.0f, 1.0f);
 
-      glDrawElements(GL_LINES, 24, GL_UNSIGNED_SHORT, nullptr);
-     
-      glBindVertexArray(0);
+      glDrawElements(GL_LINES, mesh.getCount(), mesh.getType(), nullptr);
       
       glCheckError();
             
@@ -164,40 +162,31 @@ namespace ogl {
       
       DEBUG_LOG("glBox::setInGpu(" + name + ")");
 
-      static const GLushort indices[] = {
-        0, 1,
-        1, 2,
-        2, 3,
-        3, 0,
-        0, 4,
-        7, 4,
-        4, 5,
-        5, 6,
-        6, 7,
-        1, 5,
-        2, 6,
-        3, 7
-      };
-      
-      glGenVertexArrays(1, &vao);
-      glBindVertexArray(vao);
-
-      glGenBuffers(2, vbo);
-
-      // Vertex positions.
-      glBindBuffer(GL_ARRAY_BUFFER, vbo[0]);
-      glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-      glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
-      glEnableVertexAttribArray(0);
-
-      // Edge index buffer (pairs of vertex indices for GL_LINES).
-      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vbo[1]);
-      glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-      glBindBuffer(GL_ARRAY_BUFFER, 0);
-      glBindVertexArray(0);
-      
-      glCheckError();
+      mesh.acquire("box", []() {
+
+        // pairs of vertex indices for GL_LINES
+        glGeometry geometry;
+
+        geometry.indices = {
+          0, 1,
+          1, 2,
+          2, 3,
+          3, 0,
+          0, 4,
+          7, 4,
+          4, 5,
+          5, 6,
+          6, 7,
+          1, 5,
+          2, 6,
+          3, 7
+        };
+
+        for(int i=0; i<8; ++i) geometry.positions.push_back(glm::vec3(vertices[i*3], vertices[i*3 + 1], vertices[i*3 + 2]));
+
+        return geometry;
+
+      });
       
     }
     
@@ -210,8 +199,7 @@ namespace ogl {
       
       if(isInitedInGpu) {
         
-        glDeleteBuffers(2, vbo);
-        glDeleteVertexArrays(1, &vao);
+        mesh.release();
         
         isInitedInGpu = false;
 
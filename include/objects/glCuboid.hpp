@@ -36,17 +36,17 @@ namespace ogl {
   //****************************************************************************/
   // Class glCuboid
   //****************************************************************************/
-  // Axis-aligned solid box. Because a cube's 8 corners are shared by faces with
-  // different normals, the geometry is expanded to 36 vertices (6 faces × 6
-  // verts) so each face can carry its own flat outward normal. Supports SOLID
-  // and WIREFRAME styles. In SOLID mode Phong shading uses the glLight member.
+  // Axis-aligned solid box. The mesh is the unit cube of glGeometry::cuboid()
+  // (4 vertices per face, so each face carries its own flat outward normal),
+  // shared through glGeometries by every cuboid; the size is applied in the
+  // model matrix. Supports SOLID and WIREFRAME styles. In SOLID mode Phong
+  // shading uses the glLight member.
   //****************************************************************************/
   class glCuboid : public glShape {
 
   private:
 
-      GLuint vao = 0; // 0 = not yet allocated
-      GLuint vbo[4];
+      glSharedGeometry mesh;
 
       glm::vec3 size;
 
@@ -111,118 +111,57 @@ namespace ogl {
 
       shader.use();
 
-      shader.setUniform("projection", camera.getProjection());
-      shader.setUniform("view", camera.getView());
-      shader.setUniform("model", modelMatrix);
+      setInFrame(camera);
+      shader.setUniform("model", modelMatrix * glm::scale(glm::mat4(1.0f), size));
       shader.setUniform("color", color);
       if(style == glShader::STYLE::SOLID) {
-        light.setInShader(shader, camera.getView());
+        light.setInFrame(camera.getView());
       }
 
-      glBindVertexArray(vao);
+      mesh.bind();
 
       if(style == glShader::STYLE::WIREFRAME) {
         shader.setUniform("lineWidth", lineWidth);
-        shader.setUniform("viewport", camera.getViewport());
-        glDisable(GL_CULL_FACE);
+        glState().disable(GL_CULL_FACE);
       } else {
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_BACK);
+        glState().enable(GL_CULL_FACE);
+        glState().cullFace(GL_BACK);
       }
 
-      glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr);
-
-      glBindVertexArray(0);
+      glDrawElements(GL_TRIANGLES, mesh.getCount(), mesh.getType(), nullptr);
 
       glCheckError();
 
     }
 
-  private:
-
     //****************************************************************************/
-    // setInGpu()
+    // renderDepth() - depth only, for the pre-pass (SOLID style)
     //****************************************************************************/
-    void setInGpu() {
+    void renderDepth(const glCamera & camera) {
 
-      DEBUG_LOG("glCuboid::setInGpu(" + name + ")");
+      if(!useDepth(camera, modelMatrix * glm::scale(glm::mat4(1.0f), size))) return;
 
-      glm::vec3 corners[8] = {
-          {-0.5f,  0.5f,  0.5f},
-          { 0.5f,  0.5f,  0.5f},
-          { 0.5f, -0.5f,  0.5f},
-          {-0.5f, -0.5f,  0.5f},
-          {-0.5f,  0.5f, -0.5f},
-          { 0.5f,  0.5f, -0.5f},
-          { 0.5f, -0.5f, -0.5f},
-          {-0.5f, -0.5f, -0.5f}
-      };
-
-      for(auto & v : corners) v *= size;
-
-      // Six faces, each defined by two triangles (same winding as before) plus its
-      // own outward normal. The 8 shared corners cannot carry per-face normals, so
-      // we expand to 36 vertices and give each face a flat normal.
-      GLuint faceCorner[6][6] = {
-        { 0, 3, 2, 2, 1, 0 }, // Front
-        { 1, 2, 6, 6, 5, 1 }, // Right
-        { 5, 6, 7, 7, 4, 5 }, // Back
-        { 4, 7, 3, 3, 0, 4 }, // Left
-        { 4, 0, 1, 1, 5, 4 }, // Top
-        { 3, 7, 6, 6, 2, 3 }  // Bottom
-      };
-
-      glm::vec3 faceNormal[6] = {
-        { 0,  0,  1}, // Front
-        { 1,  0,  0}, // Right
-        { 0,  0, -1}, // Back
-        {-1,  0,  0}, // Left
-        { 0,  1,  0}, // Top
-        { 0, -1,  0}  // Bottom
-      };
-
-      std::vector<glm::vec3> positions;
-      std::vector<glm::vec3> normals;
-      std::vector<GLuint>    indices;
-
-      for(int f=0; f<6; ++f) {
-        for(int k=0; k<6; ++k) {
-          positions.push_back(corners[faceCorner[f][k]]);
-          normals.push_back(faceNormal[f]);
-          indices.push_back((GLuint)indices.size());
-        }
-      }
+      mesh.bind();
+
+      glState().enable(GL_CULL_FACE);
+      glState().cullFace(GL_BACK);
 
-      glGenVertexArrays(1, &vao);
-      glBindVertexArray(vao);
+      glDrawElements(GL_TRIANGLES, mesh.getCount(), mesh.getType(), nullptr);
 
-      glGenBuffers(4, vbo);
+      glCheckError();
 
-      // Positions
-      glBindBuffer(GL_ARRAY_BUFFER, vbo[0]);
-      glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(glm::vec3), positions.data(), GL_STATIC_DRAW);
-      glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
-      glEnableVertexAttribArray(0);
+    }
 
-      // Normals (one flat normal per face)
-      glBindBuffer(GL_ARRAY_BUFFER, vbo[1]);
-      glBufferData(GL_ARRAY_BUFFER, normals.size() * sizeof(glm::vec3), normals.data(), GL_STATIC_DRAW);
-      glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
-      glEnableVertexAttribArray(1);
+  private:
 
-      // TexCoords (dummy for now, optional)
-      std::vector<glm::vec2> texcoords(positions.size(), glm::vec2(0.0f));
-      glBindBuffer(GL_ARRAY_BUFFER, vbo[2]);
-      glBufferData(GL_ARRAY_BUFFER, texcoords.size() * sizeof(glm::vec2), texcoords.data(), GL_STATIC_DRAW);
-      glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
-      glEnableVertexAttribArray(2);
+    //****************************************************************************/
+    // setInGpu()
+    //****************************************************************************/
+    void setInGpu() {
 
-      // Indices
-      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vbo[3]);
-      glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+      DEBUG_LOG("glCuboid::setInGpu(" + name + ")");
 
-      glBindBuffer(GL_ARRAY_BUFFER, 0);
-      glBindVertexArray(0);
+      mesh.acquire("cuboid", []() { return glGeometry::cuboid(); });
 
       isInitedInGpu = true;
       
@@ -234,8 +173,7 @@ namespace ogl {
     void cleanInGpu() {
 
       if(isInitedInGpu) {
-        glDeleteBuffers(4, vbo);
-        glDeleteVertexArrays(1, &vao);
+        mesh.release();
         isInitedInGpu = false;
       }
     }
@@ -0,0 +1,80 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _H_OGL_CUBOIDINSTANCES_H_
+#define _H_OGL_CUBOIDINSTANCES_H_
+
+#ifndef _H_OGL_H_
+  #error "Do not include this header directly; include <ogl/ogl.hpp> instead."
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+
+//****************************************************************************/
+// namespace ogl
+//****************************************************************************/
+namespace ogl {
+
+  //****************************************************************************/
+  // Class glCuboidInstances
+  //****************************************************************************/
+  // A batch of boxes drawn in one instanced call. The instance scale is the
+  // size of the box along its (rotated) axes.
+  //****************************************************************************/
+  class glCuboidInstances : public glInstances {
+
+  public:
+
+    //****************************************************************************/
+    // glCuboidInstances()
+    //****************************************************************************/
+    glCuboidInstances(const std::string & _name = "") : glInstances(_name) { }
+
+    //****************************************************************************/
+    // glCuboidInstances()
+    //****************************************************************************/
+    glCuboidInstances(int _style, const glm::vec3 & _color = glm::vec3(1.0f), const std::string & _name = "") : glInstances(_name) {
+      init(_style, _color);
+    }
+
+    //****************************************************************************/
+    // init()
+    //****************************************************************************/
+    void init(int _style = glShader::STYLE::SOLID, const glm::vec3 & _color = glm::vec3(1.0f)) {
+
+      DEBUG_LOG("glCuboidInstances::init(" + name + ")");
+
+      glInstances::init(_style, _color);
+
+    }
+
+  protected:
+
+    //****************************************************************************/
+    // geometry() - unit cube
+    //****************************************************************************/
+    glGeometry geometry() const { return glGeometry::cuboid(); }
+
+  };
+
+} /* namespace ogl */
+
+#endif /* _H_OGL_CUBOIDINSTANCES_H_ */
@@ -37,16 +37,19 @@ namespace ogl {
   // Class glEllipse
   //****************************************************************************/
   // Ellipsoid with semi-axes a (X), b (Y), c (Z). Supports SOLID and WIREFRAME
-  // styles. In SOLID mode the surface normal is the gradient of the implicit
-  // equation (X/a², Y/b², Z/c²), not the position vector, so the shading is
-  // correct even for non-spherical shapes. glSphere is the special case a=b=c.
+  // styles. The mesh is the unit sphere of the given stacks and slices, shared
+  // through glGeometries by every ellipsoid with the same tessellation, and the
+  // semi-axes are applied in the model matrix. The shader transforms the
+  // normals with the inverse transpose of that matrix, which turns the unit
+  // sphere normal into the gradient of the implicit equation (X/a², Y/b², Z/c²),
+  // so the shading is correct even for non-spherical shapes. glSphere is the
+  // special case a=b=c.
   //****************************************************************************/
   class glEllipse : public glShape {
 
   private:
 
-    GLuint vao;
-    GLuint vbo[4];
+    glSharedGeometry mesh;
 
     int stacks;
     int slices;
@@ -125,30 +128,44 @@ namespace ogl {
       
       shader.use();
 
-      shader.setUniform("projection", camera.getProjection());
-      shader.setUniform("view",       camera.getView());
-      shader.setUniform("model",      modelMatrix);
+      setInFrame(camera);
+      shader.setUniform("model",      modelMatrix * glm::scale(glm::mat4(1.0f), glm::vec3(a, b, c)));
       shader.setUniform("color",      color);
       if(style == glShader::STYLE::SOLID) {
-        light.setInShader(shader, camera.getView());
+        light.setInFrame(camera.getView());
       }
 
-      glBindVertexArray(vao);
+      mesh.bind();
 
       if(style == glShader::STYLE::WIREFRAME) {
         shader.setUniform("lineWidth", lineWidth);
-        shader.setUniform("viewport",  camera.getViewport());
-        glDisable(GL_CULL_FACE);
+        glState().disable(GL_CULL_FACE);
       }
       
       if(style == glShader::STYLE::SOLID) {
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_BACK);
+        glState().enable(GL_CULL_FACE);
+        glState().cullFace(GL_BACK);
       }
       
-      glDrawElements(GL_TRIANGLES, slices * stacks * 6, GL_UNSIGNED_INT, nullptr);
-      
-      glBindVertexArray(0);
+      glDrawElements(GL_TRIANGLES, mesh.getCount(), mesh.getType(), nullptr);
+
+      glCheckError();
+
+    }
+
+    //****************************************************************************/
+    // renderDepth() - depth only, for the pre-pass (SOLID style)
+    //****************************************************************************/
+    void renderDepth(const glCamera & camera) {
+
+      if(!useDepth(camera, modelMatrix * glm::scale(glm::mat4(1.0f), glm::vec3(a, b, c)))) return;
+
+      mesh.bind();
+
+      glState().enable(GL_CULL_FACE);
+      glState().cullFace(GL_BACK);
+
+      glDrawElements(GL_TRIANGLES, mesh.getCount(), mesh.getType(), nullptr);
 
       glCheckError();
 
@@ -162,101 +179,9 @@ namespace ogl {
     void setInGpu() {
       
       DEBUG_LOG("glEllipse::setInGpu(" + name + ")");
-          
-      if(!isInitedInGpu) {
-
-        std::vector<glm::vec3> positions;
-        std::vector<glm::vec3> normals;
-        std::vector<glm::vec2> textureCoords;
-        
-        for(int i=0; i<=stacks; ++i) {
-
-          // V texture coordinate
-          float V   = i / (float)stacks;
-          float phi = V * M_PI - M_PI/2.0;
 
-          for(int j=0; j<=slices; ++j) {
-            
-            // U texture coordinate
-            float U     = j / (float)slices;
-            float theta = U * 2.0f * M_PI;
-            
-            float X = a * cos(phi) * cos(theta);
-            float Y = b * cos(phi) * sin(theta);
-            float Z = c * sin(phi);
-
-            // The surface normal of an ellipsoid is the gradient of its implicit
-            // equation: (X/a^2, Y/b^2, Z/c^2), not the surface position itself.
-            glm::vec3 normal = glm::vec3(X/(a*a), Y/(b*b), Z/(c*c));
-            if(glm::length(normal) > 0.0f) normal = glm::normalize(normal);
-
-            positions.push_back( glm::vec3( X, Y, Z) );
-            normals.push_back( normal );
-            textureCoords.push_back( glm::vec2(U, V) );
-            
-          }
-          
-        }
-                
-        // Now generate the index buffer
-        std::vector<GLuint> indicies;
-        
-        int noPerSlice = slices + 1;
-        
-        for(int i=0; i < stacks; ++i) {
-          
-          for (int j=0; j < slices; ++j) {
-            
-            int start_i = (i * noPerSlice) + j;
-            
-            indicies.push_back( start_i );
-            indicies.push_back( start_i + noPerSlice + 1 );
-            indicies.push_back( start_i + noPerSlice );
-            
-            indicies.push_back( start_i + noPerSlice + 1 );
-            indicies.push_back( start_i );
-            indicies.push_back( start_i + 1 );
-            
-          }
-          
-        }
-        
-        glGenVertexArrays(1, &vao);
-        glBindVertexArray(vao);
-        
-        glGenBuffers(4, vbo);
-        
-        glBindBuffer(GL_ARRAY_BUFFER, vbo[0]);
-        
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
-        glEnableVertexAttribArray(0);
-        
-        glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(glm::vec3), positions.data(), GL_STATIC_DRAW);
-        
-        glBindBuffer(GL_ARRAY_BUFFER, vbo[1]);
-        
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_TRUE, 0, nullptr);
-        glEnableVertexAttribArray(1);
-        
-        glBufferData(GL_ARRAY_BUFFER, normals.size() * sizeof(glm::vec3), normals.data(), GL_STATIC_DRAW);
+      mesh.acquire("sphere/" + std::to_string(stacks) + "x" + std::to_string(slices), [this]() { return glGeometry::sphere(stacks, slices); });
 
-        glBindBuffer(GL_ARRAY_BUFFER, vbo[2]);
-        
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
-        glEnableVertexAttribArray(2);
-        
-        glBufferData(GL_ARRAY_BUFFER, textureCoords.size() * sizeof(glm::vec2), textureCoords.data(), GL_STATIC_DRAW);
-        
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vbo[3]);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indicies.size() * sizeof(GLuint), indicies.data(), GL_STATIC_DRAW);
-        
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
-        
-        glCheckError();
-        
-      }
-      
       isInitedInGpu = true;
       
     }
@@ -270,8 +195,7 @@ namespace ogl {
       
       if(isInitedInGpu) {
         
-        glDeleteBuffers(4, vbo);
-        glDeleteVertexArrays(1, &vao);
+        mesh.release();
         
         isInitedInGpu = false;
         
@@ -41,7 +41,7 @@ namespace ogl {
     
   private:
         
-    GLuint vao = 0;
+    glVertexArray vao;
     GLuint vbo = 0;
     GLuint ibo = 0;
     
@@ -51,6 +51,7 @@ namespace ogl {
     float cellSize;
 
     std::vector<GLuint> indices;
+    GLenum indicesType = GL_UNSIGNED_INT;
     
   public:
     
@@ -110,22 +111,18 @@ namespace ogl {
 
       shader.use();
 
-      shader.setUniform("projection",   camera.getProjection());
-      shader.setUniform("view",         camera.getView());
+      setInFrame(camera);
       shader.setUniform("model",        modelMatrix);
       shader.setUniform("lineWidth",    lineWidth);
-      shader.setUniform("viewport",     camera.getViewport());
       shader.setUniform("uniformColor", glm::vec4(color, 1.0f));
 
-      glBindVertexArray(vao);
+      vao.bind();
           
-      glDisable(GL_CULL_FACE);
+      glState().disable(GL_CULL_FACE);
       glDisableVertexAttribArray(1);
       glVertexAttrib4f(1, 1.0f, 1.0f, 1.0f, 1.0f);
 
-      glDrawElements(GL_LINES, (GLsizei)indices.size(), GL_UNSIGNED_INT, nullptr);
-      
-      glBindVertexArray(0);
+      glDrawElements(GL_LINES, (GLsizei)indices.size(), indicesType, nullptr);
       
       glCheckError();
             
@@ -165,22 +162,22 @@ namespace ogl {
           indices.push_back((GLuint)vertices.size() - 1);
       }
 
-      glGenVertexArrays(1, &vao);
-      glBindVertexArray(vao);
-
       glGenBuffers(1, &vbo);
       glBindBuffer(GL_ARRAY_BUFFER, vbo);
       glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec3), vertices.data(), GL_STATIC_DRAW);
 
-      glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
-      glEnableVertexAttribArray(0);
+      vao.attribute(0, vbo, 3, GL_FLOAT);
+
+      // the element binding belongs to the bound vertex array
+      glState().bindVertexArray(0);
 
       glGenBuffers(1, &ibo);
       glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
-      glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+      indicesType = glIndices::upload(indices);
+
+      vao.elements(ibo);
 
       glBindBuffer(GL_ARRAY_BUFFER, 0);
-      glBindVertexArray(0);
       
       glCheckError();
             
@@ -197,7 +194,7 @@ namespace ogl {
         
         glDeleteBuffers(1, &vbo);
         glDeleteBuffers(1, &ibo);
-        glDeleteVertexArrays(1, &vao);
+        vao.clear();
         
         isInitedInGpu = false;
 
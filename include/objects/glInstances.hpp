@@ -0,0 +1,404 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _H_OGL_INSTANCES_H_
+#define _H_OGL_INSTANCES_H_
+
+
+#ifndef _H_OGL_H_
+  #error "Do not include this header directly; include <ogl/ogl.hpp> instead."
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <cstddef>
+
+#include <vector>
+#include <algorithm>
+
+//****************************************************************************/
+// namespace ogl
+//****************************************************************************/
+namespace ogl {
+
+  //****************************************************************************/
+  // Class glInstances
+  //****************************************************************************/
+  // Many copies of one unit mesh drawn with a single glDrawElementsInstanced.
+  // Each instance has its own position, scale, rotation and color, stored in a
+  // per-instance vertex buffer (attribute divisor 1) read by the OGL_INSTANCED
+  // variant of the solid and wireframe shaders. The object transform
+  // (translate/rotate/scale) still applies to the whole batch.
+  //
+  // The setters only touch the CPU copy and grow a dirty range; render()
+  // uploads just that range with glBufferSubData, so moving a few bodies of a
+  // large batch does not resend the others. The buffer is reallocated (with
+  // doubling capacity) only when the batch outgrows it.
+  //
+  // Subclasses provide the mesh through geometry() (see glSphereInstances,
+  // glCuboidInstances).
+  //****************************************************************************/
+  class glInstances : public glShape {
+
+  public:
+
+    // Per-instance record (attributes 3..6 of the instanced shaders)
+    struct Instance_t {
+      glm::vec3 position;
+      glm::vec3 scale;
+      glm::vec4 rotation;  // unit quaternion (x, y, z, w)
+      glm::vec3 color;
+    };
+
+  private:
+
+    glVertexArray vao;
+    GLuint vbo[4];      // positions, normals, indices, instances
+
+    GLsizei indicesCount = 0;
+    GLenum  indicesType  = GL_UNSIGNED_INT;
+
+    std::vector<Instance_t> instances;
+
+    // instances capacity of the GPU buffer
+    std::size_t capacity = 0;
+
+    // range of instances changed since the last upload [dirtyFrom, dirtyTo)
+    std::size_t dirtyFrom = 0;
+    std::size_t dirtyTo   = 0;
+
+  public:
+
+    //****************************************************************************/
+    // glInstances
+    //****************************************************************************/
+    glInstances(const std::string & _name = "") : glShape(_name) { }
+
+    //****************************************************************************/
+    // ~glInstances
+    //****************************************************************************/
+    ~glInstances() { cleanInGpu(); }
+
+    glInstances(glInstances &&) noexcept = default;
+    glInstances & operator = (glInstances &&) noexcept = default;
+
+    //****************************************************************************/
+    // init()
+    //****************************************************************************/
+    void init(int _style = glShader::STYLE::SOLID, const glm::vec3 & _color = glm::vec3(1.0f)) {
+
+      DEBUG_LOG("glInstances::init(" + name + ")");
+
+      shader.setName(name);
+
+      if(_style == glShader::STYLE::WIREFRAME) {
+        shader.initWireframe("#define OGL_INSTANCED");
+      } else {
+        shader.initSolid("#define OGL_INSTANCED");
+      }
+
+      style = _style;
+      color = _color;
+
+      isInited = true;
+
+    }
+
+    //****************************************************************************/
+    // add() - append an instance, returns its index (a negative color means
+    //         the color of the batch)
+    //****************************************************************************/
+    std::size_t add(const glm::vec3 & position, const glm::vec3 & scale = glm::vec3(1.0f), const glm::vec3 & instanceColor = glm::vec3(-1.0f)) {
+
+      Instance_t instance;
+
+      instance.position = position;
+      instance.scale    = scale;
+      instance.rotation = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+      instance.color    = (instanceColor.r < 0.0f) ? color : instanceColor;
+
+      instances.push_back(instance);
+
+      setDirty(instances.size() - 1, instances.size());
+
+      return instances.size() - 1;
+
+    }
+
+    //****************************************************************************/
+    // resize() - new instances are at the origin, unit scale, batch color
+    //****************************************************************************/
+    void resize(std::size_t count) {
+
+      std::size_t oldSize = instances.size();
+
+      Instance_t instance;
+
+      instance.position = glm::vec3(0.0f);
+      instance.scale    = glm::vec3(1.0f);
+      instance.rotation = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+      instance.color    = color;
+
+      instances.resize(count, instance);
+
+      if(count > oldSize) setDirty(oldSize, count);
+
+    }
+
+    //****************************************************************************/
+    // clear()
+    //****************************************************************************/
+    inline void clear() { instances.clear(); dirtyFrom = dirtyTo = 0; }
+
+    //****************************************************************************/
+    // size()
+    //****************************************************************************/
+    inline std::size_t size() const { return instances.size(); }
+
+    //****************************************************************************/
+    // set() / get() - a whole instance
+    //****************************************************************************/
+    inline void set(std::size_t index, const Instance_t & instance) { at(index) = instance; setDirty(index, index + 1); }
+
+    inline const Instance_t & get(std::size_t index) const { return instances[index]; }
+
+    //****************************************************************************/
+    // set() - a range of instances in one go
+    //****************************************************************************/
+    void set(std::size_t from, const Instance_t * data, std::size_t count) {
+
+      if(from + count > instances.size()) {
+        fprintf(stderr, "ERROR [glInstances]: instances [%zu, %zu) out of range (%zu)\n", from, from + count, instances.size());
+        abort();
+      }
+
+      std::copy(data, data + count, instances.begin() + from);
+
+      setDirty(from, from + count);
+
+    }
+
+    //****************************************************************************/
+    // Per-instance attributes
+    //****************************************************************************/
+    inline void setPosition(std::size_t index, const glm::vec3 & position) { at(index).position = position; setDirty(index, index + 1); }
+    inline void setScale   (std::size_t index, const glm::vec3 & scale)    { at(index).scale    = scale;    setDirty(index, index + 1); }
+    inline void setColor   (std::size_t index, const glm::vec3 & value)    { at(index).color    = value;    setDirty(index, index + 1); }
+
+    //****************************************************************************/
+    // setRotation() - Euler angles, same convention as glObject::rotate()
+    //                 (R = Rx * Ry * Rz)
+    //****************************************************************************/
+    inline void setRotation(std::size_t index, const glm::vec3 & angles) {
+
+      glm::vec4 qx(sin(angles.x * 0.5f), 0.0f, 0.0f, cos(angles.x * 0.5f));
+      glm::vec4 qy(0.0f, sin(angles.y * 0.5f), 0.0f, cos(angles.y * 0.5f));
+      glm::vec4 qz(0.0f, 0.0f, sin(angles.z * 0.5f), cos(angles.z * 0.5f));
+
+      at(index).rotation = multiply(multiply(qx, qy), qz);
+
+      setDirty(index, index + 1);
+
+    }
+
+    //****************************************************************************/
+    // render()
+    //****************************************************************************/
+    void render(const glCamera & camera) {
+
+      DEBUG_LOG("glInstances::render(" + name + ")");
+
+      if(!isInited) {
+        fprintf(stderr, "ERROR [glInstances]: must be initialized before rendering\n");
+        abort();
+      }
+
+      if(isToInitInGpu()) initInGpu();
+
+      upload();
+
+      if(instances.empty()) return;
+
+      shader.use();
+
+      setInFrame(camera);
+      shader.setUniform("model", modelMatrix);
+
+      vao.bind();
+
+      if(style == glShader::STYLE::WIREFRAME) {
+        shader.setUniform("lineWidth", lineWidth);
+        glState().disable(GL_CULL_FACE);
+      } else {
+        shader.setUniform("normalMatrix", glm::transpose(glm::inverse(glm::mat3(camera.getView() * modelMatrix))));
+        light.setInFrame(camera.getView());
+        glState().enable(GL_CULL_FACE);
+        glState().cullFace(GL_BACK);
+      }
+
+      glDrawElementsInstanced(GL_TRIANGLES, indicesCount, indicesType, nullptr, (GLsizei)instances.size());
+
+      glCheckError();
+
+    }
+
+  protected:
+
+    //****************************************************************************/
+    // geometry() - the unit mesh every instance is a copy of
+    //****************************************************************************/
+    virtual glGeometry geometry() const = 0;
+
+  private:
+
+    //****************************************************************************/
+    // at() - checked access
+    //****************************************************************************/
+    inline Instance_t & at(std::size_t index) {
+
+      if(index >= instances.size()) {
+        fprintf(stderr, "ERROR [glInstances]: instance %zu out of range (%zu)\n", index, instances.size());
+        abort();
+      }
+
+      return instances[index];
+
+    }
+
+    //****************************************************************************/
+    // setDirty() - extend the range to upload
+    //****************************************************************************/
+    inline void setDirty(std::size_t from, std::size_t to) {
+
+      if(dirtyFrom == dirtyTo) { dirtyFrom = from; dirtyTo = to; return; }
+
+      dirtyFrom = std::min(dirtyFrom, from);
+      dirtyTo   = std::max(dirtyTo,   to);
+
+    }
+
+    //****************************************************************************/
+    // multiply() - quaternion product
+    //****************************************************************************/
+    static inline glm::vec4 multiply(const glm::vec4 & a, const glm::vec4 & b) {
+      return glm::vec4(a.w*b.x + a.x*b.w + a.y*b.z - a.z*b.y,
+                       a.w*b.y - a.x*b.z + a.y*b.w + a.z*b.x,
+                       a.w*b.z + a.x*b.y - a.y*b.x + a.z*b.w,
+                       a.w*b.w - a.x*b.x - a.y*b.y - a.z*b.z);
+    }
+
+    //****************************************************************************/
+    // upload() - send the dirty instances to the GPU
+    //****************************************************************************/
+    void upload() {
+
+      glBindBuffer(GL_ARRAY_BUFFER, vbo[3]);
+
+      if(instances.size() > capacity) {
+
+        capacity = std::max(instances.size(), capacity * 2);
+
+        glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(Instance_t), NULL, GL_DYNAMIC_DRAW);
+
+        dirtyFrom = 0;
+        dirtyTo   = instances.size();
+
+      }
+
+      dirtyTo = std::min(dirtyTo, instances.size());
+
+      if(dirtyFrom < dirtyTo)
+        glBufferSubData(GL_ARRAY_BUFFER, dirtyFrom * sizeof(Instance_t), (dirtyTo - dirtyFrom) * sizeof(Instance_t), &instances[dirtyFrom]);
+
+      glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+      dirtyFrom = dirtyTo = 0;
+
+    }
+
+    //****************************************************************************/
+    // setInGpu()
+    //****************************************************************************/
+    void setInGpu() {
+
+      DEBUG_LOG("glInstances::setInGpu(" + name + ")");
+
+      glGeometry mesh = geometry();
+
+      indicesCount = (GLsizei)mesh.indices.size();
+
+      glGenBuffers(4, vbo);
+
+      // Positions
+      glBindBuffer(GL_ARRAY_BUFFER, vbo[0]);
+      glBufferData(GL_ARRAY_BUFFER, mesh.positions.size() * sizeof(glm::vec3), mesh.positions.data(), GL_STATIC_DRAW);
+      vao.attribute(0, vbo[0], 3, GL_FLOAT);
+
+      // Normals
+      glBindBuffer(GL_ARRAY_BUFFER, vbo[1]);
+      glBufferData(GL_ARRAY_BUFFER, mesh.normals.size() * sizeof(glm::vec3), mesh.normals.data(), GL_STATIC_DRAW);
+      vao.attribute(1, vbo[1], 3, GL_FLOAT);
+
+      // Indices (the element binding belongs to the bound vertex array)
+      glState().bindVertexArray(0);
+      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vbo[2]);
+      indicesType = glIndices::upload(mesh.indices);
+      vao.elements(vbo[2]);
+
+      // Instances, one record per instance (divisor 1)
+      vao.attribute(3, vbo[3], 3, GL_FLOAT, GL_FALSE, sizeof(Instance_t), offsetof(Instance_t, position), 1);
+      vao.attribute(4, vbo[3], 3, GL_FLOAT, GL_FALSE, sizeof(Instance_t), offsetof(Instance_t, scale),    1);
+      vao.attribute(5, vbo[3], 4, GL_FLOAT, GL_FALSE, sizeof(Instance_t), offsetof(Instance_t, rotation), 1);
+      vao.attribute(6, vbo[3], 3, GL_FLOAT, GL_FALSE, sizeof(Instance_t), offsetof(Instance_t, color),    1);
+
+      glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+      // the new buffer is empty: upload every instance on the next render
+      capacity  = 0;
+      dirtyFrom = 0;
+      dirtyTo   = instances.size();
+
+      glCheckError();
+
+    }
+
+    //****************************************************************************/
+    // cleanInGpu()
+    //****************************************************************************/
+    void cleanInGpu() {
+
+      if(isInitedInGpu) {
+
+        glDeleteBuffers(4, vbo);
+        vao.clear();
+
+        capacity = 0;
+
+        isInitedInGpu = false;
+
+      }
+
+    }
+
+  };
+
+} /* namespace ogl */
+
+#endif /* _H_OGL_INSTANCES_H_ */
@@ -37,14 +37,21 @@ namespace ogl {
   //****************************************************************************/
   // Class glLine
   //****************************************************************************/
+  // A line strip. The vertices given to init() are uploaded once; after an
+  // update() they are written in the glStreamBuffer at every render(), which
+  // suits a line that changes every frame.
+  //****************************************************************************/
   class glLine : public glObject {
     
   private:
     
-    GLuint vao;
-    GLuint vbo;
+    glVertexArray vao;
+    GLuint vbo = 0;
 
     std::vector<glm::vec3> vertices;
+
+    // set by update(): the vertices are streamed instead of kept in vbo
+    bool isStreamed = false;
     
   public:
     
@@ -105,22 +112,34 @@ namespace ogl {
       
       shader.use();
       
-      shader.setUniform("projection", camera.getProjection());
-      shader.setUniform("view",       camera.getView());
+      setInFrame(camera);
       shader.setUniform("model",      modelMatrix);
       shader.setUniform("lineWidth",  lineWidth);
-      shader.setUniform("viewport",   camera.getViewport());
       shader.setUniform("uniformColor", glm::vec4(color, 1.0f));
       
-      glBindVertexArray(vao);
+      GLint first = 0;
+
+      if(isStreamed) {
+
+        if(vertices.empty()) return;
+
+        if(vbo != 0) { glDeleteBuffers(1, &vbo); vbo = 0; }
+
+        glStreamBuffer & stream = glStreamBuffer::instance();
+
+        first = stream.upload(vertices.data(), vertices.size() * sizeof(glm::vec3), sizeof(glm::vec3));
+
+        vao.attribute(0, stream.getBuffer(), 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3));
 
-      glDisable(GL_CULL_FACE);
+      }
+
+      vao.bind();
+
+      glState().disable(GL_CULL_FACE);
       glDisableVertexAttribArray(1);
       glVertexAttrib4f(1, 1.0f, 1.0f, 1.0f, 1.0f);
 
-      glDrawArrays(GL_LINE_STRIP, 0, (GLuint)vertices.size());
-     
-      glBindVertexArray(0);
+      glDrawArrays(GL_LINE_STRIP, first, (GLuint)vertices.size());
       
       glCheckError();
             
@@ -133,35 +152,24 @@ namespace ogl {
       
       DEBUG_LOG("glLine::setInGpu(" + name + ")");
 
-      if(!isInitedInGpu) {
+      if(isStreamed) return;
 
-      	glGenVertexArrays(1, &vao);
-      	glBindVertexArray(vao);
-      	
-      	glGenBuffers(1, &vbo);
-      	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-      	        
-      } else {
-     
-        glBindVertexArray(vao);
-        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+      if(!isInitedInGpu) glGenBuffers(1, &vbo);
 
-      }
-            
-      glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
-      glEnableVertexAttribArray(0);
+      glBindBuffer(GL_ARRAY_BUFFER, vbo);
       
       glBufferData(GL_ARRAY_BUFFER, vertices.size()*sizeof(glm::vec3), vertices.data(), GL_STATIC_DRAW);
         
       glBindBuffer(GL_ARRAY_BUFFER, 0);
-      glBindVertexArray(0);
+
+      vao.attribute(0, vbo, 3, GL_FLOAT);
       
       glCheckError();
           
     }
     
     //****************************************************************************/
-    // update() -
+    // update() - new vertices, streamed from now on
     //****************************************************************************/
     void update(const std::vector<glm::vec3> & _vertices) {
       
@@ -170,7 +178,7 @@ namespace ogl {
       if(!isInited) init(_vertices, color);
       else vertices = _vertices;
       
-      isToUpdateInGpu = true;
+      isStreamed = true;
       
     }
     
@@ -185,8 +193,9 @@ namespace ogl {
 
       if(isInitedInGpu) {
 
-        glDeleteBuffers(1, &vbo);
-        glDeleteVertexArrays(1, &vao);
+        if(vbo != 0) glDeleteBuffers(1, &vbo);
+        vbo = 0;
+        vao.clear();
               
         isInitedInGpu = false;
 
@@ -28,6 +28,8 @@
 #include <cstdio>
 #include <cstdlib>
 
+#include <cstddef>
+
 #include <vector>
 #include <string>
 
@@ -39,15 +41,41 @@ namespace ogl {
   //****************************************************************************/
   // Class glLines
   //****************************************************************************/
+  // A line strip, or a set of strips stripOffset vertices apart. All the strips
+  // are drawn with a single call, separated by the primitive restart index in
+  // an element buffer rebuilt only when the strip parameters or the number of
+  // vertices change (the indices are relative to the first vertex, so an
+  // update() of the same size keeps them).
+  //
+  // The vertices given to init() are uploaded once; after an update() they
+  // are written, interleaved with their colors, in the glStreamBuffer at every
+  // render() and the draws are offset by the index of the first one.
+  //****************************************************************************/
   class glLines : public glObject {
     
   private:
     
-    GLuint vao;
-    GLuint vbo[2];
+    glVertexArray vao;
+    GLuint vbo[3];      // positions, colors, strip indices
+
+    // strip indices in the element buffer, and the (from, to, strip, stripOffset, vertices) they were built for
+    GLsizei stripsCount = 0;
+    GLenum  stripsType  = GL_UNSIGNED_INT;
+    int     stripsKey[5] = { 0, 0, -1, -1, 0 };
         
     std::vector<glm::vec3> vertices;
     std::vector<glm::vec4> colors;
+
+    // vertex of the streamed strips
+    struct Vertex_t {
+      glm::vec3 position;
+      glm::vec4 color;
+    };
+
+    // set by update(): the vertices are streamed instead of kept in vbo[0..1]
+    bool isStreamed = false;
+
+    std::vector<Vertex_t> streamed;
         
   public:
     
@@ -116,6 +144,42 @@ namespace ogl {
 
     }
     
+    //****************************************************************************/
+    // update() - new vertices, streamed from now on (the colors are kept, the
+    //            last one repeated for the new vertices)
+    //****************************************************************************/
+    void update(const std::vector<glm::vec3> & _vertices) {
+
+      DEBUG_LOG("glLines::update(" + name + ")");
+
+      if(!isInited) init(_vertices, glm::vec4(1.0f));
+
+      vertices = _vertices;
+
+      colors.resize(vertices.size(), colors.empty() ? glm::vec4(1.0f) : colors.back());
+
+      isStreamed = true;
+
+    }
+
+    //****************************************************************************/
+    // update() - new vertices and colors, streamed from now on
+    //****************************************************************************/
+    void update(const std::vector<glm::vec3> & _vertices, const std::vector<glm::vec4> & _colors) {
+
+      DEBUG_LOG("glLines::update(" + name + ")");
+
+      if(!isInited) init(_vertices, _colors);
+
+      vertices = _vertices;
+      colors   = _colors;
+
+      colors.resize(vertices.size(), colors.empty() ? glm::vec4(1.0f) : colors.back());
+
+      isStreamed = true;
+
+    }
+
     //****************************************************************************/
     // render()
     //****************************************************************************/
@@ -132,33 +196,45 @@ namespace ogl {
       
       shader.use();
       
-      shader.setUniform("projection",   camera.getProjection());
-      shader.setUniform("view",         camera.getView());
+      setInFrame(camera);
       shader.setUniform("model",        modelMatrix);
       shader.setUniform("lineWidth",    lineWidth);
-      shader.setUniform("viewport",     camera.getViewport());
       shader.setUniform("uniformColor", glm::vec4(1.0f));
                         
-      glBindVertexArray(vao);
+      if(isStreamed && vertices.empty()) return;
+
+      // index of the first vertex in the bound buffer
+      GLint first = isStreamed ? stream() : 0;
+
+      vao.bind();
       
-      glDisable(GL_CULL_FACE);
+      glState().disable(GL_CULL_FACE);
 
       if(to == -1) to = (int) vertices.size();
       
       if(strip == -1) {
         
-        glDrawArrays(GL_LINE_STRIP, from, to - from);
+        glDrawArrays(GL_LINE_STRIP, first + from, to - from);
+
+      } else if(index != -1) {
+
+        if(index >= 0 && index <= strip) glDrawArrays(GL_LINE_STRIP, first + (index*stripOffset)+from, to);
 
       } else {
-        
-        for(int i=0; i<=strip; ++i) {
-          if(index != -1 && i != index) continue;
-          glDrawArrays(GL_LINE_STRIP, (i*stripOffset)+from, to);
-        }
+
+        if(stripsKey[0] != from || stripsKey[1] != to || stripsKey[2] != strip || stripsKey[3] != stripOffset || stripsKey[4] != (int) vertices.size())
+          setStrips(from, to, strip, stripOffset);
+
+        glState().enable(GL_PRIMITIVE_RESTART);
+        glPrimitiveRestartIndex(glIndices::getRestart(stripsType));
+
+        // the restart index is compared before the base vertex is added
+        glDrawElementsBaseVertex(GL_LINE_STRIP, stripsCount, stripsType, nullptr, first);
+
+        // a restart index is a valid index of the other index type
+        glState().disable(GL_PRIMITIVE_RESTART);
         
       }
-
-      glBindVertexArray(0);
       
       glCheckError();
       
@@ -167,6 +243,27 @@ namespace ogl {
     
   private:
     
+    //****************************************************************************/
+    // stream() - write the vertices in the glStreamBuffer and point the vertex
+    //            array at them; returns the index of the first one
+    //****************************************************************************/
+    GLint stream() {
+
+      streamed.resize(vertices.size());
+
+      for(std::size_t i=0; i<vertices.size(); ++i) streamed[i] = { vertices[i], colors[i] };
+
+      glStreamBuffer & stream = glStreamBuffer::instance();
+
+      GLint first = stream.upload(streamed.data(), streamed.size() * sizeof(Vertex_t), sizeof(Vertex_t));
+
+      vao.attribute(0, stream.getBuffer(), 3, GL_FLOAT, GL_FALSE, sizeof(Vertex_t), offsetof(Vertex_t, position));
+      vao.attribute(1, stream.getBuffer(), 4, GL_FLOAT, GL_FALSE, sizeof(Vertex_t), offsetof(Vertex_t, color));
+
+      return first;
+
+    }
+
     //****************************************************************************/
     // setInGpu()
     //****************************************************************************/
@@ -176,26 +273,27 @@ namespace ogl {
       
       if(!isInitedInGpu) {
         
-        glGenVertexArrays(1, &vao);
-        glBindVertexArray(vao);
-        
-        glGenBuffers(2, vbo);
+        glGenBuffers(3, vbo);
         
-        glBindBuffer(GL_ARRAY_BUFFER, vbo[0]);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
-        glEnableVertexAttribArray(0);
-        
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec3), vertices.data(), GL_STATIC_DRAW);
+        // the streamed vertices are pointed at by stream()
+        if(!isStreamed) {
+
+          glBindBuffer(GL_ARRAY_BUFFER, vbo[0]);
+          glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec3), vertices.data(), GL_STATIC_DRAW);
+          vao.attribute(0, vbo[0], 3, GL_FLOAT);
      
-        glBindBuffer(GL_ARRAY_BUFFER, vbo[1]);
-        
-        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 0, nullptr);
-        glEnableVertexAttribArray(1);
-        
-        glBufferData(GL_ARRAY_BUFFER, colors.size() * sizeof(glm::vec4), colors.data(), GL_STATIC_DRAW);
+          glBindBuffer(GL_ARRAY_BUFFER, vbo[1]);
+          glBufferData(GL_ARRAY_BUFFER, colors.size() * sizeof(glm::vec4), colors.data(), GL_STATIC_DRAW);
+          vao.attribute(1, vbo[1], 4, GL_FLOAT);
+
+        }
+
+        // filled by setStrips()
+        vao.elements(vbo[2]);
+
+        stripsKey[2] = -1;
         
         glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
         
         glCheckError();
         
@@ -205,6 +303,36 @@ namespace ogl {
       
     }
     
+    //****************************************************************************/
+    // setStrips() - indices of the strips i*stripOffset + from, to vertices each,
+    //               followed by the restart index
+    //****************************************************************************/
+    void setStrips(int from, int to, int strip, int stripOffset) {
+
+      std::vector<GLuint> strips;
+
+      for(int i=0; i<=strip; ++i) {
+        for(int k=0; k<to; ++k) {
+          int vertex = (i*stripOffset) + from + k;
+          if(vertex >= 0 && vertex < (int) vertices.size()) strips.push_back((GLuint) vertex);
+        }
+        strips.push_back(glIndices::RESTART32);
+      }
+
+      // the element binding belongs to the bound vertex array
+      glState().bindVertexArray(0);
+
+      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vbo[2]);
+      stripsType = glIndices::upload(strips, GL_DYNAMIC_DRAW);
+
+      stripsCount = (GLsizei) strips.size();
+
+      stripsKey[0] = from; stripsKey[1] = to; stripsKey[2] = strip; stripsKey[3] = stripOffset; stripsKey[4] = (int) vertices.size();
+
+      vao.bind();
+
+    }
+
     //****************************************************************************/
     // cleanInGpu()
     //****************************************************************************/
@@ -212,8 +340,8 @@ namespace ogl {
       
       if(isInitedInGpu) {
         
-        glDeleteBuffers(2, vbo);
-        glDeleteVertexArrays(1, &vao);
+        glDeleteBuffers(3, vbo);
+        vao.clear();
         
         isInitedInGpu = false;
         
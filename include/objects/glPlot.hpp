@@ -56,7 +56,7 @@ namespace ogl {
 
   private:
 
-    GLuint vao = 0;
+    glVertexArray vao;
     GLuint vbo = 0;
     GLuint ibo = 0;
 
@@ -98,6 +98,7 @@ namespace ogl {
     std::vector<glm::vec3> vertices;
     std::vector<glm::vec4> colors;
     std::vector<GLuint> indices;
+    GLenum indicesType = GL_UNSIGNED_INT;
 
   public:
 
@@ -285,22 +286,19 @@ namespace ogl {
 
       shader.use();
 
-      shader.setUniform("projection", camera.getProjection());
-      shader.setUniform("view",       camera.getView());
+      setInFrame(camera);
       shader.setUniform("model",      modelMatrix);
       shader.setUniform("uniformColor", glm::vec4(1.0f));
       shader.setUniform("lineWidth",  lineWidth);
-      shader.setUniform("viewport",   camera.getViewport());
 
-      glBindVertexArray(vao);
+      vao.bind();
 
-      glDisable(GL_CULL_FACE);
+      glState().disable(GL_CULL_FACE);
       glEnableVertexAttribArray(1);
 
-      glDrawElements(GL_LINES, (GLsizei)indices.size(), GL_UNSIGNED_INT, nullptr);
+      glDrawElements(GL_LINES, (GLsizei)indices.size(), indicesType, nullptr);
 
       glDisableVertexAttribArray(1);
-      glBindVertexArray(0);
 
       renderLabels(camera);
 
@@ -537,27 +535,25 @@ namespace ogl {
 
       buildGeometry();
 
-      glGenVertexArrays(1, &vao);
-      glBindVertexArray(vao);
-
       glGenBuffers(1, &vbo);
       glBindBuffer(GL_ARRAY_BUFFER, vbo);
       glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec3) + colors.size() * sizeof(glm::vec4), nullptr, GL_STATIC_DRAW);
       glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(glm::vec3), vertices.data());
       glBufferSubData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec3), colors.size() * sizeof(glm::vec4), colors.data());
 
-      glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), nullptr);
-      glEnableVertexAttribArray(0);
+      vao.attribute(0, vbo, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3));
+      vao.attribute(1, vbo, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), vertices.size() * sizeof(glm::vec3));
 
-      glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void*)(vertices.size() * sizeof(glm::vec3)));
-      glEnableVertexAttribArray(1);
+      // the element binding belongs to the bound vertex array
+      glState().bindVertexArray(0);
 
       glGenBuffers(1, &ibo);
       glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
-      glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+      indicesType = glIndices::upload(indices);
+
+      vao.elements(ibo);
 
       glBindBuffer(GL_ARRAY_BUFFER, 0);
-      glBindVertexArray(0);
 
       glCheckError();
       
@@ -572,9 +568,8 @@ namespace ogl {
 
         if(vbo != 0) glDeleteBuffers(1, &vbo);
         if(ibo != 0) glDeleteBuffers(1, &ibo);
-        if(vao != 0) glDeleteVertexArrays(1, &vao);
+        vao.clear();
 
-        vao = 0;
         vbo = 0;
         ibo = 0;
 
@@ -28,6 +28,8 @@
 #include <cstdio>
 #include <cstdlib>
 
+#include <cstddef>
+
 #include <vector>
 #include <string>
 
@@ -43,17 +45,32 @@ namespace ogl {
   // shaded as a little 3D sphere in points.fs). It derives from glShape to reuse
   // the per-object light, so the points react to setLight() just like the solid
   // primitives; with no explicit light they fall back to a camera head light.
+  //
+  // The points given to init() are uploaded once; after an update() they are
+  // written, interleaved with their colors, in the glStreamBuffer at every
+  // render(), which suits a cloud that changes every frame.
   //****************************************************************************/
   class glPoints : public glShape {
     
   private:
         
-    GLuint vao = 0;
-    GLuint vbo[2];
+    glVertexArray vao;
+    GLuint vbo[2] = { 0, 0 };
     
     std::vector<glm::vec3> points;
     std::vector<glm::vec4> colors;
 
+    // vertex of the streamed points
+    struct Vertex_t {
+      glm::vec3 position;
+      glm::vec4 color;
+    };
+
+    // set by update(): the points are streamed instead of kept in vbo
+    bool isStreamed = false;
+
+    std::vector<Vertex_t> streamed;
+
     float radius;
 
     // how the impostors are shaded (see points.fs); PHONG keeps the old look
@@ -129,6 +146,42 @@ namespace ogl {
       
     }
     
+    //****************************************************************************/
+    // update() - new points, streamed from now on (the colors are kept, the
+    //            last one repeated for the new points)
+    //****************************************************************************/
+    void update(const std::vector<glm::vec3> & _points) {
+
+      DEBUG_LOG("glPoints::update(" + name + ")");
+
+      if(!isInited) { init(_points); isStreamed = true; return; }
+
+      points = _points;
+
+      colors.resize(points.size(), colors.empty() ? glm::vec4(1.0f) : colors.back());
+
+      isStreamed = true;
+
+    }
+
+    //****************************************************************************/
+    // update() - new points and colors, streamed from now on
+    //****************************************************************************/
+    void update(const std::vector<glm::vec3> & _points, const std::vector<glm::vec4> & _colors) {
+
+      DEBUG_LOG("glPoints::update(" + name + ")");
+
+      if(!isInited) init(_points, _colors, 1);
+
+      points = _points;
+      colors = _colors;
+
+      colors.resize(points.size(), colors.empty() ? glm::vec4(1.0f) : colors.back());
+
+      isStreamed = true;
+
+    }
+
     //****************************************************************************/
     // setRadius()
     //****************************************************************************/
@@ -156,15 +209,13 @@ namespace ogl {
       
       shader.use();
       
-      shader.setUniform("projection", camera.getProjection());
-      shader.setUniform("view",       camera.getView());
+      setInFrame(camera);
       shader.setUniform("model",      modelMatrix);
       shader.setUniform("pointSize",  radius);
       shader.setUniform("shadingMode", shadingMode);
-      shader.setUniform("viewport",   camera.getViewport());
 
       // Shade the impostors with the scene light (head-light fallback by default).
-      light.setInShader(shader, camera.getView());
+      light.setInFrame(camera.getView());
             
       int n = (int) points.size();
 
@@ -188,20 +239,20 @@ namespace ogl {
 
       if(count <= 0) return;
 
-      glEnable(GL_PROGRAM_POINT_SIZE);
+      if(isStreamed) from += stream();
 
-      glBindVertexArray(vao);
+      glState().enable(GL_PROGRAM_POINT_SIZE);
+
+      vao.bind();
 
       //glEnable(GL_CULL_FACE);
       //glCullFace(GL_BACK);
 
-      glDisable(GL_BLEND);
+      glState().disable(GL_BLEND);
 
       glDrawArrays(GL_POINTS, from, count);
 
-      glDisable(GL_PROGRAM_POINT_SIZE);
-
-      glBindVertexArray(0);
+      glState().disable(GL_PROGRAM_POINT_SIZE);
       
       glCheckError();
 
@@ -209,6 +260,29 @@ namespace ogl {
     
   private:
     
+    //****************************************************************************/
+    // stream() - write the points in the glStreamBuffer and point the vertex
+    //            array at them; returns the index of the first one
+    //****************************************************************************/
+    GLint stream() {
+
+      if(vbo[0] != 0) { glDeleteBuffers(2, vbo); vbo[0] = vbo[1] = 0; }
+
+      streamed.resize(points.size());
+
+      for(std::size_t i=0; i<points.size(); ++i) streamed[i] = { points[i], colors[i] };
+
+      glStreamBuffer & stream = glStreamBuffer::instance();
+
+      GLint first = stream.upload(streamed.data(), streamed.size() * sizeof(Vertex_t), sizeof(Vertex_t));
+
+      vao.attribute(0, stream.getBuffer(), 3, GL_FLOAT, GL_FALSE, sizeof(Vertex_t), offsetof(Vertex_t, position));
+      vao.attribute(1, stream.getBuffer(), 4, GL_FLOAT, GL_FALSE, sizeof(Vertex_t), offsetof(Vertex_t, color));
+
+      return first;
+
+    }
+
     //****************************************************************************/
     // setInGpu()
     //****************************************************************************/
@@ -216,29 +290,19 @@ namespace ogl {
       
       DEBUG_LOG("glPoints::setInGpu(" + name + ")");
 
-      if(!isInitedInGpu) {
+      if(!isInitedInGpu && !isStreamed) {
               
-        glGenVertexArrays(1, &vao);
-        glBindVertexArray(vao);
-        
         glGenBuffers(2, vbo);
         
         glBindBuffer(GL_ARRAY_BUFFER, vbo[0]);
-        
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
-        glEnableVertexAttribArray(0);
-        
         glBufferData(GL_ARRAY_BUFFER, points.size() * sizeof(glm::vec3), points.data(), GL_STATIC_DRAW);
+        vao.attribute(0, vbo[0], 3, GL_FLOAT);
         
         glBindBuffer(GL_ARRAY_BUFFER, vbo[1]);
-        
-        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 0, nullptr);
-        glEnableVertexAttribArray(1);
-        
         glBufferData(GL_ARRAY_BUFFER, colors.size() * sizeof(glm::vec4), colors.data(), GL_STATIC_DRAW);
+        vao.attribute(1, vbo[1], 4, GL_FLOAT);
               
         glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
         
         glCheckError();
         
@@ -255,8 +319,9 @@ namespace ogl {
       
       if(isInitedInGpu) {
         
-        glDeleteBuffers(2, vbo);
-        glDeleteVertexArrays(1, &vao);
+        if(vbo[0] != 0) glDeleteBuffers(2, vbo);
+        vbo[0] = vbo[1] = 0;
+        vao.clear();
         
         isInitedInGpu = false;
 
@@ -29,6 +29,7 @@
 #include <cstdlib>
 
 #include <string>
+#include <vector>
 
 //****************************************************************************/
 // namespace ogl
@@ -38,16 +39,24 @@ namespace ogl {
   //****************************************************************************/
   // Class glPrint2D
   //****************************************************************************/
-  // Draws text in screen space. The glyph atlas is shared through glFont, so
-  // this object only owns the small dynamic quad buffer (vao/vbo). 'color' is
-  // inherited from glObject.
+  // Draws text in screen space. The glyph atlas is shared through glFont and
+  // the quads of the string are written in the glStreamBuffer once per
+  // render(), so this object only owns its vertex array. With the text
+  // batching of the window on (the default) the quads go to the glTextBatch
+  // instead, drawn with all the text of the frame. 'color' is inherited from
+  // glObject.
   //****************************************************************************/
   class glPrint2D : public glObject {
 
   private:
 
-    GLuint vao;
-    GLuint vbo;
+    glVertexArray vao;
+
+    // quads of the last render(), 6 vertices each
+    std::vector<glm::vec4> quads;
+
+    // glFont mode the shader was built for
+    int atlasMode = glFont::BITMAP;
 
     float x;
     float y;
@@ -178,80 +187,54 @@ namespace ogl {
       
       if(isToInitInGpu()) initInGpu();
       
+      quads.clear();
+
+      // the quads of the whole string, in the single atlas texture
+      glFont::instance().layout(text, x, y, scale, quads);
+      
+      if(quads.empty()) return;
+
+      // drawn with the text of the other objects at the end of the frame
+      if(glWindow::current()->getTextBatching()) {
+        glTextBatch::instance().add(quads, glm::vec4(color, 1.0f));
+        return;
+      }
+
+      if(atlasMode != glFont::instance().getMode()) {
+        atlasMode = glFont::instance().getMode();
+        shader.initText(glFont::instance().getDefines());
+      }
+
       shader.use();
       
-      shader.setUniform("projection", camera.getOrthoProjection());
+      setInFrame(camera);
       shader.setUniform("color",      color);
                   
-      glEnable(GL_CULL_FACE);
-      glCullFace(GL_BACK);
+      glState().enable(GL_CULL_FACE);
+      glState().cullFace(GL_BACK);
 
-      glEnable(GL_BLEND);
+      glState().enable(GL_BLEND);
       
-      glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-                  
-      glBindVertexArray(vao);
+      glState().blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-      glActiveTexture(GL_TEXTURE0);
-      
-      glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-      
-      float tmpX = x;
-      float tmpY = y;
-
-      // iterate through all characters
-      for(std::string::const_iterator c = text.begin(); c != text.end(); c++) {
-        
-        if(*c == '\n') {
-          const glFont::Character_t * chA = glFont::instance().get('a');
-          float lineHeight = chA ? chA->Size.y * scale : 0.0f;
-          tmpX  = x;
-          tmpY -= 2 * lineHeight;
-          continue;
-        }
-
-        // skip characters that were not loaded (e.g. non-ASCII)
-        const glFont::Character_t * chp = glFont::instance().get(*c);
-        if(chp == nullptr) continue;
-        const glFont::Character_t & ch = *chp;
-                
-        float xpos = tmpX + ch.Bearing.x * scale;
-        float ypos = tmpY - (ch.Size.y - ch.Bearing.y) * scale;
-        
-        float w = ch.Size.x * scale;
-        float h = ch.Size.y * scale;
-        
-        // update VBO for each character
-        float vertices[6][4] = {
-          { xpos,     ypos + h,   0.0f, 0.0f },
-          { xpos,     ypos,       0.0f, 1.0f },
-          { xpos + w, ypos,       1.0f, 1.0f },
-          
-          { xpos,     ypos + h,   0.0f, 0.0f },
-          { xpos + w, ypos,       1.0f, 1.0f },
-          { xpos + w, ypos + h,   1.0f, 0.0f }
-        };
-        
-        // render glyph texture over quad
-        glBindTexture(GL_TEXTURE_2D, ch.TextureID);
-        
-        // update content of VBO memory
-        glBindBuffer(GL_ARRAY_BUFFER, vbo);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices); // be sure to use glBufferSubData and not glBufferData
-                
-        // render quad
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        
-        // now advance cursors for next glyph (note that advance is number of 1/64 pixels
-        tmpX += (ch.Advance >> 6) * scale; // bitshift by 6 to get value in pixels (2^6 = 64 (divide amount of 1/64th pixels by 64 to get amount of pixels))
-        
-        glCheckError();
-        
-      }
+      glState().activeTexture(0);
       
-      glBindTexture(GL_TEXTURE_2D, 0);
-      
-      glBindVertexArray(0);
+      glState().polygonMode(GL_FILL);
+
+      // one upload for the whole string
+      glStreamBuffer & stream = glStreamBuffer::instance();
+
+      GLint first = stream.upload(quads.data(), quads.size() * sizeof(glm::vec4), sizeof(glm::vec4));
+
+      vao.attribute(0, stream.getBuffer(), 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4));
+
+      vao.bind();
+
+      glState().bindTexture(0, glFont::instance().getTexture());
+
+      glDrawArrays(GL_TRIANGLES, first, (GLsizei)quads.size());
+
+      glFont::instance().countDraw(quads.size());
       
       glCheckError();
       
@@ -267,21 +250,6 @@ namespace ogl {
       // Build the shared glyph atlas once (no-op if another text object already did).
       glFont::instance().load();
 
-      // configure VAO/VBO for texture quads
-      glGenVertexArrays(1, &vao);
-      glBindVertexArray(vao);
-
-      glGenBuffers(1, &vbo);
-      glBindBuffer(GL_ARRAY_BUFFER, vbo);
-      
-      glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
-      glEnableVertexAttribArray(0);
-
-      glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
-            
-      glBindBuffer(GL_ARRAY_BUFFER, 0);
-      glBindVertexArray(0);
-      
       glCheckError();
       
     }
@@ -293,10 +261,9 @@ namespace ogl {
       
       if(isInitedInGpu) {
 
-        // Only the per-instance quad buffer is freed here; the glyph textures
-        // belong to the shared glFont atlas and must outlive this object.
-        glDeleteBuffers(1, &vbo);
-        glDeleteVertexArrays(1, &vao);
+        // Only the vertex array is freed here; the glyph textures belong to
+        // the shared glFont atlas and the quads to the glStreamBuffer.
+        vao.clear();
 
         isInitedInGpu = false;
 
@@ -38,12 +38,16 @@ namespace ogl {
   //****************************************************************************/
   // class glQuad
   //****************************************************************************/
+  // A sized quad draws the unit square of glGeometry::quad(), shared through
+  // glGeometries, scaled by its size in the model matrix. A quad built from
+  // six explicit vertices owns its mesh.
+  //****************************************************************************/
   class glQuad : public glShape {
 
     private:
 
-      GLuint vao = 0;
-      GLuint vbo[2];
+      glSharedGeometry mesh;
+      glGeometries::Mesh_t ownMesh;
       glm::vec2 size;
       bool cullFaceEnabled = false;
 
@@ -144,30 +148,48 @@ namespace ogl {
 
         shader.use();
 
-        shader.setUniform("projection", camera.getProjection());
-        shader.setUniform("view", camera.getView());
-        shader.setUniform("model", modelMatrix);
+        setInFrame(camera);
+        shader.setUniform("model", modelMatrix * glm::scale(glm::mat4(1.0f), glm::vec3(size, 1.0f)));
         shader.setUniform("color", color);
         if(style == glShader::STYLE::SOLID) {
-          light.setInShader(shader, camera.getView());
+          light.setInFrame(camera.getView());
         }
 
-        glBindVertexArray(vao);
+        if(vertices.empty()) mesh.bind(); else ownMesh.vao.bind();
 
         if(style == glShader::STYLE::WIREFRAME) {
           shader.setUniform("lineWidth", lineWidth);
-          shader.setUniform("viewport",  camera.getViewport());
-          glDisable(GL_CULL_FACE);
+          glState().disable(GL_CULL_FACE);
         } else if(cullFaceEnabled) {
-          glEnable(GL_CULL_FACE);
-          glCullFace(GL_BACK);
+          glState().enable(GL_CULL_FACE);
+          glState().cullFace(GL_BACK);
         } else {
-          glDisable(GL_CULL_FACE);
+          glState().disable(GL_CULL_FACE);
         }
 
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        glDrawElements(GL_TRIANGLES, vertices.empty() ? mesh.getCount() : ownMesh.count, vertices.empty() ? mesh.getType() : ownMesh.type, nullptr);
+
+        glCheckError();
+
+      }
+
+      //****************************************************************************/
+      // renderDepth() - depth only, for the pre-pass (SOLID style)
+      //****************************************************************************/
+      void renderDepth(const glCamera & camera) {
 
-        glBindVertexArray(0);
+        if(!useDepth(camera, modelMatrix * glm::scale(glm::mat4(1.0f), glm::vec3(size, 1.0f)))) return;
+
+        if(vertices.empty()) mesh.bind(); else ownMesh.vao.bind();
+
+        if(cullFaceEnabled) {
+          glState().enable(GL_CULL_FACE);
+          glState().cullFace(GL_BACK);
+        } else {
+          glState().disable(GL_CULL_FACE);
+        }
+
+        glDrawElements(GL_TRIANGLES, vertices.empty() ? mesh.getCount() : ownMesh.count, vertices.empty() ? mesh.getType() : ownMesh.type, nullptr);
 
         glCheckError();
 
@@ -187,61 +209,27 @@ namespace ogl {
         
         DEBUG_LOG("glQuad::setInGpu(" + name + ")");
         
-        GLfloat _vertices[18]; // 6 vertices * 3 coords
-        
-        if(vertices.size() != 0) {
-          
-          for(int i=0; i<6; ++i) {
-            _vertices[i * 3 + 0] = vertices[i].x;
-            _vertices[i * 3 + 1] = vertices[i].y;
-            _vertices[i * 3 + 2] = vertices[i].z;
-          }
-          
-        } else {
-          
-          GLfloat defaultVertices[] = { -0.5f * size.x,  0.5f * size.y, 0.0f,
-            -0.5f * size.x, -0.5f * size.y, 0.0f,
-            0.5f * size.x, -0.5f * size.y, 0.0f,
-            -0.5f * size.x,  0.5f * size.y, 0.0f,
-            0.5f * size.x, -0.5f * size.y, 0.0f,
-            0.5f * size.x,  0.5f * size.y, 0.0f };
-          
-          memcpy(_vertices, defaultVertices, sizeof(defaultVertices));
-          
+        if(vertices.empty()) {
+          mesh.acquire("quad", []() { return glGeometry::quad(); });
+          return;
         }
-        
-        glGenVertexArrays(1, &vao);
-        glBindVertexArray(vao);
-        
-        glGenBuffers(2, vbo);
-        glBindBuffer(GL_ARRAY_BUFFER, vbo[0]);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(_vertices), _vertices, GL_STATIC_DRAW);
-        
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (void*)0);
-        glEnableVertexAttribArray(0);
 
         glm::vec3 normal(0.0f, 0.0f, 1.0f);
-        if(vertices.size() == 6) {
-          glm::vec3 edgeA = vertices[1] - vertices[0];
-          glm::vec3 edgeB = vertices[2] - vertices[0];
-          glm::vec3 computed = glm::normalize(glm::cross(edgeA, edgeB));
-          if(glm::length(computed) > 0.0f) {
-            normal = computed;
-          }
+        glm::vec3 edgeA = vertices[1] - vertices[0];
+        glm::vec3 edgeB = vertices[2] - vertices[0];
+        glm::vec3 computed = glm::normalize(glm::cross(edgeA, edgeB));
+        if(glm::length(computed) > 0.0f) {
+          normal = computed;
         }
 
-        glm::vec3 normals[6] = { normal, normal, normal, normal, normal, normal };
+        glGeometry geometry;
+
+        geometry.positions = vertices;
+        geometry.normals   = std::vector<glm::vec3>(6, normal);
+        geometry.indices   = { 0, 1, 2, 3, 4, 5 };
+
+        ownMesh = glGeometries::upload(geometry);
 
-        glBindBuffer(GL_ARRAY_BUFFER, vbo[1]);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(normals), normals, GL_STATIC_DRAW);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_TRUE, 0, nullptr);
-        glEnableVertexAttribArray(1);
-        
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
-        
-        glCheckError();
-        
       }
     
       //****************************************************************************/
@@ -250,8 +238,8 @@ namespace ogl {
       void cleanInGpu() {
         
         if(isInitedInGpu) {
-          glDeleteBuffers(2, vbo);
-          glDeleteVertexArrays(1, &vao);
+          mesh.release();
+          glGeometries::destroy(ownMesh);
           isInitedInGpu = false;
         }
         
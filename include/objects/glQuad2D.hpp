@@ -40,7 +40,7 @@ namespace ogl {
     
   private:
     
-    GLuint vao = 0;
+    glVertexArray vao;
     GLuint vbo = 0;
 
     glm::vec2 position;
@@ -117,22 +117,20 @@ namespace ogl {
       
       shader.use();
       
+      setInFrame(camera);
       shader.setUniform("color", color);
-      shader.setUniform("viewport", camera.getViewport());
       
-      glDisable(GL_CULL_FACE);
+      glState().disable(GL_CULL_FACE);
 
-      glEnable(GL_BLEND);
+      glState().enable(GL_BLEND);
 
-      glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+      glState().blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-      glBindVertexArray(vao);
+      vao.bind();
       
-      glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+      glState().polygonMode(GL_FILL);
 
       glDrawArrays(GL_TRIANGLES, 0, 6);
-
-      glBindVertexArray(0);
             
       glCheckError();
             
@@ -147,19 +145,14 @@ namespace ogl {
       
       DEBUG_LOG("glQuad2D::setInGpu(" + name + ")");
 
-      glGenVertexArrays(1, &vao);
-      glBindVertexArray(vao);
-      
       glGenBuffers(1, &vbo);
       glBindBuffer(GL_ARRAY_BUFFER, vbo);
       
-      glEnableVertexAttribArray(0);
-      glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
-      
       glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec2), vertices.data(), GL_STATIC_DRAW);
 
       glBindBuffer(GL_ARRAY_BUFFER, 0);
-      glBindVertexArray(0);
+
+      vao.attribute(0, vbo, 2, GL_FLOAT);
       
       glCheckError();
       
@@ -173,7 +166,7 @@ namespace ogl {
       if(isInitedInGpu) {
         
         glDeleteBuffers(1, &vbo);
-        glDeleteVertexArrays(1, &vao);
+        vao.clear();
         isInitedInGpu = false;
         
       }
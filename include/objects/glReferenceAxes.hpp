@@ -52,7 +52,7 @@ namespace ogl {
 
   private:
 
-    GLuint vao = 0;
+    glVertexArray vao;
     GLuint vbo = 0;
 
     // Axis colors: X=red, Y=green, Z=blue. Shared constant, not per-object state
@@ -138,8 +138,8 @@ namespace ogl {
 
       glViewport(overlayX, overlayY, overlaySize, overlaySize);
 
-      glDisable(GL_DEPTH_TEST);
-      glDisable(GL_CULL_FACE);
+      glState().disable(GL_DEPTH_TEST);
+      glState().disable(GL_CULL_FACE);
 
       // --- Draw the three axes ---
 
@@ -154,13 +154,14 @@ namespace ogl {
       // radians fix in glCamera::eulerRotation()).
       glm::mat4 viewRotOnly = glm::mat4(glm::mat3(camera.getView()));
 
-      shader.setUniform("projection", projection);
-      shader.setUniform("view",       viewRotOnly);
+      // The gizmo has its own camera: the labels (and any later object) put
+      // the real one back in the frame block through their own setInFrame().
+      glWindow::current()->getFrame().set(projection, viewRotOnly, camera.getOrthoProjection(), glm::vec2(overlaySize, overlaySize));
+
       shader.setUniform("model",      modelMatrix);
       shader.setUniform("lineWidth",  lineWidth);
-      shader.setUniform("viewport",   glm::vec2(overlaySize, overlaySize));
 
-      glBindVertexArray(vao);
+      vao.bind();
       glDisableVertexAttribArray(1);
       glVertexAttrib4f(1, 1.0f, 1.0f, 1.0f, 1.0f);
 
@@ -169,8 +170,6 @@ namespace ogl {
         glDrawArrays(GL_LINES, i * 2, 2);
       }
 
-      glBindVertexArray(0);
-
       // --- Restore main viewport before rendering labels ---
       glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
 
@@ -206,7 +205,7 @@ namespace ogl {
 
       }
 
-      glEnable(GL_DEPTH_TEST);
+      glState().enable(GL_DEPTH_TEST);
 
       glCheckError();
 
@@ -221,19 +220,14 @@ namespace ogl {
 
       DEBUG_LOG("glReferenceAxes::setInGpu(" + name + ")");
 
-      glGenVertexArrays(1, &vao);
-      glBindVertexArray(vao);
-
       glGenBuffers(1, &vbo);
       glBindBuffer(GL_ARRAY_BUFFER, vbo);
 
-      glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
-      glEnableVertexAttribArray(0);
-
       glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec3), vertices.data(), GL_STATIC_DRAW);
 
       glBindBuffer(GL_ARRAY_BUFFER, 0);
-      glBindVertexArray(0);
+
+      vao.attribute(0, vbo, 3, GL_FLOAT);
 
       glCheckError();
 
@@ -246,7 +240,7 @@ namespace ogl {
 
       if(isInitedInGpu) {
         glDeleteBuffers(1, &vbo);
-        glDeleteVertexArrays(1, &vao);
+        vao.clear();
         isInitedInGpu = false;
       }
 
@@ -40,6 +40,8 @@ namespace ogl {
   // style, lineWidth, color) it adds the per-object light used for Phong
   // shading, so the light handling is written once instead of being copied into
   // every object. Still abstract: subclasses implement setInGpu()/cleanInGpu().
+  // The SOLID ones also implement renderDepth() for the depth pre-pass of
+  // glRenderQueue, on top of useDepth().
   //****************************************************************************/
   class glShape : public glObject {
 
@@ -47,6 +49,10 @@ namespace ogl {
 
     ogl::glLight light;
 
+    // Position only program of renderDepth(), initialized on first use
+    glShader depthShader;
+    bool isDepthShaderInited = false;
+
   public:
 
     glShape(const std::string & _name = "") : glObject(_name) { }
@@ -59,6 +65,38 @@ namespace ogl {
       light.setDirection(_direction);
     }
 
+  protected:
+
+    //****************************************************************************/
+    // useDepth() - Use the depth program with the model matrix of the mesh,
+    //              false when the style has no depth pass (only SOLID does)
+    //****************************************************************************/
+    bool useDepth(const glCamera & camera, const glm::mat4 & model) {
+
+      if(style != glShader::STYLE::SOLID) return false;
+
+      if(!isInited) {
+        fprintf(stderr, "ERROR [glShape]: must be initialized before rendering\n");
+        abort();
+      }
+
+      if(isToInitInGpu()) initInGpu();
+
+      if(!isDepthShaderInited) {
+        depthShader.setName(name);
+        depthShader.initDepth();
+        isDepthShaderInited = true;
+      }
+
+      depthShader.use();
+
+      setInFrame(camera);
+      depthShader.setUniform("model", model);
+
+      return true;
+
+    }
+
   }; /* class glShape */
 
 } /* namespace ogl */
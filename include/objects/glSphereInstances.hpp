@@ -0,0 +1,95 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _H_OGL_SPHEREINSTANCES_H_
+#define _H_OGL_SPHEREINSTANCES_H_
+
+#ifndef _H_OGL_H_
+  #error "Do not include this header directly; include <ogl/ogl.hpp> instead."
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+
+//****************************************************************************/
+// namespace ogl
+//****************************************************************************/
+namespace ogl {
+
+  //****************************************************************************/
+  // Class glSphereInstances
+  //****************************************************************************/
+  // A batch of spheres (or ellipsoids, through a non-uniform instance scale)
+  // drawn in one instanced call. The instance scale is the radius, or the
+  // three semi-axes:
+  //
+  //   ogl::glSphereInstances bodies(12, 12);
+  //   for(auto & body : simulation) bodies.add(body.position, glm::vec3(body.radius));
+  //   ...
+  //   bodies.setPosition(i, newPosition);   // only the changed bodies are uploaded
+  //   bodies.render(camera);
+  //****************************************************************************/
+  class glSphereInstances : public glInstances {
+
+  private:
+
+    int stacks;
+    int slices;
+
+  public:
+
+    //****************************************************************************/
+    // glSphereInstances()
+    //****************************************************************************/
+    glSphereInstances(const std::string & _name = "") : glInstances(_name) { }
+
+    //****************************************************************************/
+    // glSphereInstances()
+    //****************************************************************************/
+    glSphereInstances(int _slices, int _stacks, int _style = glShader::STYLE::SOLID, const glm::vec3 & _color = glm::vec3(1.0), const std::string & _name = "") : glInstances(_name) {
+      init(_slices, _stacks, _style, _color);
+    }
+
+    //****************************************************************************/
+    // init()
+    //****************************************************************************/
+    void init(int _slices, int _stacks, int _style = glShader::STYLE::SOLID, const glm::vec3 & _color = glm::vec3(1.0)) {
+
+      DEBUG_LOG("glSphereInstances::init(" + name + ")");
+
+      slices = _slices;
+      stacks = _stacks;
+
+      glInstances::init(_style, _color);
+
+    }
+
+  protected:
+
+    //****************************************************************************/
+    // geometry() - unit sphere
+    //****************************************************************************/
+    glGeometry geometry() const { return glGeometry::sphere(stacks, slices); }
+
+  };
+
+} /* namespace ogl */
+
+#endif /* _H_OGL_SPHEREINSTANCES_H_ */
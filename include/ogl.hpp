@@ -57,15 +57,27 @@
 #include <ogl/utils/glfw.hpp>
 #include <ogl/utils/error.hpp>
 #include <ogl/utils/snapshot.hpp>
+#include <ogl/utils/cache.hpp>
 
 // Core
 #include <ogl/core/glCamera.hpp>
+#include <ogl/core/glFrustum.hpp>
+#include <ogl/core/glOcclusionBuffer.hpp>
+#include <ogl/core/glFrame.hpp>
+#include <ogl/core/glStateCache.hpp>
+#include <ogl/core/glStreamBuffer.hpp>
 #include <ogl/core/glWindow.hpp>
+#include <ogl/core/glVertexArray.hpp>
+#include <ogl/core/glIndices.hpp>
+#include <ogl/shader/shaders.hpp>
 #include <ogl/core/glShader.hpp>
 #include <ogl/core/glTexture.hpp>
+#include <ogl/core/glGeometry.hpp>
 #include <ogl/core/glObject.hpp>
-#include <ogl/core/glColors.hpp>
 #include <ogl/core/glFont.hpp>
+#include <ogl/core/glTextBatch.hpp>
+#include <ogl/core/glRenderQueue.hpp>
+#include <ogl/core/glColors.hpp>
 #ifndef OGL_WITHOUT_IMGUI
   #include <ogl/core/glDraw.hpp>
 #endif
@@ -73,6 +85,9 @@
 // Model
 #include <ogl/model/glLight.hpp>
 #include <ogl/model/glMaterial.hpp>
+#include <ogl/model/glBVH.hpp>
+#include <ogl/model/glSimplify.hpp>
+#include <ogl/model/glOptimize.hpp>
 #include <ogl/model/glMesh.hpp>
 #include <ogl/model/glModel.hpp>
 
@@ -84,9 +99,12 @@
 #include <ogl/objects/glLines.hpp>
 #include <ogl/objects/glEllipse.hpp>
 #include <ogl/objects/glSphere.hpp>
+#include <ogl/objects/glInstances.hpp>
+#include <ogl/objects/glSphereInstances.hpp>
 #include <ogl/objects/glGrid.hpp>
 #include <ogl/objects/glBox.hpp>
 #include <ogl/objects/glCuboid.hpp>
+#include <ogl/objects/glCuboidInstances.hpp>
 #include <ogl/objects/glQuad.hpp>
 #include <ogl/objects/glQuad2D.hpp>
 #include <ogl/objects/glAxes.hpp>
@@ -0,0 +1,10 @@
+#version 330 core
+
+// the color writes are masked: only depth test and samples count
+out vec4 outColor;
+
+void main() {
+
+  outColor = vec4(1.0);
+
+}
@@ -0,0 +1,43 @@
+#version 330 core
+
+//
+// Position only pass: proxies of the occlusion queries and depth pre-pass
+// (glModel, glRenderQueue). gl_Position is invariant, computed exactly as in
+// model.vs and solid.vs, so the color pass finds the same depth.
+//
+
+#ifdef OGL_PACKED_VERTEX
+
+// glPackedVertex position (int16, not normalized) in the box center +- extent
+layout (location = 0) in vec4 packedPosition;
+
+uniform vec3 boundsCenter;
+uniform vec3 boundsExtent;
+
+#else
+
+layout (location = 0) in vec3 position;
+
+#endif
+
+// Per-frame camera data (glFrame, binding 0)
+layout (std140) uniform Frame {
+  mat4 projection;
+  mat4 view;
+  mat4 orthoProjection;
+  vec2 viewport;
+};
+
+uniform mat4 model;
+
+invariant gl_Position;
+
+void main() {
+
+#ifdef OGL_PACKED_VERTEX
+  vec3 position = boundsCenter + boundsExtent * (packedPosition.xyz / 32767.0);
+#endif
+
+  gl_Position = projection * view * model * vec4(position, 1.0f);
+
+}
@@ -3,8 +3,15 @@
 layout (lines) in;
 layout (triangle_strip, max_vertices = 4) out;
 
+// Per-frame camera data (glFrame, binding 0)
+layout (std140) uniform Frame {
+  mat4 projection;
+  mat4 view;
+  mat4 orthoProjection;
+  vec2 viewport;
+};
+
 uniform float lineWidth;
-uniform vec2 viewport;
 
 in vec4 vertColor[];
 out vec4 fragColor;
@@ -7,33 +7,29 @@
 //
 
 /*****************************************************************************/
-// Material
+// Material (std140 glMaterial::Record_t)
 /*****************************************************************************/
 struct Material {
 
-    sampler2D diffuseTexture;
-    sampler2D specularTexture;
-    sampler2D ambientTexture;
-    sampler2D emissiveTexture;
-    sampler2D normalsTexture;
-    sampler2D opacityTexture;
-
-    bool haveDiffuseTexture;
-    bool haveSpecularTexture;
-    bool haveAmbientTexture;
-    bool haveEmissiveTexture;
-    bool haveNormalsTexture;
-    bool haveOpacityTexture;
-
-    vec3 emissiveColor;
-    vec3 ambientColor;
-    vec3 diffuseColor;
-    vec3 specularColor;
+    vec4 emissiveColor;
+    vec4 ambientColor;
+    vec4 diffuseColor;
+    vec4 specularColor;
 
     float shininess;
     float opacity;
+
+    int textures;    // bit mask of the available texture maps
 };
 
+// Bits of Material.textures (glMaterial::TEXTURE)
+const int DIFFUSE_TEXTURE  = 1;
+const int SPECULAR_TEXTURE = 2;
+const int AMBIENT_TEXTURE  = 4;
+const int EMISSIVE_TEXTURE = 8;
+const int NORMALS_TEXTURE  = 16;
+const int OPACITY_TEXTURE  = 32;
+
 /*****************************************************************************/
 // Light
 /*****************************************************************************/
@@ -48,8 +44,23 @@ struct Light {
 /*****************************************************************************/
 // Uniforms
 /*****************************************************************************/
-uniform Material material;
-uniform Light    light;
+// Material of the mesh being drawn (glModel, binding 2)
+layout (std140) uniform MaterialBlock {
+  Material material;
+};
+
+// Texture maps, on the fixed units 0..5 (glMaterial::setSamplers)
+uniform sampler2D diffuseTexture;
+uniform sampler2D specularTexture;
+uniform sampler2D ambientTexture;
+uniform sampler2D emissiveTexture;
+uniform sampler2D normalsTexture;
+uniform sampler2D opacityTexture;
+
+// Light in view space (glFrame, binding 1)
+layout (std140) uniform Lighting {
+  Light light;
+};
 
 /*****************************************************************************/
 // Inputs (from the vertex shader, all in view space)
@@ -77,8 +88,8 @@ void main() {
     vec3 norm = normalize(fragNormal);
 
     // Normal map: sample in tangent space, then transform to view space via TBN.
-    if(material.haveNormalsTexture) {
-      vec3 tsNorm = texture(material.normalsTexture, fragTexCoord).rgb;
+    if((material.textures & NORMALS_TEXTURE) != 0) {
+      vec3 tsNorm = texture(normalsTexture, fragTexCoord).rgb;
       tsNorm = normalize(tsNorm * 2.0 - 1.0);
       norm   = normalize(TBN * tsNorm);
     }
@@ -99,10 +110,10 @@ void main() {
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
 
     // Material colors (a texture, when present, replaces the flat color).
-    vec3 ambientColor  = material.haveAmbientTexture  ? texture(material.ambientTexture,  fragTexCoord).rgb : material.ambientColor;
-    vec3 diffuseColor  = material.haveDiffuseTexture  ? texture(material.diffuseTexture,  fragTexCoord).rgb : material.diffuseColor;
-    vec3 specularColor = material.haveSpecularTexture ? texture(material.specularTexture, fragTexCoord).rgb : material.specularColor;
-    vec3 emissiveColor = material.haveEmissiveTexture ? texture(material.emissiveTexture, fragTexCoord).rgb : material.emissiveColor;
+    vec3 ambientColor  = ((material.textures & AMBIENT_TEXTURE)  != 0) ? texture(ambientTexture,  fragTexCoord).rgb : material.ambientColor.rgb;
+    vec3 diffuseColor  = ((material.textures & DIFFUSE_TEXTURE)  != 0) ? texture(diffuseTexture,  fragTexCoord).rgb : material.diffuseColor.rgb;
+    vec3 specularColor = ((material.textures & SPECULAR_TEXTURE) != 0) ? texture(specularTexture, fragTexCoord).rgb : material.specularColor.rgb;
+    vec3 emissiveColor = ((material.textures & EMISSIVE_TEXTURE) != 0) ? texture(emissiveTexture, fragTexCoord).rgb : material.emissiveColor.rgb;
 
     // Lighting.
     vec3 ambient  = light.ambient  * ambientColor;
@@ -112,7 +123,7 @@ void main() {
     vec3 lighting = emissiveColor + ambient + diffuse + specular;
 
     // Opacity (from the opacity map when available).
-    float opacity = material.haveOpacityTexture ? texture(material.opacityTexture, fragTexCoord).r : material.opacity;
+    float opacity = ((material.textures & OPACITY_TEXTURE) != 0) ? texture(opacityTexture, fragTexCoord).r : material.opacity;
 
     // Gamma correction.
     vec3 gammaCorrected = pow(lighting, vec3(1.0 / gamma));
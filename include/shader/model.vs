@@ -1,15 +1,39 @@
 #version 330 core
 
+#ifdef OGL_PACKED_VERTEX
+
+// glPackedVertex: integer attributes, converted to float but not normalized.
+layout (location = 0) in vec4 packedPosition; // xyz: position in the mesh box (int16), w: bitangent sign
+layout (location = 1) in vec4 packedFrame;    // xy: octahedral normal, zw: octahedral tangent (int8)
+layout (location = 2) in vec2 texCoords;      // half floats
+
+// Box the positions are quantized in (center and half size).
+uniform vec3 boundsCenter;
+uniform vec3 boundsExtent;
+
+#else
+
 layout (location = 0) in vec3 position;
 layout (location = 1) in vec3 normal;
 layout (location = 2) in vec2 texCoords;
 layout (location = 3) in vec3 tangent;
 layout (location = 4) in vec3 bitangent;
 
-// Transform matrices.
+#endif
+
+// Per-frame camera data (glFrame, binding 0)
+layout (std140) uniform Frame {
+  mat4 projection;
+  mat4 view;
+  mat4 orthoProjection;
+  vec2 viewport;
+};
+
+// Model matrix.
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+// the depth pre-pass (depth.vs) must find the same depth
+invariant gl_Position;
 
 // Outputs to the fragment shader (all in view space).
 out vec3 fragPos;
@@ -17,8 +41,29 @@ out vec3 fragNormal;
 out vec2 fragTexCoord;
 out mat3 TBN;       // tangent-space → view-space matrix for normal mapping
 
+#ifdef OGL_PACKED_VERTEX
+
+// Unit vector from its octahedral encoding.
+vec3 octDecode(vec2 e) {
+
+    vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+
+    if(v.z < 0.0) v.xy = (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+
+    return normalize(v);
+}
+
+#endif
+
 void main() {
 
+#ifdef OGL_PACKED_VERTEX
+    vec3 position  = boundsCenter + boundsExtent * (packedPosition.xyz / 32767.0);
+    vec3 normal    = octDecode(clamp(packedFrame.xy / 127.0, -1.0, 1.0));
+    vec3 tangent   = octDecode(clamp(packedFrame.zw / 127.0, -1.0, 1.0));
+    vec3 bitangent = cross(normal, tangent) * (packedPosition.w < 0.0 ? -1.0 : 1.0);
+#endif
+
     gl_Position = projection * view * model * vec4(position, 1.0f);
 
     fragPos = vec3(view * model * vec4(position, 1.0f));
@@ -2,8 +2,13 @@
 
 layout (location = 0) in vec2 position;
 
-// width and Height of the viewport
-uniform vec2 viewport;
+// Per-frame camera data (glFrame, binding 0)
+layout (std140) uniform Frame {
+  mat4 projection;
+  mat4 view;
+  mat4 orthoProjection;
+  vec2 viewport;
+};
 
 
 void main() {
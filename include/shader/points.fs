@@ -15,8 +15,19 @@ struct Light {
     vec3 specular;
 };
 
-uniform Light light;
-uniform mat4  projection;   // to turn the spherical surface point into a depth value
+// Light in view space (glFrame, binding 1)
+layout (std140) uniform Lighting {
+  Light light;
+};
+
+// Per-frame camera data (glFrame, binding 0), the projection turns the
+// spherical surface point into a depth value
+layout (std140) uniform Frame {
+  mat4 projection;
+  mat4 view;
+  mat4 orthoProjection;
+  vec2 viewport;
+};
 
 // Shading mode for the impostors:
 //   0 = FLAT    : uniform matte colour, no lighting, view independent
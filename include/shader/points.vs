@@ -3,11 +3,16 @@
 layout (location = 0) in vec3 position;
 layout (location = 1) in vec4 color;
 
+// Per-frame camera data (glFrame, binding 0)
+layout (std140) uniform Frame {
+  mat4 projection;
+  mat4 view;
+  mat4 orthoProjection;
+  vec2 viewport;
+};
+
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 uniform float pointSize;
-uniform vec2  viewport;   // framebuffer size in pixels, to size the impostor in view space
 
 out vec4  fragColor;
 out vec3  fragPosView;    // point centre in view space, for lighting in the fragment
@@ -0,0 +1,923 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _H_OGL_SHADERS_H_
+#define _H_OGL_SHADERS_H_
+
+
+#ifndef _H_OGL_H_
+  #error "Do not include this header directly; include <ogl/ogl.hpp> instead."
+#endif
+
+#include <cstring>
+
+//****************************************************************************/
+// ogl::shaders
+//****************************************************************************/
+// Built-in GLSL sources compiled into the library, so the glShader presets
+// need neither filesystem I/O nor an installed copy of include/shader/.
+// The table is generated from the .vs/.gs/.fs files next to this header:
+// after editing one of them run "make shaders" to refresh it.
+//****************************************************************************/
+namespace ogl::shaders {
+
+  struct Source_t {
+    const char * name;
+    const char * code;
+  };
+
+  inline constexpr Source_t sources[] = {
+    // BEGIN EMBEDDED SHADERS
+    { "depth.fs", R"OGL_GLSL(#version 330 core
+
+// the color writes are masked: only depth test and samples count
+out vec4 outColor;
+
+void main() {
+
+  outColor = vec4(1.0);
+
+}
+)OGL_GLSL" },
+    { "depth.vs", R"OGL_GLSL(#version 330 core
+
+//
+// Position only pass: proxies of the occlusion queries and depth pre-pass
+// (glModel, glRenderQueue). gl_Position is invariant, computed exactly as in
+// model.vs and solid.vs, so the color pass finds the same depth.
+//
+
+#ifdef OGL_PACKED_VERTEX
+
+// glPackedVertex position (int16, not normalized) in the box center +- extent
+layout (location = 0) in vec4 packedPosition;
+
+uniform vec3 boundsCenter;
+uniform vec3 boundsExtent;
+
+#else
+
+layout (location = 0) in vec3 position;
+
+#endif
+
+// Per-frame camera data (glFrame, binding 0)
+layout (std140) uniform Frame {
+  mat4 projection;
+  mat4 view;
+  mat4 orthoProjection;
+  vec2 viewport;
+};
+
+uniform mat4 model;
+
+invariant gl_Position;
+
+void main() {
+
+#ifdef OGL_PACKED_VERTEX
+  vec3 position = boundsCenter + boundsExtent * (packedPosition.xyz / 32767.0);
+#endif
+
+  gl_Position = projection * view * model * vec4(position, 1.0f);
+
+}
+)OGL_GLSL" },
+    { "line.fs", R"OGL_GLSL(#version 330 core
+
+in vec4 fragColor;
+out vec4 outColor;
+
+void main() {
+  if(fragColor.w < 0.999) discard;
+  outColor = fragColor;
+}
+)OGL_GLSL" },
+    { "line.gs", R"OGL_GLSL(#version 330 core
+
+layout (lines) in;
+layout (triangle_strip, max_vertices = 4) out;
+
+// Per-frame camera data (glFrame, binding 0)
+layout (std140) uniform Frame {
+  mat4 projection;
+  mat4 view;
+  mat4 orthoProjection;
+  vec2 viewport;
+};
+
+uniform float lineWidth;
+
+in vec4 vertColor[];
+out vec4 fragColor;
+
+void emitLineQuad(vec4 a, vec4 b, vec4 colorA, vec4 colorB) {
+  vec2 ndcA = a.xy / a.w;
+  vec2 ndcB = b.xy / b.w;
+  vec2 dir = ndcB - ndcA;
+  float len = length(dir);
+  if(len < 1e-6) {
+    dir = vec2(0.0, 1.0);
+  } else {
+    dir /= len;
+  }
+  vec2 normal = vec2(-dir.y, dir.x);
+  vec2 offset = normal * (lineWidth / viewport);
+
+  vec4 aPos = vec4((ndcA + offset) * a.w, a.z, a.w);
+  vec4 aNeg = vec4((ndcA - offset) * a.w, a.z, a.w);
+  vec4 bPos = vec4((ndcB + offset) * b.w, b.z, b.w);
+  vec4 bNeg = vec4((ndcB - offset) * b.w, b.z, b.w);
+
+  fragColor = colorA;
+  gl_Position = aPos;
+  EmitVertex();
+
+  fragColor = colorB;
+  gl_Position = bPos;
+  EmitVertex();
+
+  fragColor = colorA;
+  gl_Position = aNeg;
+  EmitVertex();
+
+  fragColor = colorB;
+  gl_Position = bNeg;
+  EmitVertex();
+
+  EndPrimitive();
+}
+
+void main() {
+  emitLineQuad(gl_in[0].gl_Position, gl_in[1].gl_Position, vertColor[0], vertColor[1]);
+}
+)OGL_GLSL" },
+    { "line.vs", R"OGL_GLSL(#version 330 core
+
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec4 color;
+
+// Per-frame camera data (glFrame, binding 0)
+layout (std140) uniform Frame {
+  mat4 projection;
+  mat4 view;
+  mat4 orthoProjection;
+  vec2 viewport;
+};
+
+uniform mat4 model;
+uniform vec4 uniformColor;
+
+out vec4 vertColor;
+
+void main() {
+  gl_Position = projection * view * model * vec4(position, 1.0f);
+  vertColor = color * uniformColor;
+}
+)OGL_GLSL" },
+    { "model.fs", R"OGL_GLSL(#version 330 core
+
+//
+// Phong shading for imported 3D models (glModel / glMesh).
+// Everything is computed in view space, where the camera sits at the origin.
+// Each texture map, when present, overrides the matching material color.
+//
+
+/*****************************************************************************/
+// Material (std140 glMaterial::Record_t)
+/*****************************************************************************/
+struct Material {
+
+    vec4 emissiveColor;
+    vec4 ambientColor;
+    vec4 diffuseColor;
+    vec4 specularColor;
+
+    float shininess;
+    float opacity;
+
+    int textures;    // bit mask of the available texture maps
+};
+
+// Bits of Material.textures (glMaterial::TEXTURE)
+const int DIFFUSE_TEXTURE  = 1;
+const int SPECULAR_TEXTURE = 2;
+const int AMBIENT_TEXTURE  = 4;
+const int EMISSIVE_TEXTURE = 8;
+const int NORMALS_TEXTURE  = 16;
+const int OPACITY_TEXTURE  = 32;
+
+/*****************************************************************************/
+// Light
+/*****************************************************************************/
+struct Light {
+    vec3 direction;  // directional light (view space); zero means "not used"
+    vec3 position;   // point light position (view space)
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+/*****************************************************************************/
+// Uniforms
+/*****************************************************************************/
+// Material of the mesh being drawn (glModel, binding 2)
+layout (std140) uniform MaterialBlock {
+  Material material;
+};
+
+// Texture maps, on the fixed units 0..5 (glMaterial::setSamplers)
+uniform sampler2D diffuseTexture;
+uniform sampler2D specularTexture;
+uniform sampler2D ambientTexture;
+uniform sampler2D emissiveTexture;
+uniform sampler2D normalsTexture;
+uniform sampler2D opacityTexture;
+
+// Light in view space (glFrame, binding 1)
+layout (std140) uniform Lighting {
+  Light light;
+};
+
+/*****************************************************************************/
+// Inputs (from the vertex shader, all in view space)
+/*****************************************************************************/
+in vec2 fragTexCoord;
+in vec3 fragNormal;
+in vec3 fragPos;
+in mat3 TBN;        // tangent-space → view-space, built in model.vs
+
+/*****************************************************************************/
+// Output
+/*****************************************************************************/
+out vec4 outColor;
+
+/*****************************************************************************/
+// Constants
+/*****************************************************************************/
+const float gamma = 2.2;
+
+/*****************************************************************************/
+// Main
+/*****************************************************************************/
+void main() {
+
+    vec3 norm = normalize(fragNormal);
+
+    // Normal map: sample in tangent space, then transform to view space via TBN.
+    if((material.textures & NORMALS_TEXTURE) != 0) {
+      vec3 tsNorm = texture(normalsTexture, fragTexCoord).rgb;
+      tsNorm = normalize(tsNorm * 2.0 - 1.0);
+      norm   = normalize(TBN * tsNorm);
+    }
+
+    // In view space the eye is at the origin, so -fragPos points to the camera.
+    vec3 viewDir = normalize(-fragPos);
+
+    // Choose the light direction: explicit direction, else point light,
+    // else a head light coming straight from the camera.
+    vec3 lightDir;
+    if(length(light.direction) > 0.001)      lightDir = normalize(-light.direction);
+    else if(length(light.position) > 0.001)  lightDir = normalize(light.position - fragPos);
+    else                                     lightDir = viewDir;
+
+    // Phong terms.
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3  reflectDir = reflect(-lightDir, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+
+    // Material colors (a texture, when present, replaces the flat color).
+    vec3 ambientColor  = ((material.textures & AMBIENT_TEXTURE)  != 0) ? texture(ambientTexture,  fragTexCoord).rgb : material.ambientColor.rgb;
+    vec3 diffuseColor  = ((material.textures & DIFFUSE_TEXTURE)  != 0) ? texture(diffuseTexture,  fragTexCoord).rgb : material.diffuseColor.rgb;
+    vec3 specularColor = ((material.textures & SPECULAR_TEXTURE) != 0) ? texture(specularTexture, fragTexCoord).rgb : material.specularColor.rgb;
+    vec3 emissiveColor = ((material.textures & EMISSIVE_TEXTURE) != 0) ? texture(emissiveTexture, fragTexCoord).rgb : material.emissiveColor.rgb;
+
+    // Lighting.
+    vec3 ambient  = light.ambient  * ambientColor;
+    vec3 diffuse  = light.diffuse  * diff * diffuseColor;
+    vec3 specular = light.specular * spec * specularColor;
+
+    vec3 lighting = emissiveColor + ambient + diffuse + specular;
+
+    // Opacity (from the opacity map when available).
+    float opacity = ((material.textures & OPACITY_TEXTURE) != 0) ? texture(opacityTexture, fragTexCoord).r : material.opacity;
+
+    // Gamma correction.
+    vec3 gammaCorrected = pow(lighting, vec3(1.0 / gamma));
+
+    outColor = vec4(gammaCorrected, opacity);
+
+}
+)OGL_GLSL" },
+    { "model.vs", R"OGL_GLSL(#version 330 core
+
+#ifdef OGL_PACKED_VERTEX
+
+// glPackedVertex: integer attributes, converted to float but not normalized.
+layout (location = 0) in vec4 packedPosition; // xyz: position in the mesh box (int16), w: bitangent sign
+layout (location = 1) in vec4 packedFrame;    // xy: octahedral normal, zw: octahedral tangent (int8)
+layout (location = 2) in vec2 texCoords;      // half floats
+
+// Box the positions are quantized in (center and half size).
+uniform vec3 boundsCenter;
+uniform vec3 boundsExtent;
+
+#else
+
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec3 normal;
+layout (location = 2) in vec2 texCoords;
+layout (location = 3) in vec3 tangent;
+layout (location = 4) in vec3 bitangent;
+
+#endif
+
+// Per-frame camera data (glFrame, binding 0)
+layout (std140) uniform Frame {
+  mat4 projection;
+  mat4 view;
+  mat4 orthoProjection;
+  vec2 viewport;
+};
+
+// Model matrix.
+uniform mat4 model;
+
+// the depth pre-pass (depth.vs) must find the same depth
+invariant gl_Position;
+
+// Outputs to the fragment shader (all in view space).
+out vec3 fragPos;
+out vec3 fragNormal;
+out vec2 fragTexCoord;
+out mat3 TBN;       // tangent-space → view-space matrix for normal mapping
+
+#ifdef OGL_PACKED_VERTEX
+
+// Unit vector from its octahedral encoding.
+vec3 octDecode(vec2 e) {
+
+    vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+
+    if(v.z < 0.0) v.xy = (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+
+    return normalize(v);
+}
+
+#endif
+
+void main() {
+
+#ifdef OGL_PACKED_VERTEX
+    vec3 position  = boundsCenter + boundsExtent * (packedPosition.xyz / 32767.0);
+    vec3 normal    = octDecode(clamp(packedFrame.xy / 127.0, -1.0, 1.0));
+    vec3 tangent   = octDecode(clamp(packedFrame.zw / 127.0, -1.0, 1.0));
+    vec3 bitangent = cross(normal, tangent) * (packedPosition.w < 0.0 ? -1.0 : 1.0);
+#endif
+
+    gl_Position = projection * view * model * vec4(position, 1.0f);
+
+    fragPos = vec3(view * model * vec4(position, 1.0f));
+
+    // Normal matrix handles non-uniform scaling; compute once, reuse for T/B/N.
+    mat3 normalMatrix = mat3(transpose(inverse(view * model)));
+
+    fragNormal = normalMatrix * normal;
+
+    vec3 T = normalize(normalMatrix * tangent);
+    vec3 B = normalize(normalMatrix * bitangent);
+    vec3 N = normalize(fragNormal);
+    TBN = mat3(T, B, N);
+
+    fragTexCoord = texCoords;
+}
+)OGL_GLSL" },
+    { "plain2D.fs", R"OGL_GLSL(#version 330 core
+
+uniform vec4 color;
+
+out vec4 outColor;
+
+void main() {
+
+  outColor = color;
+
+}
+)OGL_GLSL" },
+    { "plain2D.vs", R"OGL_GLSL(#version 330 core
+
+layout (location = 0) in vec2 position;
+
+// Per-frame camera data (glFrame, binding 0)
+layout (std140) uniform Frame {
+  mat4 projection;
+  mat4 view;
+  mat4 orthoProjection;
+  vec2 viewport;
+};
+
+
+void main() {
+  
+  // From pixels to 0-1
+  vec2 coord = position / viewport;
+  
+  // Flip Y so that 0 is top
+  coord.y = (1.0-coord.y);
+  
+  // Map to NDC -1,+1
+  coord.xy = coord.xy * 2.0 - 1.0;
+  
+  // coordinata proiettiva del punto
+  gl_Position = vec4(coord.xy, 0.0, 1.0);
+
+}
+)OGL_GLSL" },
+    { "points.fs", R"OGL_GLSL(#version 330 core
+
+//
+// Point-sprite sphere impostors: every GL_POINTS vertex is shaded as if it were
+// a little 3D sphere, reconstructing a view-space normal from gl_PointCoord.
+// Lighting uses the same model as solid.fs (scene light + head-light fallback),
+// so glPoints now reacts to setLight() instead of a hard-coded light.
+//
+
+struct Light {
+    vec3 direction;  // directional light (view space); zero means "not used"
+    vec3 position;   // point light position (view space)
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+// Light in view space (glFrame, binding 1)
+layout (std140) uniform Lighting {
+  Light light;
+};
+
+// Per-frame camera data (glFrame, binding 0), the projection turns the
+// spherical surface point into a depth value
+layout (std140) uniform Frame {
+  mat4 projection;
+  mat4 view;
+  mat4 orthoProjection;
+  vec2 viewport;
+};
+
+// Shading mode for the impostors:
+//   0 = FLAT    : uniform matte colour, no lighting, view independent
+//                 (the assigned colour is shown exactly, no gamma)
+//   1 = DIFFUSE : matte sphere (ambient + Lambert diffuse, no specular)
+//   2 = PHONG   : full Phong with specular highlight (shiny, the old default)
+uniform int shadingMode;
+
+in vec4  fragColor;
+in vec3  fragPosView;
+in float fragRadiusView;
+
+out vec4 outColor;
+
+const float shininess = 32.0;
+const float gamma     = 2.2;
+
+void main() {
+
+  // Hide-by-alpha: a vertex colour with alpha < 1 means "don't draw this point".
+  if(fragColor.w < 0.999) discard;
+
+  // Reconstruct the sphere impostor: drop fragments outside the unit disc.
+  vec2 cxy = 2.0 * gl_PointCoord - 1.0;
+  float r2 = dot(cxy, cxy);
+  if(r2 > 1.0) discard;
+
+  // Height of the sphere cap above the disc plane (1 at centre, 0 at the rim).
+  float zCap = sqrt(1.0 - r2);
+
+  // Write the real spherical surface depth instead of the flat point-centre
+  // depth, so overlapping points occlude each other like true 3D spheres and
+  // their order stays stable while the camera moves (no popping front/back).
+  vec3 surfView = vec3(fragPosView.xy, fragPosView.z + fragRadiusView * zCap);
+  vec4 surfClip = projection * vec4(surfView, 1.0);
+  gl_FragDepth = 0.5 + 0.5 * (surfClip.z / surfClip.w);
+
+  vec3 outRGB;
+
+  if(shadingMode == 0) {
+
+    // FLAT: uniform matte colour, view independent. No lighting and no gamma so
+    // the colour assigned to the point is reproduced exactly.
+    outRGB = fragColor.rgb;
+
+  } else {
+
+    // Turn the disc into a view-space normal (z points toward the camera).
+    vec3 norm = normalize(vec3(cxy.x, cxy.y, zCap));
+
+    // In view space the eye is at the origin, so -fragPos points to the camera.
+    vec3 viewDir = normalize(-fragPosView);
+
+    // Choose the light direction: explicit direction, else point light,
+    // else a head light coming straight from the camera.
+    vec3 lightDir;
+    if(length(light.direction) > 0.001)      lightDir = normalize(-light.direction);
+    else if(length(light.position) > 0.001)  lightDir = normalize(light.position - fragPosView);
+    else                                     lightDir = viewDir;
+
+    float diff = max(dot(norm, lightDir), 0.0);
+
+    vec3 ambient = light.ambient * fragColor.rgb;
+    vec3 diffuse = light.diffuse * diff * fragColor.rgb;
+
+    vec3 lighting = ambient + diffuse;
+
+    // PHONG: add the specular highlight on top of the matte base.
+    if(shadingMode == 2) {
+      vec3  reflectDir = reflect(-lightDir, norm);
+      float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess);
+      lighting += light.specular * spec;
+    }
+
+    // Gamma-correct the final color for display (consistent with solid/model).
+    outRGB = pow(lighting, vec3(1.0 / gamma));
+
+  }
+
+  // Antialias the disc edge.
+  float delta = fwidth(r2);
+  float alpha = 1.0 - smoothstep(1.0 - delta, 1.0 + delta, r2);
+
+  outColor = vec4(outRGB, 1.0) * alpha;
+
+}
+)OGL_GLSL" },
+    { "points.vs", R"OGL_GLSL(#version 330 core
+
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec4 color;
+
+// Per-frame camera data (glFrame, binding 0)
+layout (std140) uniform Frame {
+  mat4 projection;
+  mat4 view;
+  mat4 orthoProjection;
+  vec2 viewport;
+};
+
+uniform mat4 model;
+uniform float pointSize;
+
+out vec4  fragColor;
+out vec3  fragPosView;    // point centre in view space, for lighting in the fragment
+out float fragRadiusView; // sphere radius in view space, for the per-fragment depth
+
+void main() {
+
+  vec4 posView = view * model * vec4(position, 1.0f);
+
+  gl_Position = projection * posView;
+
+  // Scale the sprite by distance so points keep a consistent apparent size.
+  float Z = length(posView.xyz);
+  float pixelDiameter = pointSize / Z;
+  gl_PointSize = pixelDiameter;
+
+  // View-space radius of the sphere that projects to 'pixelDiameter' pixels, so
+  // the fragment shader can write the real spherical surface depth. Inverting the
+  // perspective vertical scale: pixels = projection[1][1] * (2R)/w * viewport.y/2.
+  float w = max(-posView.z, 1e-6);
+  fragRadiusView = pixelDiameter * w / (projection[1][1] * viewport.y);
+
+  fragColor   = color;
+  fragPosView = posView.xyz;
+
+}
+)OGL_GLSL" },
+    { "solid.fs", R"OGL_GLSL(#version 330 core
+
+//
+// Simple Phong shading for the solid base objects (sphere, ellipse, cuboid, ...).
+// Everything is computed in view space, where the camera sits at the origin.
+//
+
+struct Light {
+    vec3 direction;  // directional light (view space); zero means "not used"
+    vec3 position;   // point light position (view space)
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+// Light in view space (glFrame, binding 1)
+layout (std140) uniform Lighting {
+  Light light;
+};
+
+#ifdef OGL_INSTANCED
+flat in vec3 fragColor; // base color of the instance (glInstances)
+#else
+uniform vec3  color;   // base color of the object
+#endif
+
+in  vec3 fragPos;      // fragment position in view space
+in  vec3 fragNormal;   // fragment normal   in view space
+out vec4 outColor;
+
+const float shininess = 32.0;
+const float gamma     = 2.2;
+
+void main() {
+
+#ifdef OGL_INSTANCED
+    vec3 baseColor = fragColor;
+#else
+    vec3 baseColor = color;
+#endif
+
+    vec3 norm = normalize(fragNormal);
+
+    // In view space the eye is at the origin, so -fragPos points to the camera.
+    vec3 viewDir = normalize(-fragPos);
+
+    // Choose the light direction: explicit direction, else point light,
+    // else a head light coming straight from the camera.
+    vec3 lightDir;
+    if(length(light.direction) > 0.001)      lightDir = normalize(-light.direction);
+    else if(length(light.position) > 0.001)  lightDir = normalize(light.position - fragPos);
+    else                                     lightDir = viewDir;
+
+    // Phong terms.
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3  reflectDir = reflect(-lightDir, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess);
+
+    vec3 ambient  = light.ambient  * baseColor;
+    vec3 diffuse  = light.diffuse  * diff * baseColor;
+    vec3 specular = light.specular * spec;
+
+    // Gamma-correct the final color for display (consistent with model.fs).
+    vec3 lighting = ambient + diffuse + specular;
+    outColor = vec4(pow(lighting, vec3(1.0 / gamma)), 1.0);
+}
+)OGL_GLSL" },
+    { "solid.vs", R"OGL_GLSL(#version 330 core
+
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec3 normal;
+
+#ifdef OGL_INSTANCED
+// Per-instance attributes (glInstances)
+layout (location = 3) in vec3 instancePosition;
+layout (location = 4) in vec3 instanceScale;
+layout (location = 5) in vec4 instanceRotation;  // unit quaternion (x, y, z, w)
+layout (location = 6) in vec3 instanceColor;
+#endif
+
+// Per-frame camera data (glFrame, binding 0)
+layout (std140) uniform Frame {
+  mat4 projection;
+  mat4 view;
+  mat4 orthoProjection;
+  vec2 viewport;
+};
+
+uniform mat4 model;
+
+// the depth pre-pass (depth.vs) must find the same depth
+invariant gl_Position;
+
+out vec3 fragPos;
+out vec3 fragNormal;
+
+#ifdef OGL_INSTANCED
+uniform mat3 normalMatrix;  // transpose(inverse(mat3(view * model))), set once per draw
+
+flat out vec3 fragColor;
+
+vec3 rotate(vec4 q, vec3 v) { return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v); }
+#endif
+
+void main() {
+
+#ifdef OGL_INSTANCED
+  vec4 worldPos = model * vec4(instancePosition + rotate(instanceRotation, position * instanceScale), 1.0f);
+
+  gl_Position = projection * view * worldPos;
+  fragPos = vec3(view * worldPos);
+  // the inverse transpose of rotation * scale is rotation * (1 / scale)
+  fragNormal = normalMatrix * rotate(instanceRotation, normal / instanceScale);
+  fragColor = instanceColor;
+#else
+  gl_Position = projection * view * model * vec4(position, 1.0f);
+  fragPos = vec3(view * model * vec4(position, 1.0f));
+  fragNormal = mat3(transpose(inverse(view * model))) * normal;
+#endif
+
+}
+)OGL_GLSL" },
+    { "text.fs", R"OGL_GLSL(#version 330 core
+in vec2 TexCoords;
+out vec4 outColor;
+
+uniform sampler2D text;
+
+#ifdef OGL_TEXT_BATCH
+in vec4 TextColor;
+#else
+uniform vec3 color;
+#endif
+
+void main()
+{
+#ifdef OGL_SDF_TEXT
+    // glFont SDF atlas: the outline is at 0.5, smoothed over one screen pixel
+    float distance = texture(text, TexCoords).r;
+    float width = fwidth(distance);
+    vec4 sampled = vec4(1.0, 1.0, 1.0, smoothstep(0.5 - width, 0.5 + width, distance));
+#else
+    vec4 sampled = vec4(1.0, 1.0, 1.0, texture(text, TexCoords).r);
+#endif
+#ifdef OGL_TEXT_BATCH
+    outColor = TextColor * sampled;
+#else
+    outColor = vec4(color, 1.0) * sampled;
+#endif
+}
+)OGL_GLSL" },
+    { "text.vs", R"OGL_GLSL(#version 330 core
+layout (location = 0) in vec4 vertex; // <vec2 pos, vec2 tex>
+out vec2 TexCoords;
+
+#ifdef OGL_TEXT_BATCH
+// glTextBatch: the color of each glyph travels with its vertices
+layout (location = 1) in vec4 vertexColor;
+out vec4 TextColor;
+#endif
+
+// Per-frame camera data (glFrame, binding 0)
+layout (std140) uniform Frame {
+  mat4 projection;
+  mat4 view;
+  mat4 orthoProjection;
+  vec2 viewport;
+};
+
+void main(){
+  
+  gl_Position = orthoProjection * vec4(vertex.xy, 0.0, 1.0);
+    
+  TexCoords = vertex.zw;
+
+#ifdef OGL_TEXT_BATCH
+  TextColor = vertexColor;
+#endif
+  
+}
+)OGL_GLSL" },
+    { "wireframe.fs", R"OGL_GLSL(#version 330 core
+
+in vec3 fragColor;
+out vec4 outColor;
+
+void main() {
+  outColor = vec4(fragColor, 1.0);
+}
+)OGL_GLSL" },
+    { "wireframe.gs", R"OGL_GLSL(#version 330 core
+
+layout (triangles) in;
+layout (triangle_strip, max_vertices = 12) out;
+
+// Per-frame camera data (glFrame, binding 0)
+layout (std140) uniform Frame {
+  mat4 projection;
+  mat4 view;
+  mat4 orthoProjection;
+  vec2 viewport;
+};
+
+uniform float lineWidth;
+
+#ifdef OGL_INSTANCED
+in vec3 vertexColor[];  // color of the instance (glInstances)
+vec3 color;
+#else
+uniform vec3 color;
+#endif
+
+out vec3 fragColor;
+
+void emitEdge(vec4 a, vec4 b) {
+  vec2 ndcA = a.xy / a.w;
+  vec2 ndcB = b.xy / b.w;
+  vec2 dir = ndcB - ndcA;
+  float len = length(dir);
+  if(len < 1e-6) {
+    dir = vec2(0.0, 1.0);
+  } else {
+    dir /= len;
+  }
+  vec2 normal = vec2(-dir.y, dir.x);
+  vec2 offset = normal * (lineWidth / viewport);
+
+  vec4 aPos = vec4((ndcA + offset) * a.w, a.z, a.w);
+  vec4 aNeg = vec4((ndcA - offset) * a.w, a.z, a.w);
+  vec4 bPos = vec4((ndcB + offset) * b.w, b.z, b.w);
+  vec4 bNeg = vec4((ndcB - offset) * b.w, b.z, b.w);
+
+  fragColor = color;
+  gl_Position = aPos;
+  EmitVertex();
+
+  fragColor = color;
+  gl_Position = bPos;
+  EmitVertex();
+
+  fragColor = color;
+  gl_Position = aNeg;
+  EmitVertex();
+
+  fragColor = color;
+  gl_Position = bNeg;
+  EmitVertex();
+
+  EndPrimitive();
+}
+
+void main() {
+#ifdef OGL_INSTANCED
+  color = vertexColor[0];
+#endif
+  emitEdge(gl_in[0].gl_Position, gl_in[1].gl_Position);
+  emitEdge(gl_in[1].gl_Position, gl_in[2].gl_Position);
+  emitEdge(gl_in[2].gl_Position, gl_in[0].gl_Position);
+}
+)OGL_GLSL" },
+    { "wireframe.vs", R"OGL_GLSL(#version 330 core
+
+layout (location = 0) in vec3 position;
+
+#ifdef OGL_INSTANCED
+// Per-instance attributes (glInstances)
+layout (location = 3) in vec3 instancePosition;
+layout (location = 4) in vec3 instanceScale;
+layout (location = 5) in vec4 instanceRotation;  // unit quaternion (x, y, z, w)
+layout (location = 6) in vec3 instanceColor;
+
+out vec3 vertexColor;
+
+vec3 rotate(vec4 q, vec3 v) { return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v); }
+#endif
+
+// Per-frame camera data (glFrame, binding 0)
+layout (std140) uniform Frame {
+  mat4 projection;
+  mat4 view;
+  mat4 orthoProjection;
+  vec2 viewport;
+};
+
+uniform mat4 model;
+
+void main() {
+#ifdef OGL_INSTANCED
+  gl_Position = projection * view * model * vec4(instancePosition + rotate(instanceRotation, position * instanceScale), 1.0f);
+  vertexColor = instanceColor;
+#else
+  gl_Position = projection * view * model * vec4(position, 1.0f);
+#endif
+}
+)OGL_GLSL" },
+    // END EMBEDDED SHADERS
+  };
+
+  //****************************************************************************/
+  // find() - source of a built-in shader file (e.g. "solid.vs"), NULL if none
+  //****************************************************************************/
+  inline const char * find(const char * name) {
+
+    for(const Source_t & source : sources)
+      if(strcmp(source.name, name) == 0) return source.code;
+
+    return NULL;
+
+  }
+
+} /* namespace ogl::shaders */
+
+#endif /* _H_OGL_SHADERS_H_ */
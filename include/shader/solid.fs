@@ -13,8 +13,16 @@ struct Light {
     vec3 specular;
 };
 
+// Light in view space (glFrame, binding 1)
+layout (std140) uniform Lighting {
+  Light light;
+};
+
+#ifdef OGL_INSTANCED
+flat in vec3 fragColor; // base color of the instance (glInstances)
+#else
 uniform vec3  color;   // base color of the object
-uniform Light light;
+#endif
 
 in  vec3 fragPos;      // fragment position in view space
 in  vec3 fragNormal;   // fragment normal   in view space
@@ -25,6 +33,12 @@ const float gamma     = 2.2;
 
 void main() {
 
+#ifdef OGL_INSTANCED
+    vec3 baseColor = fragColor;
+#else
+    vec3 baseColor = color;
+#endif
+
     vec3 norm = normalize(fragNormal);
 
     // In view space the eye is at the origin, so -fragPos points to the camera.
@@ -42,8 +56,8 @@ void main() {
     vec3  reflectDir = reflect(-lightDir, norm);
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess);
 
-    vec3 ambient  = light.ambient  * color;
-    vec3 diffuse  = light.diffuse  * diff * color;
+    vec3 ambient  = light.ambient  * baseColor;
+    vec3 diffuse  = light.diffuse  * diff * baseColor;
     vec3 specular = light.specular * spec;
 
     // Gamma-correct the final color for display (consistent with model.fs).
@@ -3,17 +3,52 @@
 layout (location = 0) in vec3 position;
 layout (location = 1) in vec3 normal;
 
+#ifdef OGL_INSTANCED
+// Per-instance attributes (glInstances)
+layout (location = 3) in vec3 instancePosition;
+layout (location = 4) in vec3 instanceScale;
+layout (location = 5) in vec4 instanceRotation;  // unit quaternion (x, y, z, w)
+layout (location = 6) in vec3 instanceColor;
+#endif
+
+// Per-frame camera data (glFrame, binding 0)
+layout (std140) uniform Frame {
+  mat4 projection;
+  mat4 view;
+  mat4 orthoProjection;
+  vec2 viewport;
+};
+
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+// the depth pre-pass (depth.vs) must find the same depth
+invariant gl_Position;
 
 out vec3 fragPos;
 out vec3 fragNormal;
 
+#ifdef OGL_INSTANCED
+uniform mat3 normalMatrix;  // transpose(inverse(mat3(view * model))), set once per draw
+
+flat out vec3 fragColor;
+
+vec3 rotate(vec4 q, vec3 v) { return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v); }
+#endif
+
 void main() {
-  
+
+#ifdef OGL_INSTANCED
+  vec4 worldPos = model * vec4(instancePosition + rotate(instanceRotation, position * instanceScale), 1.0f);
+
+  gl_Position = projection * view * worldPos;
+  fragPos = vec3(view * worldPos);
+  // the inverse transpose of rotation * scale is rotation * (1 / scale)
+  fragNormal = normalMatrix * rotate(instanceRotation, normal / instanceScale);
+  fragColor = instanceColor;
+#else
   gl_Position = projection * view * model * vec4(position, 1.0f);
   fragPos = vec3(view * model * vec4(position, 1.0f));
   fragNormal = mat3(transpose(inverse(view * model))) * normal;
+#endif
 
 }
@@ -3,10 +3,26 @@ in vec2 TexCoords;
 out vec4 outColor;
 
 uniform sampler2D text;
+
+#ifdef OGL_TEXT_BATCH
+in vec4 TextColor;
+#else
 uniform vec3 color;
+#endif
 
 void main()
 {
+#ifdef OGL_SDF_TEXT
+    // glFont SDF atlas: the outline is at 0.5, smoothed over one screen pixel
+    float distance = texture(text, TexCoords).r;
+    float width = fwidth(distance);
+    vec4 sampled = vec4(1.0, 1.0, 1.0, smoothstep(0.5 - width, 0.5 + width, distance));
+#else
     vec4 sampled = vec4(1.0, 1.0, 1.0, texture(text, TexCoords).r);
+#endif
+#ifdef OGL_TEXT_BATCH
+    outColor = TextColor * sampled;
+#else
     outColor = vec4(color, 1.0) * sampled;
+#endif
 }
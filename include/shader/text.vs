@@ -2,12 +2,28 @@
 layout (location = 0) in vec4 vertex; // <vec2 pos, vec2 tex>
 out vec2 TexCoords;
 
-uniform mat4 projection;
+#ifdef OGL_TEXT_BATCH
+// glTextBatch: the color of each glyph travels with its vertices
+layout (location = 1) in vec4 vertexColor;
+out vec4 TextColor;
+#endif
+
+// Per-frame camera data (glFrame, binding 0)
+layout (std140) uniform Frame {
+  mat4 projection;
+  mat4 view;
+  mat4 orthoProjection;
+  vec2 viewport;
+};
 
 void main(){
   
-  gl_Position = projection * vec4(vertex.xy, 0.0, 1.0);
+  gl_Position = orthoProjection * vec4(vertex.xy, 0.0, 1.0);
     
   TexCoords = vertex.zw;
+
+#ifdef OGL_TEXT_BATCH
+  TextColor = vertexColor;
+#endif
   
 }
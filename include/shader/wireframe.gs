@@ -3,9 +3,22 @@
 layout (triangles) in;
 layout (triangle_strip, max_vertices = 12) out;
 
+// Per-frame camera data (glFrame, binding 0)
+layout (std140) uniform Frame {
+  mat4 projection;
+  mat4 view;
+  mat4 orthoProjection;
+  vec2 viewport;
+};
+
 uniform float lineWidth;
-uniform vec2 viewport;
+
+#ifdef OGL_INSTANCED
+in vec3 vertexColor[];  // color of the instance (glInstances)
+vec3 color;
+#else
 uniform vec3 color;
+#endif
 
 out vec3 fragColor;
 
@@ -47,6 +60,9 @@ void emitEdge(vec4 a, vec4 b) {
 }
 
 void main() {
+#ifdef OGL_INSTANCED
+  color = vertexColor[0];
+#endif
   emitEdge(gl_in[0].gl_Position, gl_in[1].gl_Position);
   emitEdge(gl_in[1].gl_Position, gl_in[2].gl_Position);
   emitEdge(gl_in[2].gl_Position, gl_in[0].gl_Position);
@@ -2,10 +2,33 @@
 
 layout (location = 0) in vec3 position;
 
+#ifdef OGL_INSTANCED
+// Per-instance attributes (glInstances)
+layout (location = 3) in vec3 instancePosition;
+layout (location = 4) in vec3 instanceScale;
+layout (location = 5) in vec4 instanceRotation;  // unit quaternion (x, y, z, w)
+layout (location = 6) in vec3 instanceColor;
+
+out vec3 vertexColor;
+
+vec3 rotate(vec4 q, vec3 v) { return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v); }
+#endif
+
+// Per-frame camera data (glFrame, binding 0)
+layout (std140) uniform Frame {
+  mat4 projection;
+  mat4 view;
+  mat4 orthoProjection;
+  vec2 viewport;
+};
+
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 
 void main() {
+#ifdef OGL_INSTANCED
+  gl_Position = projection * view * model * vec4(instancePosition + rotate(instanceRotation, position * instanceScale), 1.0f);
+  vertexColor = instanceColor;
+#else
   gl_Position = projection * view * model * vec4(position, 1.0f);
+#endif
 }
@@ -0,0 +1,189 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _H_OGL_CACHE_H_
+#define _H_OGL_CACHE_H_
+
+
+#ifndef _H_OGL_H_
+  #error "Do not include this header directly; include <ogl/ogl.hpp> instead."
+#endif
+
+#include <cstdlib>
+#include <cstdio>
+#include <cstdint>
+#include <cerrno>
+#include <cstring>
+
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+#include <sys/stat.h>
+
+//*****************************************************************************
+// ogl::cache
+//*****************************************************************************
+// Small on-disk blob cache used to persist data that is expensive to rebuild
+// at startup (program binaries, font atlases). It is disabled until a
+// directory is given, either with setDirectory() or through the
+// OGL_CACHE_DIR environment variable. Entries are plain files named after
+// a 64 bit hash of their content key; a corrupted or stale entry is simply
+// rebuilt by the caller and overwritten.
+//*****************************************************************************
+namespace ogl::cache {
+
+  //*****************************************************************************
+  // util
+  //*****************************************************************************
+  namespace util {
+
+    inline std::string & directory() {
+      static std::string dir = (getenv("OGL_CACHE_DIR") != NULL) ? getenv("OGL_CACHE_DIR") : "";
+      return dir;
+    }
+
+    //*****************************************************************************
+    // makeDirectory - mkdir -p
+    //*****************************************************************************
+    inline bool makeDirectory(const std::string & path) {
+
+      for(size_t pos = path.find('/', 1); ; pos = path.find('/', pos + 1)) {
+
+        std::string dir = path.substr(0, pos);
+
+        if(mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) return false;
+
+        if(pos == std::string::npos) return true;
+
+      }
+
+    }
+
+  } // end namespace util
+
+  //*****************************************************************************
+  // setDirectory - enable the cache in dir (an empty string disables it)
+  //*****************************************************************************
+  inline void setDirectory(std::string dir) {
+
+    if(!dir.empty()) ogl::io::expandPath(dir);
+
+    util::directory() = dir;
+
+  }
+
+  //*****************************************************************************
+  // isEnabled
+  //*****************************************************************************
+  inline bool isEnabled() { return !util::directory().empty(); }
+
+  //*****************************************************************************
+  // hash - 64 bit FNV-1a, chainable through seed
+  //*****************************************************************************
+  inline uint64_t hash(const void * data, size_t size, uint64_t seed = 14695981039346656037ULL) {
+
+    const unsigned char * bytes = (const unsigned char *) data;
+
+    for(size_t i = 0; i < size; ++i) { seed ^= bytes[i]; seed *= 1099511628211ULL; }
+
+    return seed;
+
+  }
+
+  inline uint64_t hash(const std::string & str, uint64_t seed = 14695981039346656037ULL) {
+    return hash(str.data(), str.size() + 1, seed); // hash the terminator too so "ab"+"c" != "a"+"bc"
+  }
+
+  //*****************************************************************************
+  // path - file of an entry
+  //*****************************************************************************
+  inline std::string path(const std::string & prefix, uint64_t key) {
+
+    char name[32];
+
+    snprintf(name, sizeof(name), "%016llx", (unsigned long long) key);
+
+    return util::directory() + '/' + prefix + '-' + name + ".bin";
+
+  }
+
+  //*****************************************************************************
+  // load - read an entry, false if the cache is disabled or the entry is missing
+  //*****************************************************************************
+  inline bool load(const std::string & prefix, uint64_t key, std::vector<char> & data) {
+
+    if(!isEnabled()) return false;
+
+    FILE * file = fopen(path(prefix, key).c_str(), "rb");
+
+    if(file == NULL) return false;
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    bool success = (size > 0);
+
+    if(success) {
+      data.resize(size);
+      success = (fread(data.data(), 1, size, file) == (size_t) size);
+    }
+
+    fclose(file);
+
+    return success;
+
+  }
+
+  //*****************************************************************************
+  // store - write an entry. The data goes to a temporary file renamed into
+  // place, so a concurrent reader never sees a half-written entry.
+  //*****************************************************************************
+  inline bool store(const std::string & prefix, uint64_t key, const void * data, size_t size) {
+
+    if(!isEnabled()) return false;
+
+    if(!util::makeDirectory(util::directory())) {
+      fprintf(stderr, "WARNING [cache]: cannot create directory '%s': %s\n", util::directory().c_str(), strerror(errno));
+      return false;
+    }
+
+    std::string filePath = path(prefix, key);
+    std::string tmpPath  = filePath + '.' + std::to_string(getpid());
+
+    FILE * file = fopen(tmpPath.c_str(), "wb");
+
+    if(file == NULL) return false;
+
+    bool success = (fwrite(data, 1, size, file) == size);
+
+    success = (fclose(file) == 0) && success;
+
+    if(success) success = (rename(tmpPath.c_str(), filePath.c_str()) == 0);
+
+    if(!success) remove(tmpPath.c_str());
+
+    return success;
+
+  }
+
+} /* namespace ogl::cache */
+
+#endif /* _H_OGL_CACHE_H_ */
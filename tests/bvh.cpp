@@ -0,0 +1,240 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * glBVH on the CPU only, no GL context: a glMesh of random triangles, built
+ * from a generated aiMesh, is raycast through its hierarchy and every hit
+ * (triangle, barycentrics, distance) is compared with a brute force
+ * Moller-Trumbore scan of all the triangles. Then a glBVH over the boxes of
+ * the triangles is culled against frustums and compared with
+ * glFrustum::classify() of every box.
+ *
+ *   make test
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+
+#include <random>
+#include <vector>
+
+#include <ogl/ogl.hpp>
+
+#include "check.hpp"
+
+//*****************************************************************************/
+// Hit_t - closest hit of the brute force scan
+//*****************************************************************************/
+struct Hit_t {
+  int triangle = -1;
+  float distance = FLT_MAX;
+  glm::vec3 barycentrics = glm::vec3(0.0f);
+};
+
+//*****************************************************************************/
+// intersect() - Moller-Trumbore, both faces, t in [0, tMax)
+//*****************************************************************************/
+static bool intersect(const glm::vec3 & v0, const glm::vec3 & v1, const glm::vec3 & v2,
+                      const glm::vec3 & origin, const glm::vec3 & dir, float tMax, float & t, glm::vec3 & barycentrics) {
+
+  glm::vec3 edge1 = v1 - v0;
+  glm::vec3 edge2 = v2 - v0;
+
+  glm::vec3 p = glm::cross(dir, edge2);
+
+  float det = glm::dot(edge1, p);
+
+  if(std::fabs(det) < 1e-12f) return false;
+
+  glm::vec3 s = origin - v0;
+
+  float u = glm::dot(s, p) / det;
+  if(u < 0.0f || u > 1.0f) return false;
+
+  glm::vec3 q = glm::cross(s, edge1);
+
+  float v = glm::dot(dir, q) / det;
+  if(v < 0.0f || u + v > 1.0f) return false;
+
+  t = glm::dot(edge2, q) / det;
+  if(t < 0.0f || t >= tMax) return false;
+
+  barycentrics = glm::vec3(1.0f - u - v, u, v);
+
+  return true;
+
+}
+
+//*****************************************************************************/
+// main
+//*****************************************************************************/
+int main() {
+
+  const int TRIANGLES = 20000;
+  const int RAYS      = 2000;
+
+  std::mt19937 random(1);
+  std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+
+  // --- Random triangles, up to 0.5 wide, in a 20 x 20 x 20 cube ---
+
+  std::vector<glm::vec3> positions(3 * TRIANGLES);
+
+  for(int i=0; i<TRIANGLES; ++i) {
+    glm::vec3 center(10.0f * uniform(random), 10.0f * uniform(random), 10.0f * uniform(random));
+    for(int k=0; k<3; ++k) positions[3*i+k] = center + 0.25f * glm::vec3(uniform(random), uniform(random), uniform(random));
+  }
+
+  aiMesh source;
+
+  source.mNumVertices = 3 * TRIANGLES;
+  source.mVertices    = new aiVector3D[3 * TRIANGLES];
+  source.mNumFaces    = TRIANGLES;
+  source.mFaces       = new aiFace[TRIANGLES];
+
+  for(int i=0; i<3*TRIANGLES; ++i) { source.mVertices[i].x = positions[i].x; source.mVertices[i].y = positions[i].y; source.mVertices[i].z = positions[i].z; }
+
+  for(int i=0; i<TRIANGLES; ++i) {
+    source.mFaces[i].mNumIndices = 3;
+    source.mFaces[i].mIndices = new unsigned int[3];
+    for(int k=0; k<3; ++k) source.mFaces[i].mIndices[k] = 3*i+k;
+  }
+
+  ogl::glMesh mesh(&source, 0);
+
+  mesh.buildBVH();
+
+  CHECK(mesh.getTrianglesCount() == (std::size_t) TRIANGLES);
+
+  // --- raycast() against the brute force scan ---
+
+  int hits = 0, misses = 0, mismatches = 0;
+
+  for(int r=0; r<RAYS; ++r) {
+
+    // from outside the cube toward a point inside it, a quarter of the rays
+    // pointing away
+    glm::vec3 origin = 20.0f * glm::normalize(glm::vec3(uniform(random), uniform(random), uniform(random)));
+    glm::vec3 target(8.0f * uniform(random), 8.0f * uniform(random), 8.0f * uniform(random));
+
+    glm::vec3 dir = target - origin;
+
+    if(r % 4 == 0) dir = -dir;
+
+    Hit_t expected;
+
+    for(int i=0; i<TRIANGLES; ++i) {
+      float t; glm::vec3 barycentrics;
+      if(intersect(positions[3*i], positions[3*i+1], positions[3*i+2], origin, dir, expected.distance, t, barycentrics)) {
+        expected.triangle = i; expected.distance = t; expected.barycentrics = barycentrics;
+      }
+    }
+
+    float tMax = FLT_MAX;
+    int triangle = -1;
+    glm::vec3 barycentrics(0.0f);
+
+    bool isHit = mesh.raycast(origin, dir, tMax, triangle, barycentrics);
+
+    if(isHit != (expected.triangle >= 0)) { ++mismatches; continue; }
+
+    if(!isHit) { ++misses; continue; }
+
+    ++hits;
+
+    // two triangles at the same distance may be reported either way
+    bool isSame = (triangle == expected.triangle) ? glm::length(barycentrics - expected.barycentrics) <= 1e-4f
+                                                  : std::fabs(tMax - expected.distance) <= 1e-5f * expected.distance;
+
+    if(!isSame || std::fabs(tMax - expected.distance) > 1e-5f * expected.distance) { ++mismatches; continue; }
+
+    // the hit point from the barycentrics is on the ray at that distance
+    glm::vec3 point = barycentrics.x * positions[3*triangle] + barycentrics.y * positions[3*triangle+1] + barycentrics.z * positions[3*triangle+2];
+
+    if(glm::length(point - (origin + tMax * dir)) > 1e-3f) ++mismatches;
+
+    // a limit closer than the hit hides it
+    float tShort = 0.5f * tMax;
+    int triangleShort = -1;
+    glm::vec3 barycentricsShort;
+
+    if(mesh.raycast(origin, dir, tShort, triangleShort, barycentricsShort) && triangleShort == triangle) ++mismatches;
+
+  }
+
+  printf("bvh: %d rays, %d hits, %d misses, %d mismatches\n", RAYS, hits, misses, mismatches);
+
+  CHECK(mismatches == 0);
+  CHECK(hits > RAYS / 4 && misses > 0);
+
+  // --- cull() against glFrustum::classify() of every box ---
+
+  std::vector<ogl::glAABB> boxes(TRIANGLES);
+
+  for(int i=0; i<TRIANGLES; ++i) for(int k=0; k<3; ++k) boxes[i].expand(positions[3*i+k]);
+
+  ogl::glBVH bvh;
+
+  bvh.build(boxes);
+
+  glm::vec3 eyes[] = { glm::vec3(0, 0, 30), glm::vec3(25, 5, 0), glm::vec3(0, 0, 0), glm::vec3(-3, 2, 4) };
+
+  for(const glm::vec3 & eye : eyes) {
+
+    glm::mat4 clip = glm::perspective(0.8f, 1.5f, 0.5f, 40.0f) * glm::lookAt(eye, glm::vec3(1, -1, 2), glm::vec3(0, 1, 0));
+
+    ogl::glFrustum frustum(clip);
+
+    std::vector<int> reported(TRIANGLES, 0);
+    std::vector<int> isInside(TRIANGLES, 0);
+
+    bvh.cull(frustum, [&](uint32_t i, bool inside) { ++reported[i]; isInside[i] = inside; });
+
+    int expected = 0, culled = 0, missing = 0, twice = 0, wrongInside = 0;
+
+    for(int i=0; i<TRIANGLES; ++i) {
+
+      ogl::glFrustum::CONTAINMENT containment = frustum.classify(boxes[i]);
+
+      if(containment != ogl::glFrustum::OUTSIDE) ++expected;
+      if(reported[i] > 0) ++culled;
+
+      // every box not outside is reported, once; an inside node holds only inside boxes
+      if(containment != ogl::glFrustum::OUTSIDE && reported[i] == 0) ++missing;
+      if(reported[i] > 1) ++twice;
+      if(isInside[i] && containment != ogl::glFrustum::INSIDE) ++wrongInside;
+
+    }
+
+    printf("bvh: cull from (%g, %g, %g): %d boxes not outside, %d reported\n", eye.x, eye.y, eye.z, expected, culled);
+
+    CHECK(missing == 0);
+    CHECK(twice == 0);
+    CHECK(wrongInside == 0);
+    CHECK(expected > 0);
+
+  }
+
+  if(checks::failures() == 0) printf("bvh: passed\n");
+
+  return checks::failures();
+
+}
@@ -0,0 +1,44 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _H_OGL_TESTS_CHECK_H_
+#define _H_OGL_TESTS_CHECK_H_
+
+#include <cstdio>
+
+//*****************************************************************************/
+// CHECK - report a failed condition and count it; a test program returns
+//         checks::failures() from main, so make test fails with it
+//*****************************************************************************/
+namespace checks {
+
+  inline int & failures() { static int count = 0; return count; }
+
+  inline void report(bool passed, const char * condition, const char * file, int line) {
+    if(passed) return;
+    fprintf(stderr, "FAILED %s:%d: %s\n", file, line, condition);
+    ++failures();
+  }
+
+} /* namespace checks */
+
+#define CHECK(condition) checks::report((condition), #condition, __FILE__, __LINE__)
+
+#endif /* _H_OGL_TESTS_CHECK_H_ */
@@ -0,0 +1,77 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * One object rendered into two hidden windows, alternately, for 100 frames.
+ * The windows share their buffers and programs, so the mesh is uploaded and
+ * the program compiled once for both, and each context makes its own vertex
+ * array once: nothing is uploaded again while the contexts alternate.
+ *
+ *   make test
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <ogl/ogl.hpp>
+
+#include "check.hpp"
+
+//*****************************************************************************/
+// main
+//*****************************************************************************/
+int main(int argc, char * const argv[]) {
+
+  ogl::glWindow first;
+  first.createOffscreen(320, 240);
+
+  ogl::glWindow second;
+  second.createOffscreen(320, 240);
+
+  CHECK(first.getShareGroup() == second.getShareGroup());
+
+  ogl::glSphere sphere(1.0f, 32, 32, ogl::glShader::STYLE::SOLID);
+
+  uint32_t uploaded = ogl::glGeometries::getUploadedCount();
+  uint32_t arrays   = ogl::glVertexArray::getCreatedCount();
+  uint32_t programs = ogl::glPrograms::getCompiledCount() + ogl::glPrograms::getCachedCount();
+
+  for(int frame=0; frame<100; ++frame) {
+
+    for(ogl::glWindow * window : { &first, &second }) {
+      window->renderBegin();
+      sphere.render(window->getCamera());
+      window->renderEnd();
+    }
+
+  }
+
+  // the buffers and the program once for the share group
+  CHECK(ogl::glGeometries::getUploadedCount() - uploaded == 1);
+  CHECK(ogl::glPrograms::getCompiledCount() + ogl::glPrograms::getCachedCount() - programs == 1);
+
+  // a vertex array per context
+  CHECK(ogl::glVertexArray::getCreatedCount() - arrays == 2);
+
+  if(checks::failures() == 0) printf("contexts: passed\n");
+
+  return checks::failures();
+
+}
@@ -0,0 +1,145 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * glFont on the CPU only, no GL context: decode() on valid UTF-8 and on
+ * overlong, truncated, surrogate and out of range sequences, then the open
+ * addressing glyph table through glFont::checkTable(), with enough code
+ * points to grow it and a cluster wrapped around its end.
+ *
+ *   make test
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <ogl/ogl.hpp>
+
+#include "check.hpp"
+
+//*****************************************************************************/
+// decode() - the code points of a string and the bytes each one consumed
+//*****************************************************************************/
+static std::vector<uint32_t> decode(const std::string & text, std::vector<int> * lengths = nullptr) {
+
+  std::vector<uint32_t> codes;
+
+  const char * c   = text.data();
+  const char * end = text.data() + text.size();
+
+  while(c < end) {
+    const char * start = c;
+    codes.push_back(ogl::glFont::decode(c, end));
+    if(lengths != nullptr) lengths->push_back((int) (c - start));
+  }
+
+  return codes;
+
+}
+
+//*****************************************************************************/
+// main
+//*****************************************************************************/
+int main() {
+
+  const uint32_t BAD = 0xFFFD;
+
+  // --- Valid sequences of 1 to 4 bytes ---
+
+  std::vector<int> lengths;
+
+  CHECK(decode("A\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80", &lengths) == std::vector<uint32_t>({ 0x41, 0xE9, 0x20AC, 0x1F600 }));
+  CHECK(lengths == std::vector<int>({ 1, 2, 3, 4 }));
+
+  // the bounds of each length
+  CHECK(decode("\xC2\x80")         == std::vector<uint32_t>({ 0x80 }));
+  CHECK(decode("\xDF\xBF")         == std::vector<uint32_t>({ 0x7FF }));
+  CHECK(decode("\xE0\xA0\x80")     == std::vector<uint32_t>({ 0x800 }));
+  CHECK(decode("\xEF\xBF\xBF")     == std::vector<uint32_t>({ 0xFFFF }));
+  CHECK(decode("\xF0\x90\x80\x80") == std::vector<uint32_t>({ 0x10000 }));
+  CHECK(decode("\xF4\x8F\xBF\xBF") == std::vector<uint32_t>({ 0x10FFFF }));
+
+  // --- Malformed sequences: U+FFFD, one byte at a time ---
+
+  // overlong forms of '/' and of U+07FF
+  CHECK(decode("\xC0\xAF")         == std::vector<uint32_t>({ BAD, BAD }));
+  CHECK(decode("\xE0\x80\xAF")     == std::vector<uint32_t>({ BAD, BAD, BAD }));
+  CHECK(decode("\xF0\x80\x80\xAF") == std::vector<uint32_t>({ BAD, BAD, BAD, BAD }));
+  CHECK(decode("\xE0\x9F\xBF")     == std::vector<uint32_t>({ BAD, BAD, BAD }));
+
+  // past U+10FFFF, and the leads of 5 and 6 byte forms
+  CHECK(decode("\xF4\x90\x80\x80") == std::vector<uint32_t>({ BAD, BAD, BAD, BAD }));
+  CHECK(decode("\xF8\x88\x80\x80\x80") == std::vector<uint32_t>(5, BAD));
+  CHECK(decode("\xFF") == std::vector<uint32_t>({ BAD }));
+
+  // UTF-16 surrogates
+  CHECK(decode("\xED\xA0\x80") == std::vector<uint32_t>({ BAD, BAD, BAD }));
+  CHECK(decode("\xED\xBF\xBF") == std::vector<uint32_t>({ BAD, BAD, BAD }));
+
+  // truncated at the end of the string, and interrupted by an ASCII byte
+  lengths.clear();
+  CHECK(decode("a\xE2\x82", &lengths) == std::vector<uint32_t>({ 'a', BAD, BAD }));
+  CHECK(lengths == std::vector<int>({ 1, 1, 1 }));
+  CHECK(decode("\xF0\x9F\x98") == std::vector<uint32_t>({ BAD, BAD, BAD }));
+  CHECK(decode("\xE2" "A\xC3\xA9") == std::vector<uint32_t>({ BAD, 'A', 0xE9 }));
+
+  // a lone continuation byte
+  CHECK(decode("\x80" "b") == std::vector<uint32_t>({ BAD, 'b' }));
+
+  printf("font: decode() checked\n");
+
+  // --- The glyph table: inserts, erases and lookups ---
+
+  std::mt19937 random(1);
+  std::uniform_int_distribution<uint32_t> uniform(0x80, 0x10FFFF);
+
+  for(std::size_t count : { 1, 100, 200, 3000 }) {
+
+    std::set<uint32_t> unique;
+
+    while(unique.size() < count) unique.insert(uniform(random));
+
+    std::vector<uint32_t> codes(unique.begin(), unique.end());
+
+    std::shuffle(codes.begin(), codes.end(), random);
+
+    std::size_t wrapped = 0;
+
+    int failures = ogl::glFont::checkTable(codes, 40, wrapped);
+
+    printf("font: table of %zu code points, %zu wrapped, %d failures\n", count, wrapped, failures);
+
+    CHECK(failures == 0);
+
+    CHECK(wrapped > 0);
+
+  }
+
+  if(checks::failures() == 0) printf("font: passed\n");
+
+  return checks::failures();
+
+}
@@ -0,0 +1,169 @@
+/*
+ * GNU GENERAL PUBLIC LICENSE
+ *
+ * Copyright (C) 2017-2026
+ * Created by Leonardo Parisi (leonardo.parisi[at]gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * glOcclusionBuffer on the CPU only, no GL context: a wall and a floor
+ * crossing the near plane are rasterized and boxes behind, in front of,
+ * beside and partly behind the wall are tested. Then the throughput of the
+ * rasterizer (occluder triangles per second, setup and scan) and of
+ * isVisible() (tests per second) on random scenes.
+ *
+ *   make test                 (built for SSE2 and for AVX2, the depth
+ *                              checksums of the two must match)
+ *   ogl_test_occlusion checksum   prints only the depth checksum
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <ogl/ogl.hpp>
+
+#include "check.hpp"
+
+//*****************************************************************************/
+// box() - cube of half size h centered in c
+//*****************************************************************************/
+static ogl::glAABB box(const glm::vec3 & c, float h) {
+
+  ogl::glAABB box;
+
+  box.expand(c - h);
+  box.expand(c + h);
+
+  return box;
+
+}
+
+//*****************************************************************************/
+// seconds() - elapsed since start
+//*****************************************************************************/
+static double seconds(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+//*****************************************************************************/
+// main
+//*****************************************************************************/
+int main(int argc, char * const argv[]) {
+
+  bool isChecksumOnly = (argc > 1 && strcmp(argv[1], "checksum") == 0);
+
+  glm::mat4 viewProjection = glm::perspective(0.9f, 2.0f, 0.1f, 100.0f) * glm::lookAt(glm::vec3(0, 0, 10), glm::vec3(0), glm::vec3(0, 1, 0));
+
+  ogl::glOcclusionBuffer buffer(256, 128);
+
+  // --- A 4 x 4 wall at z = 0 and a floor crossing the near plane ---
+
+  float wall[]  = { -2, -2,   0,   2, -2,   0,   2, 2,   0,   -2, 2,   0 };
+  float floor[] = { -50, -3, -50,  50, -3, -50,  50, -3, 20,  -50, -3, 20 };
+
+  GLuint indices[] = { 0, 1, 2, 0, 2, 3 };
+
+  buffer.begin(viewProjection);
+  buffer.addOccluder(glm::mat4(1.0f), wall,  3 * sizeof(float), indices, 6);
+  buffer.addOccluder(glm::mat4(1.0f), floor, 3 * sizeof(float), indices, 6);
+  buffer.rasterize();
+
+  double checksum = 0.0;
+
+  for(float depth : buffer.getDepth()) checksum += depth;
+
+  if(isChecksumOnly) { printf("%.4f\n", checksum); return 0; }
+
+  printf("occlusion: %s, %d x %d, depth checksum %.4f\n", ogl::glOcclusionBuffer::getInstructionSet(), buffer.getWidth(), buffer.getHeight(), checksum);
+
+  // the floor is clipped at the near plane: more than its two triangles
+  CHECK(buffer.getTrianglesCount() > 4);
+
+  CHECK(!buffer.isVisible(box(glm::vec3(0, 0, -5), 0.5f), viewProjection));   // behind the wall
+  CHECK( buffer.isVisible(box(glm::vec3(0, 0,  3), 0.5f), viewProjection));   // in front of it
+  CHECK( buffer.isVisible(box(glm::vec3(6, 0, -5), 0.5f), viewProjection));   // beside it
+  CHECK(!buffer.isVisible(box(glm::vec3(0, -6, -5), 0.5f), viewProjection));  // under the floor
+  CHECK( buffer.isVisible(box(glm::vec3(1.8f, 0, -1), 0.5f), viewProjection)); // partly behind the wall
+
+  // a box crossing the near plane is never culled
+  CHECK( buffer.isVisible(box(glm::vec3(0, 0, 9.95f), 0.5f), viewProjection));
+
+  // --- Rasterizer throughput: 20000 random occluder triangles ---
+
+  std::mt19937 random(1);
+  std::uniform_real_distribution<float> uniform(-8.0f, 8.0f);
+
+  const int TRIANGLES = 20000;
+  const int ROUNDS    = 20;
+
+  std::vector<float>  positions;
+  std::vector<GLuint> triangles;
+
+  for(int i=0; i<TRIANGLES; ++i) {
+
+    glm::vec3 center(uniform(random), 0.5f * uniform(random), uniform(random) - 5.0f);
+
+    for(int k=0; k<3; ++k) {
+      positions.push_back(center.x + 0.2f * uniform(random));
+      positions.push_back(center.y + 0.2f * uniform(random));
+      positions.push_back(center.z);
+      triangles.push_back((GLuint) triangles.size());
+    }
+
+  }
+
+  auto start = std::chrono::steady_clock::now();
+
+  for(int r=0; r<ROUNDS; ++r) {
+    buffer.begin(viewProjection);
+    buffer.addOccluder(glm::mat4(1.0f), positions.data(), 3 * sizeof(float), triangles.data(), triangles.size());
+    buffer.rasterize();
+  }
+
+  double rasterizeTime = seconds(start);
+
+  printf("occlusion: %8.2f Mtriangles/s\n", (double) TRIANGLES * ROUNDS / rasterizeTime * 1e-6);
+
+  // --- isVisible() throughput against that buffer ---
+
+  const int TESTS = 200000;
+
+  std::vector<ogl::glAABB> boxes(TESTS);
+
+  for(int i=0; i<TESTS; ++i) boxes[i] = box(glm::vec3(uniform(random), 0.5f * uniform(random), uniform(random)), 0.3f);
+
+  std::size_t visible = 0;
+
+  start = std::chrono::steady_clock::now();
+
+  for(int i=0; i<TESTS; ++i) visible += buffer.isVisible(boxes[i], viewProjection);
+
+  double testTime = seconds(start);
+
+  printf("occlusion: %8.2f Mtests/s (%.1f%% visible)\n", TESTS / testTime * 1e-6, 100.0 * visible / TESTS);
+
+  CHECK(visible > 0 && visible < (std::size_t) TESTS);
+
+  if(checks::failures() == 0) printf("occlusion: passed\n");
+
+  return checks::failures();
+
+}